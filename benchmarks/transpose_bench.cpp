@@ -0,0 +1,67 @@
+// Compares the blocked transpose kernels against std::memcpy (the bandwidth
+// ceiling) and the element-by-element loop they replaced.
+// build: cmake -DKRAKEN_BUILD_BENCHMARKS=ON -DCMAKE_BUILD_TYPE=Release
+
+#include "../source/library/core/dynamic_matrix.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+/// @brief best-of-`reps` wall time of `fn` in seconds
+template <class Fn> auto best_of(const int reps, Fn &&fn) -> double {
+  double best{1e30};
+  for (int i{}; i < reps; ++i) {
+    const auto start{std::chrono::steady_clock::now()};
+    fn();
+    const std::chrono::duration<double> took{std::chrono::steady_clock::now() -
+                                             start};
+    best = std::min(best, took.count());
+  }
+  return best;
+}
+
+template <class Ty> auto run(const std::size_t rows, const std::size_t cols) {
+  dynamic_matrix_<Ty> src(rows, cols);
+  dynamic_matrix_<Ty> dst(cols, rows);
+  for (std::size_t i{}; i < src.size(); ++i) {
+    src[i] = static_cast<Ty>(i);
+  }
+  // every kernel reads and writes the whole matrix once
+  const double bytes{2. * static_cast<double>(src.size() * sizeof(Ty))};
+  const auto gbs = [bytes](const double sec) { return bytes / sec / 1e9; };
+
+  const double copy{best_of(5, [&] {
+    std::memcpy(dst.data(), src.data(), src.size() * sizeof(Ty));
+  })};
+  const double naive{best_of(5, [&] {
+    for (std::size_t i{}; i < rows; ++i) {
+      for (std::size_t j{}; j < cols; ++j) {
+        dst.data()[(j * rows) + i] = src.data()[(i * cols) + j];
+      }
+    }
+  })};
+  const double blocked{best_of(5, [&] {
+    kraken::blas::transpose(rows, cols, src.data(), cols, dst.data(), rows);
+  })};
+  double in_place{};
+  if (rows == cols) {
+    in_place = best_of(5, [&] { src.transpose_squared(); });
+  }
+  std::printf("%-6s %5zu x %-5zu  memcpy %6.2f  naive %6.2f  blocked %6.2f "
+              " in-place %6.2f GB/s  (blocked = %3.0f%% of memcpy)\n",
+              sizeof(Ty) == 4 ? "float" : "double", rows, cols, gbs(copy),
+              gbs(naive), gbs(blocked), rows == cols ? gbs(in_place) : 0.,
+              100. * copy / blocked);
+}
+} // namespace
+
+auto main() -> int {
+  for (const std::size_t n : {1024UL, 2048UL, 4096UL, 8192UL}) {
+    run<float>(n, n);
+    run<double>(n, n);
+  }
+  run<float>(10000UL, 3000UL);
+  run<double>(3000UL, 10000UL);
+}
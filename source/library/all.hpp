@@ -27,9 +27,20 @@ SOFTWARE.
 #ifndef ALL_HPP
 #define ALL_HPP
 
+#include "core/banded_matrix.hpp"
+#include "core/blas.hpp"
 #include "core/constants.hpp"
+#include "core/dynamic_matrix.hpp"
+#include "core/mapped_matrix.hpp"
 #include "core/matrix.hpp"
+#include "core/matrix_batch.hpp"
+#include "core/matrix_io.hpp"
+#include "core/matrix_view.hpp"
 #include "core/numeric.hpp"
 #include "core/numeric_methods.hpp"
+#include "core/out_of_core.hpp"
+#include "core/packed_matrix.hpp"
+#include "core/sparse_matrix.hpp"
+#include "core/tiled_matrix.hpp"
 
 #endif // ALL_HPP
\ No newline at end of file
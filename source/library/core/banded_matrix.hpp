@@ -0,0 +1,289 @@
+#ifndef BANDED_MATRIX_HPP
+#define BANDED_MATRIX_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "blas.hpp" // kraken::blas::viewable
+#include "common/aligned_buffer.hpp"
+#include "common/banded.hpp"  // gbmv, gtsv, gbtrf, gbtrs
+#include "dynamic_matrix.hpp" // dynamic_matrix_<>
+#include "matrix_view.hpp"    // make_view
+#include <algorithm>          // std::copy_n, std::fill_n, std::min
+#include <cassert>            // assert
+#include <cstddef>            // std::size_t
+#include <ostream>            // std::ostream
+#include <type_traits>        // std::is_floating_point_v
+#include <utility>            // std::exchange, std::move
+#include <vector>
+
+//
+
+/// @brief an `n x n` matrix whose nonzeros lie within `lower()` diagonals
+/// below and `upper()` diagonals above the main one, stored row by row as
+/// `n` rows of `ld()` elements (see `common/banded.hpp`), memory and
+/// products cost `O(n * bandwidth)` instead of `O(n * n)`
+template <class Ty>
+requires(!std::is_class_v<Ty>) class banded_matrix_ {
+public:
+  using value_type = Ty;
+  using size_type = std::size_t;
+  using reference = value_type &;
+  using pointer = value_type *;
+  using const_pointer = const value_type *;
+
+private:
+  kraken::detail::aligned_buffer<value_type> m_data;
+  size_type m_n{};
+  size_type m_lower{};
+  size_type m_upper{};
+  size_type m_ld{1UL};
+
+public:
+  banded_matrix_() noexcept = default;
+
+  /// @brief an `n x n` band matrix, all elements are `0`
+  /// @param lower, upper number of diagonals below and above the main one
+  /// @param ld elements per stored row, at least `lower + upper + 1` (more
+  /// leaves room for fill-in, see `banded_lu_`)
+  banded_matrix_(const size_type n, const size_type lower,
+                 const size_type upper, const size_type ld = 0UL)
+      : m_data{n * std::max(ld, lower + upper + 1UL)}, m_n{n},
+        m_lower{lower}, m_upper{upper},
+        m_ld{std::max(ld, lower + upper + 1UL)} {
+    std::fill_n(m_data.data(), m_data.size(), value_type{});
+  }
+
+  /// @brief keeps the band of a square `matrix_<>`, `dynamic_matrix_<>` or
+  /// view, elements outside of it are dropped
+  template <kraken::blas::viewable M>
+  banded_matrix_(const M &dense, const size_type lower, const size_type upper)
+      : banded_matrix_(dense.row(), lower, upper) {
+    assert(dense.row() == dense.col());
+    const auto view{make_view(dense)};
+    for (size_type i{}; i < m_n; ++i) {
+      for (size_type j{first(i)}; j < last(i); ++j) {
+        at(i, j) = view.at(i, j);
+      }
+    }
+  }
+
+  banded_matrix_(const banded_matrix_ &copy)
+      : banded_matrix_(copy.m_n, copy.m_lower, copy.m_upper, copy.m_ld) {
+    std::copy_n(copy.data(), m_data.size(), m_data.data());
+  }
+
+  /// @brief move constructor, steals the buffer and leaves `move` empty
+  banded_matrix_(banded_matrix_ &&move) noexcept
+      : m_data{std::move(move.m_data)}, m_n{std::exchange(move.m_n, 0UL)},
+        m_lower{std::exchange(move.m_lower, 0UL)},
+        m_upper{std::exchange(move.m_upper, 0UL)},
+        m_ld{std::exchange(move.m_ld, 1UL)} {}
+
+  auto operator=(const banded_matrix_ &copy) -> banded_matrix_ & {
+    if (this != &copy) {
+      *this = banded_matrix_(copy);
+    }
+    return *this;
+  }
+
+  auto operator=(banded_matrix_ &&other) noexcept -> banded_matrix_ & {
+    if (this == &other) {
+      return *this;
+    }
+    m_data = std::move(other.m_data);
+    m_n = std::exchange(other.m_n, 0UL);
+    m_lower = std::exchange(other.m_lower, 0UL);
+    m_upper = std::exchange(other.m_upper, 0UL);
+    m_ld = std::exchange(other.m_ld, 1UL);
+    return *this;
+  }
+
+  ~banded_matrix_() = default;
+
+  /// @get: number of rows
+  [[nodiscard]] auto row() const noexcept -> size_type { return m_n; }
+  /// @get: number of columns
+  [[nodiscard]] auto col() const noexcept -> size_type { return m_n; }
+  /// @get: diagonals below the main one
+  [[nodiscard]] auto lower() const noexcept -> size_type { return m_lower; }
+  /// @get: diagonals above the main one
+  [[nodiscard]] auto upper() const noexcept -> size_type { return m_upper; }
+  /// @get: distance (in elements) between two stored rows
+  [[nodiscard]] auto ld() const noexcept -> size_type { return m_ld; }
+  [[nodiscard]] auto empty() const noexcept -> bool { return m_n == 0UL; }
+  [[nodiscard]] auto data() noexcept -> pointer { return m_data.data(); }
+  [[nodiscard]] auto data() const noexcept -> const_pointer {
+    return m_data.data();
+  }
+
+  /// @brief first column of the band in row `i`
+  [[nodiscard]] auto first(const size_type i) const noexcept -> size_type {
+    return i > m_lower ? i - m_lower : 0UL;
+  }
+  /// @brief one past the last column of the band in row `i`
+  [[nodiscard]] auto last(const size_type i) const noexcept -> size_type {
+    return std::min(m_n, i + m_upper + 1UL);
+  }
+  /// @brief true when `(i, j)` lies inside the band
+  [[nodiscard]] auto in_band(const size_type i,
+                             const size_type j) const noexcept -> bool {
+    return j >= first(i) && j < last(i);
+  }
+
+  /// @brief get/modify an element inside the band
+  [[nodiscard]] auto at(const size_type i, const size_type j) noexcept
+      -> reference {
+    assert(i < m_n && in_band(i, j));
+    return m_data.data()[kraken::blas::band_offset(i, j, m_lower, m_ld)];
+  }
+
+  /// @brief get any element
+  /// @return value_type, `0` outside of the band
+  [[nodiscard]] auto at(const size_type i, const size_type j) const noexcept
+      -> value_type {
+    assert(i < m_n && j < m_n);
+    return in_band(i, j)
+               ? m_data.data()[kraken::blas::band_offset(i, j, m_lower, m_ld)]
+               : value_type{};
+  }
+
+  /// @return the dense `dynamic_matrix_<>`
+  [[nodiscard]] auto to_dense() const -> dynamic_matrix_<value_type> {
+    dynamic_matrix_<value_type> temp(m_n, m_n);
+    for (size_type i{}; i < m_n; ++i) {
+      for (size_type j{first(i)}; j < last(i); ++j) {
+        temp.at(i, j) = at(i, j);
+      }
+    }
+    return temp;
+  }
+
+  /// @brief `A * x` in `O(n * bandwidth)` per column, `x` is an `n x k`
+  /// matrix or view (a vector is `n x 1`)
+  /// @return an `n x k` matrix
+  template <kraken::blas::viewable M>
+  [[nodiscard]] auto operator*(const M &x) const
+      -> dynamic_matrix_<value_type> {
+    assert(x.row() == m_n);
+    const dynamic_matrix_<value_type> rhs(make_view(x));
+    dynamic_matrix_<value_type> temp(m_n, rhs.col());
+    for (size_type j{}; j < rhs.col(); ++j) {
+      kraken::blas::gbmv(m_n, m_lower, m_upper, value_type{1}, data(), m_ld,
+                         rhs.data() + j, rhs.col(), value_type{},
+                         temp.data() + j, temp.col());
+    }
+    return temp;
+  }
+
+  [[nodiscard]] auto operator==(const banded_matrix_ &rhs) const noexcept
+      -> bool {
+    if (m_n != rhs.m_n) {
+      return false;
+    }
+    for (size_type i{}; i < m_n; ++i) {
+      for (size_type j{std::min(first(i), rhs.first(i))};
+           j < std::max(last(i), rhs.last(i)); ++j) {
+        if (at(i, j) != rhs.at(i, j)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  /// @brief prints the dense matrix
+  friend auto operator<<(std::ostream &os, const banded_matrix_ &mat)
+      -> std::ostream & {
+    for (size_type i{}; i < mat.row(); ++i) {
+      for (size_type j{}; j < mat.col(); ++j) {
+        os << mat.at(i, j) << ' ';
+      }
+      os << '\n';
+    }
+    return os;
+  }
+}; // end of class banded_matrix_
+
+/// @brief LU factorization with partial pivoting of a `banded_matrix_<>`,
+/// `O(n * lower * (lower + upper))` time and `O(n * (2 * lower + upper))`
+/// memory, factor once and `solve` as many right-hand sides as needed
+template <class Ty>
+requires(std::is_floating_point_v<Ty>) class banded_lu_ {
+public:
+  using value_type = Ty;
+  using size_type = std::size_t;
+
+private:
+  /// the row swaps spread `U` over `lower + upper` diagonals
+  banded_matrix_<value_type> m_lu;
+  std::vector<size_type> m_pivots;
+  size_type m_info{};
+
+public:
+  explicit banded_lu_(const banded_matrix_<value_type> &a)
+      : m_lu(a.row(), a.lower(), a.lower() + a.upper()),
+        m_pivots(a.row()) {
+    for (size_type i{}; i < a.row(); ++i) {
+      std::copy_n(a.data() + (i * a.ld()), a.lower() + a.upper() + 1UL,
+                  m_lu.data() + (i * m_lu.ld()));
+    }
+    m_info = kraken::blas::gbtrf(a.row(), a.lower(), a.upper(), m_lu.data(),
+                                 m_lu.ld(), m_pivots.data());
+  }
+
+  /// @get: true when a pivot is `0`, `solve` is meaningless then
+  [[nodiscard]] auto singular() const noexcept -> bool {
+    return m_info != m_lu.row();
+  }
+  /// @get: `U` above the diagonal and the multipliers of `L` below it
+  [[nodiscard]] auto factors() const noexcept
+      -> const banded_matrix_<value_type> & {
+    return m_lu;
+  }
+  /// @get: row swapped with row `i` at step `i`
+  [[nodiscard]] auto pivots() const noexcept -> const std::vector<size_type> & {
+    return m_pivots;
+  }
+
+  /// @brief solves `A * X = B`
+  /// @param b an `n x k` matrix or view, a vector is `n x 1`
+  /// @return `X`, an `n x k` matrix
+  template <kraken::blas::viewable M>
+  [[nodiscard]] auto solve(const M &b) const -> dynamic_matrix_<value_type> {
+    assert(b.row() == m_lu.row() && !singular());
+    dynamic_matrix_<value_type> temp(make_view(b));
+    const size_type lower{m_lu.lower()};
+    for (size_type j{}; j < temp.col(); ++j) {
+      kraken::blas::gbtrs(m_lu.row(), lower, m_lu.upper() - lower,
+                          m_lu.data(), m_lu.ld(), m_pivots.data(),
+                          temp.data() + j, temp.col());
+    }
+    return temp;
+  }
+}; // end of class banded_lu_
+
+#endif // BANDED_MATRIX_HPP
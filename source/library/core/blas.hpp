@@ -0,0 +1,325 @@
+#ifndef BLAS_HPP
+#define BLAS_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "common/level1.hpp"   // raw level-1 kernels
+#include "common/level2.hpp"   // raw gemv
+#include "common/qgemm.hpp"    // raw qgemm
+#include "common/reduce.hpp"   // raw reduce_rows, reduce_cols
+#include "dynamic_matrix.hpp"  // dynamic_matrix_<>
+#include "matrix_view.hpp"     // matrix_view_<>, make_view
+#include <cassert>             // assert
+#include <cstddef>             // std::size_t
+#include <cstdint>             // std::int32_t
+#include <span>                // std::span
+#include <type_traits>         // std::is_floating_point_v
+
+//
+
+/// @brief level-1 kernels on `matrix_<>`, `dynamic_matrix_<>` and views, the
+/// elements are treated as one vector. a view that is a single row, a single
+/// column or a contiguous block is handed to the kernel in one call, any other
+/// view row by row
+namespace kraken::blas {
+
+template <class T>
+concept viewable = kraken::expr::matrix_type<T> || kraken::expr::view<T>;
+
+namespace detail {
+
+/// @brief calls `fn(n, pointer, inc)` on every strided vector of `view`
+template <class View, class Fn>
+auto for_each_vector(const View &view, Fn &&fn) -> void {
+  if (view.row() == 1UL) {
+    fn(view.col(), view.data(), view.col_stride());
+  } else if (view.col() == 1UL) {
+    fn(view.row(), view.data(), view.row_stride());
+  } else if (view.col_stride() == 1UL && view.row_stride() == view.col()) {
+    fn(view.size(), view.data(), 1UL);
+  } else {
+    for (std::size_t i{}; i < view.row(); ++i) {
+      fn(view.col(), view.data() + (i * view.row_stride()), view.col_stride());
+    }
+  }
+}
+
+/// @brief true when `view` is one strided vector
+template <class View>
+[[nodiscard]] constexpr auto is_vector(const View &view) noexcept -> bool {
+  return view.row() == 1UL || view.col() == 1UL ||
+         (view.col_stride() == 1UL && view.row_stride() == view.col());
+}
+
+/// @brief the (pointer, inc) of a view for which `is_vector` holds
+template <class View>
+[[nodiscard]] constexpr auto vector_inc(const View &view) noexcept
+    -> std::size_t {
+  return view.row() == 1UL ? view.col_stride()
+         : view.col() == 1UL ? view.row_stride()
+                             : 1UL;
+}
+
+/// @brief calls `fn(n, x, incx, y, incy)` on matching vectors of `x` and `y`,
+/// two vectors of the same size pair up even if one is a row and the other a
+/// column, otherwise the shapes must match
+template <class X, class Y, class Fn>
+auto for_each_pair(const X &x, const Y &y, Fn &&fn) -> void {
+  assert(x.size() == y.size());
+  if (is_vector(x) && is_vector(y)) {
+    fn(x.size(), x.data(), vector_inc(x), y.data(), vector_inc(y));
+    return;
+  }
+  assert(x.row() == y.row() && x.col() == y.col());
+  for (std::size_t i{}; i < x.row(); ++i) {
+    fn(x.col(), x.data() + (i * x.row_stride()), x.col_stride(),
+       y.data() + (i * y.row_stride()), y.col_stride());
+  }
+}
+} // namespace detail
+
+/// @brief `y = alpha * x + y`, `y` is updated in place
+/// @param y a matrix or a (mutable) view
+template <viewable X, viewable Y>
+auto axpy(const kraken::expr::value_t<X> alpha, const X &x, Y &&y) -> void {
+  const auto vy{make_view(y)};
+  detail::for_each_pair(make_view(x), vy,
+                        [alpha](const std::size_t n, const auto *px,
+                                const std::size_t incx, auto *py,
+                                const std::size_t incy) {
+                          axpy(n, alpha, px, incx, py, incy);
+                        });
+}
+
+/// @brief `x = alpha * x` in place, unlike `matrix_::operator*` nothing but
+/// `x` is touched
+template <viewable X>
+auto scal(const kraken::expr::value_t<X> alpha, X &&x) -> void {
+  detail::for_each_vector(
+      make_view(x),
+      [alpha](const std::size_t n, auto *px, const std::size_t incx) {
+        scal(n, alpha, px, incx);
+      });
+}
+
+/// @brief `sum(x(i, j) * y(i, j))`, a row and a column of the same size can be
+/// multiplied directly
+/// @return value_type
+template <viewable X, viewable Y>
+[[nodiscard]] auto dot(const X &x, const Y &y) -> kraken::expr::value_t<X> {
+  kraken::expr::value_t<X> result{};
+  detail::for_each_pair(
+      make_view(x), make_view(y),
+      [&result](const std::size_t n, const auto *px, const std::size_t incx,
+                const auto *py, const std::size_t incy) {
+        result += dot(n, px, incx, py, incy);
+      });
+  return result;
+}
+
+/// @brief hadamard (elementwise) product `y = x o y`, `y` is updated in place
+/// @param y a matrix or a (mutable) view of the same shape (or size, for two
+/// vectors)
+template <viewable X, viewable Y> auto hadamard(const X &x, Y &&y) -> void {
+  const auto vy{make_view(y)};
+  detail::for_each_pair(make_view(x), vy,
+                        [](const std::size_t n, const auto *px,
+                           const std::size_t incx, auto *py,
+                           const std::size_t incy) {
+                          hadamard(n, px, incx, py, incy);
+                        });
+}
+
+/// @brief `sum(|x(i, j)|)`
+template <viewable X>
+[[nodiscard]] auto asum(const X &x) -> kraken::expr::value_t<X> {
+  kraken::expr::value_t<X> result{};
+  detail::for_each_vector(
+      make_view(x),
+      [&result](const std::size_t n, const auto *px, const std::size_t incx) {
+        result += asum(n, px, incx);
+      });
+  return result;
+}
+
+/// @brief euclidean (frobenius for a matrix) norm
+template <viewable X>
+requires(std::is_floating_point_v<kraken::expr::value_t<X>>) [[nodiscard]] auto
+    nrm2(const X &x) -> kraken::expr::value_t<X> {
+  const auto vx{make_view(x)};
+  if (detail::is_vector(vx)) {
+    return nrm2(vx.size(), vx.data(), detail::vector_inc(vx));
+  }
+  using value_type = kraken::expr::value_t<X>;
+  value_type ssq{};
+  detail::for_each_vector(vx, [&ssq](const std::size_t n, const auto *px,
+                                     const std::size_t incx) {
+    const value_type norm{nrm2(n, px, incx)};
+    ssq += norm * norm;
+  });
+  return std::sqrt(ssq);
+}
+
+/// @brief matrix-vector product `y = alpha * op(a) * x + beta * y`, `x` and `y`
+/// are rows or columns of the right size. a view with a unit column stride
+/// goes to the kernel as it is, one with a unit row stride (a transposed view)
+/// flips `trans` instead, any other view is copied first
+/// @param threads `0` means every hardware thread
+template <viewable A, viewable X, viewable Y>
+auto gemv(const op trans, const kraken::expr::value_t<A> alpha, const A &a,
+          const X &x, const kraken::expr::value_t<A> beta, Y &&y,
+          const std::size_t threads = 1UL) -> void {
+  const auto va{make_view(a)};
+  const auto vx{make_view(x)};
+  const auto vy{make_view(y)};
+  assert(detail::is_vector(vx) && detail::is_vector(vy));
+  assert(vx.size() == (trans == op::none ? va.col() : va.row()));
+  assert(vy.size() == (trans == op::none ? va.row() : va.col()));
+  if (va.col_stride() == 1UL || va.col() == 1UL) {
+    gemv(trans, va.row(), va.col(), alpha, va.data(), va.row_stride(),
+         vx.data(), detail::vector_inc(vx), beta, vy.data(),
+         detail::vector_inc(vy), threads);
+  } else if (va.row_stride() == 1UL || va.row() == 1UL) {
+    gemv(trans == op::none ? op::trans : op::none, va.col(), va.row(), alpha,
+         va.data(), va.col_stride(), vx.data(), detail::vector_inc(vx), beta,
+         vy.data(), detail::vector_inc(vy), threads);
+  } else {
+    const dynamic_matrix_<std::remove_const_t<kraken::expr::value_t<A>>> copy(
+        va);
+    gemv(trans, copy.row(), copy.col(), alpha, copy.data(), copy.col(),
+         vx.data(), detail::vector_inc(vx), beta, vy.data(),
+         detail::vector_inc(vy), threads);
+  }
+}
+
+/// @brief quantized product of two integer matrices (or views), `a` holds
+/// `a_scale[i] * (a(i, p) - a_zero)` and `b` `b_scale[j] * (b(p, j) -
+/// b_zero)`, the sums are taken in `int32` (see `common/qgemm.hpp`)
+/// @param a_scale one scale per row of `a`
+/// @param b_scale one scale per column of `b`
+/// @param threads `0` means every hardware thread
+/// @return the dequantized `a.row() x b.col()` product
+template <viewable A, viewable B>
+[[nodiscard]] auto qgemm(const A &a, const std::int32_t a_zero,
+                         const std::span<const float> a_scale, const B &b,
+                         const std::int32_t b_zero,
+                         const std::span<const float> b_scale,
+                         const std::size_t threads = 1UL)
+    -> dynamic_matrix_<float> {
+  using value_a = std::remove_const_t<kraken::expr::value_t<A>>;
+  using value_b = std::remove_const_t<kraken::expr::value_t<B>>;
+  const auto va{make_view(a)};
+  const auto vb{make_view(b)};
+  assert(va.col() == vb.row());
+  assert(a_scale.size() == va.row() && b_scale.size() == vb.col());
+  dynamic_matrix_<float> c(va.row(), vb.col());
+  // the kernel reads rows, any other view is copied first
+  const auto run = [&](const value_a *pa, const std::size_t lda) {
+    if (vb.col_stride() == 1UL) {
+      qgemm(va.row(), vb.col(), va.col(), pa, lda, a_zero, a_scale.data(),
+            vb.data(), vb.row_stride(), b_zero, b_scale.data(), c.data(),
+            c.col(), threads);
+      return;
+    }
+    const dynamic_matrix_<value_b> copy(vb);
+    qgemm(va.row(), vb.col(), va.col(), pa, lda, a_zero, a_scale.data(),
+          copy.data(), copy.col(), b_zero, b_scale.data(), c.data(), c.col(),
+          threads);
+  };
+  if (va.col_stride() == 1UL) {
+    run(va.data(), va.row_stride());
+  } else {
+    const dynamic_matrix_<value_a> copy(va);
+    run(copy.data(), copy.col());
+  }
+  return c;
+}
+
+/// @brief the sum, min, max or mean of every row of a matrix or view, any
+/// strides (see `common/reduce.hpp`)
+/// @param threads `0` means every hardware thread
+/// @return a `row() x 1` matrix
+template <viewable X>
+[[nodiscard]] auto reduce_rows(const reduction op, const X &x,
+                               const std::size_t threads = 1UL)
+    -> dynamic_matrix_<std::remove_const_t<kraken::expr::value_t<X>>> {
+  const auto vx{make_view(x)};
+  dynamic_matrix_<std::remove_const_t<kraken::expr::value_t<X>>> y(vx.row(),
+                                                                   1UL);
+  reduce_rows(op, vx.row(), vx.col(), vx.data(), vx.row_stride(),
+              vx.col_stride(), y.data(), 1UL, threads);
+  return y;
+}
+
+/// @brief the sum, min, max or mean of every column of a matrix or view, a
+/// row-major one is read row by row (see `common/reduce.hpp`)
+/// @param threads `0` means every hardware thread
+/// @return a `1 x col()` matrix
+template <viewable X>
+[[nodiscard]] auto reduce_cols(const reduction op, const X &x,
+                               const std::size_t threads = 1UL)
+    -> dynamic_matrix_<std::remove_const_t<kraken::expr::value_t<X>>> {
+  const auto vx{make_view(x)};
+  dynamic_matrix_<std::remove_const_t<kraken::expr::value_t<X>>> y(1UL,
+                                                                   vx.col());
+  reduce_cols(op, vx.row(), vx.col(), vx.data(), vx.row_stride(),
+              vx.col_stride(), y.data(), 1UL, threads);
+  return y;
+}
+
+/// @brief position of the first element (row by row) with the largest `|x|`
+/// @return row_col
+template <viewable X> [[nodiscard]] auto iamax(const X &x) -> row_col {
+  const auto vx{make_view(x)};
+  if (vx.empty()) {
+    return {};
+  }
+  if (detail::is_vector(vx)) {
+    const auto index{iamax(vx.size(), vx.data(), detail::vector_inc(vx))};
+    if (vx.row() == 1UL) {
+      return {0UL, index};
+    }
+    if (vx.col() == 1UL) {
+      return {index, 0UL};
+    }
+    return {index / vx.col(), index % vx.col()};
+  }
+  row_col best{};
+  auto largest{detail::magnitude(vx.at(0UL, 0UL))};
+  for (std::size_t i{}; i < vx.row(); ++i) {
+    const auto j{iamax(vx.col(), vx.data() + (i * vx.row_stride()),
+                       vx.col_stride())};
+    if (detail::magnitude(vx.at(i, j)) > largest) {
+      largest = detail::magnitude(vx.at(i, j));
+      best = {i, j};
+    }
+  }
+  return best;
+}
+} // namespace kraken::blas
+
+#endif // BLAS_HPP
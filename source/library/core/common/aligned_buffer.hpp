@@ -0,0 +1,92 @@
+#ifndef ALIGNED_BUFFER_HPP
+#define ALIGNED_BUFFER_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <cstddef> // std::size_t
+#include <new>     // std::align_val_t
+#include <utility> // std::exchange
+
+namespace kraken::detail {
+
+/// @brief alignment used by every heap buffer in the library (one cache-line)
+inline constexpr std::size_t cache_line{64UL};
+
+/// @brief allocates room for `count` elements aligned to a cache-line
+/// @return nullptr if `count` is `0`
+template <class Ty>
+[[nodiscard]] auto aligned_allocate(const std::size_t count) -> Ty * {
+  if (count == 0UL) {
+    return nullptr;
+  }
+  return static_cast<Ty *>(
+      ::operator new(count * sizeof(Ty), std::align_val_t{cache_line}));
+}
+
+/// @brief releases a buffer returned by `aligned_allocate`
+template <class Ty> auto aligned_deallocate(Ty *ptr) noexcept -> void {
+  if (ptr != nullptr) {
+    ::operator delete(ptr, std::align_val_t{cache_line});
+  }
+}
+
+/// @brief owning, move-only, uninitialized scratch buffer used by kernels
+template <class Ty> class aligned_buffer {
+private:
+  Ty *m_data{nullptr};
+  std::size_t m_size{};
+
+public:
+  aligned_buffer() noexcept = default;
+  explicit aligned_buffer(const std::size_t count)
+      : m_data{aligned_allocate<Ty>(count)}, m_size{count} {}
+
+  aligned_buffer(const aligned_buffer &) = delete;
+  auto operator=(const aligned_buffer &) -> aligned_buffer & = delete;
+
+  aligned_buffer(aligned_buffer &&move) noexcept
+      : m_data{std::exchange(move.m_data, nullptr)},
+        m_size{std::exchange(move.m_size, 0UL)} {}
+
+  auto operator=(aligned_buffer &&other) noexcept -> aligned_buffer & {
+    if (this != &other) {
+      aligned_deallocate(m_data);
+      m_data = std::exchange(other.m_data, nullptr);
+      m_size = std::exchange(other.m_size, 0UL);
+    }
+    return *this;
+  }
+
+  ~aligned_buffer() { aligned_deallocate(m_data); }
+
+  [[nodiscard]] auto data() noexcept -> Ty * { return m_data; }
+  [[nodiscard]] auto data() const noexcept -> const Ty * { return m_data; }
+  [[nodiscard]] auto size() const noexcept -> std::size_t { return m_size; }
+};
+} // namespace kraken::detail
+
+#endif // ALIGNED_BUFFER_HPP
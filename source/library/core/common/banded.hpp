@@ -0,0 +1,166 @@
+#ifndef BANDED_HPP
+#define BANDED_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "level1.hpp" // dot, axpy, scal
+#include <algorithm>   // std::min, std::swap_ranges
+#include <cstddef>     // std::size_t
+#include <utility>     // std::swap
+
+/// @brief kernels on row-major band storage: an `n x n` matrix with `kl`
+/// diagonals below and `ku` above the main one keeps row `i` in
+/// `ab[i * ldab .. i * ldab + kl + ku]` and `a(i, j)` is
+/// `ab[i * ldab + j - i + kl]`, so every row of the band is contiguous and
+/// pairs with a contiguous slice of the vector it multiplies
+namespace kraken::blas {
+
+/// @brief position of `a(i, j)` in the band, `j + kl >= i`
+[[nodiscard]] constexpr auto band_offset(const std::size_t i,
+                                         const std::size_t j,
+                                         const std::size_t kl,
+                                         const std::size_t ldab) noexcept
+    -> std::size_t {
+  return (i * ldab) + (j + kl - i);
+}
+
+/// @brief `y = alpha * A * x + beta * y` with `A` banded, one `dot` per row
+template <class Ty>
+auto gbmv(const std::size_t n, const std::size_t kl, const std::size_t ku,
+          const Ty alpha, const Ty *ab, const std::size_t ldab, const Ty *x,
+          const std::size_t incx, const Ty beta, Ty *y,
+          const std::size_t incy) noexcept -> void {
+  for (std::size_t i{}; i < n; ++i) {
+    const std::size_t first{i > kl ? i - kl : 0UL};
+    const std::size_t last{std::min(n, i + ku + 1UL)};
+    const Ty sum{dot(last - first, ab + band_offset(i, first, kl, ldab), 1UL,
+                     x + (first * incx), incx)};
+    // `beta == 0` overwrites `y`, even a `nan` in it
+    y[i * incy] = beta == Ty{} ? static_cast<Ty>(alpha * sum)
+                               : static_cast<Ty>((alpha * sum) +
+                                                 (beta * y[i * incy]));
+  }
+}
+
+/// @brief Thomas algorithm: solves the tridiagonal `A * x = b` in place
+/// (`b` becomes `x`) in `O(n)`, without pivoting, so `A` should be
+/// diagonally dominant (or symmetric positive definite)
+/// @param dl `a(i + 1, i)`, `d` `a(i, i)`, `du` `a(i, i + 1)`, each `inc`
+/// apart
+/// @param work `n` elements of scratch
+template <class Ty>
+auto gtsv(const std::size_t n, const Ty *dl, const Ty *d, const Ty *du,
+          const std::size_t inc, Ty *b, const std::size_t incb,
+          Ty *work) noexcept -> void {
+  if (n == 0UL) {
+    return;
+  }
+  // forward sweep, `work[i]` is the eliminated `a(i, i + 1) / pivot`
+  Ty pivot{d[0]};
+  b[0] = static_cast<Ty>(b[0] / pivot);
+  for (std::size_t i{1}; i < n; ++i) {
+    work[i - 1] = static_cast<Ty>(du[(i - 1) * inc] / pivot);
+    pivot = static_cast<Ty>(d[i * inc] - (dl[(i - 1) * inc] * work[i - 1]));
+    b[i * incb] = static_cast<Ty>(
+        (b[i * incb] - (dl[(i - 1) * inc] * b[(i - 1) * incb])) / pivot);
+  }
+  for (std::size_t i{n - 1}; i-- > 0UL;) {
+    b[i * incb] = static_cast<Ty>(b[i * incb] - (work[i] * b[(i + 1) * incb]));
+  }
+}
+
+/// @brief LU factorization with partial pivoting of a band matrix, in place
+/// the band must hold `kl` extra diagonals above `ku` for the fill-in of the
+/// row swaps, `ldab >= 2 * kl + ku + 1` with `a(i, j)` at
+/// `band_offset(i, j, kl, ldab)`. `U` overwrites the upper part (`kl + ku`
+/// diagonals), the multipliers of `L` the lower part, `ipiv[i]` is the row
+/// swapped with row `i` at step `i`
+/// @return `n` on success, otherwise the first `i` with `u(i, i) == 0`
+template <class Ty>
+auto gbtrf(const std::size_t n, const std::size_t kl, const std::size_t ku,
+           Ty *ab, const std::size_t ldab, std::size_t *ipiv) noexcept
+    -> std::size_t {
+  const std::size_t ku2{kl + ku};
+  const auto at = [ab, kl, ldab](const std::size_t i, const std::size_t j) {
+    return ab + band_offset(i, j, kl, ldab);
+  };
+  std::size_t info{n};
+  for (std::size_t i{}; i < n; ++i) {
+    const std::size_t rows{std::min(n, i + kl + 1UL)};
+    const std::size_t cols{std::min(n, i + ku2 + 1UL)};
+    std::size_t p{i};
+    for (std::size_t r{i + 1}; r < rows; ++r) {
+      p = detail::magnitude(*at(r, i)) > detail::magnitude(*at(p, i)) ? r : p;
+    }
+    ipiv[i] = p;
+    if (*at(p, i) == Ty{}) {
+      info = info == n ? i : info;
+      continue;
+    }
+    // both rows are already `0` left of column `i`
+    if (p != i) {
+      std::swap_ranges(at(i, i), at(i, i) + (cols - i), at(p, i));
+    }
+    for (std::size_t r{i + 1}; r < rows; ++r) {
+      Ty *const l{at(r, i)};
+      *l = static_cast<Ty>(*l / *at(i, i));
+      axpy(cols - i - 1UL, static_cast<Ty>(-*l), at(i, i + 1), 1UL,
+           at(r, i + 1), 1UL);
+    }
+  }
+  return info;
+}
+
+/// @brief solves `A * x = b` in place with the factors of `gbtrf`
+template <class Ty>
+auto gbtrs(const std::size_t n, const std::size_t kl, const std::size_t ku,
+           const Ty *ab, const std::size_t ldab, const std::size_t *ipiv,
+           Ty *b, const std::size_t incb) noexcept -> void {
+  const std::size_t ku2{kl + ku};
+  // `L`: the swaps and eliminations in the order `gbtrf` made them
+  for (std::size_t i{}; i < n; ++i) {
+    if (ipiv[i] != i) {
+      std::swap(b[i * incb], b[ipiv[i] * incb]);
+    }
+    const std::size_t rows{std::min(n, i + kl + 1UL)};
+    for (std::size_t r{i + 1}; r < rows; ++r) {
+      b[r * incb] = static_cast<Ty>(
+          b[r * incb] - (ab[band_offset(r, i, kl, ldab)] * b[i * incb]));
+    }
+  }
+  // `U`: backward substitution, row `i` is contiguous
+  for (std::size_t i{n}; i-- > 0UL;) {
+    const std::size_t cols{std::min(n, i + ku2 + 1UL)};
+    const Ty *const row{ab + band_offset(i, i, kl, ldab)};
+    const Ty rest{dot(cols - i - 1UL, row + 1, 1UL, b + ((i + 1UL) * incb),
+                      incb)};
+    b[i * incb] = static_cast<Ty>((b[i * incb] - rest) / row[0]);
+  }
+}
+} // namespace kraken::blas
+
+#endif // BANDED_HPP
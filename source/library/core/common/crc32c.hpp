@@ -0,0 +1,88 @@
+#ifndef CRC32C_HPP
+#define CRC32C_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <array>   // std::array
+#include <cstddef> // std::size_t, std::byte
+#include <cstdint> // std::uint32_t, std::uint64_t
+#include <cstring> // std::memcpy
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h> // _mm_crc32_u64, _mm_crc32_u8
+#endif
+
+namespace kraken::detail {
+
+/// @brief byte-at-a-time table of the reflected Castagnoli polynomial
+[[nodiscard]] constexpr auto crc32c_table() noexcept
+    -> std::array<std::uint32_t, 256> {
+  std::array<std::uint32_t, 256> table{};
+  for (std::uint32_t i{}; i < 256U; ++i) {
+    std::uint32_t crc{i};
+    for (int bit{}; bit < 8; ++bit) {
+      crc = (crc >> 1U) ^ ((crc & 1U) != 0U ? 0x82F63B78U : 0U);
+    }
+    table[i] = crc;
+  }
+  return table;
+}
+
+inline constexpr std::array<std::uint32_t, 256> crc32c_lut{crc32c_table()};
+} // namespace kraken::detail
+
+namespace kraken::io {
+
+/// @brief CRC-32C (Castagnoli) of `bytes` bytes, continuing from `crc` so a
+/// stream can be checksummed piece by piece: `crc32c(crc32c(0, a), b)` is the
+/// checksum of `a` followed by `b`. eight bytes per `crc32` instruction on
+/// SSE 4.2, a table lookup per byte otherwise
+[[nodiscard]] inline auto crc32c(std::uint32_t crc, const void *data,
+                                 std::size_t bytes) noexcept -> std::uint32_t {
+  const auto *p{static_cast<const unsigned char *>(data)};
+  crc = ~crc;
+#if defined(__SSE4_2__)
+  std::uint64_t wide{crc};
+  for (; bytes >= 8UL; bytes -= 8UL, p += 8) {
+    std::uint64_t word{};
+    std::memcpy(&word, p, sizeof(word));
+    wide = _mm_crc32_u64(wide, word);
+  }
+  crc = static_cast<std::uint32_t>(wide);
+  for (; bytes > 0UL; --bytes, ++p) {
+    crc = _mm_crc32_u8(crc, *p);
+  }
+#else
+  for (; bytes > 0UL; --bytes, ++p) {
+    crc = kraken::detail::crc32c_lut[(crc ^ *p) & 0xFFU] ^ (crc >> 8U);
+  }
+#endif
+  return ~crc;
+}
+} // namespace kraken::io
+
+#endif // CRC32C_HPP
@@ -0,0 +1,418 @@
+#ifndef EXPRESSION_HPP
+#define EXPRESSION_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <cassert>     // assert
+#include <concepts>    // std::same_as
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uintptr_t
+#include <functional>  // std::plus, std::minus, std::multiplies
+#include <type_traits> // std::conditional_t, std::remove_cvref_t
+#include <utility>     // std::pair, std::forward
+
+/// @brief lazy element-wise arithmetic on matrices: `a + b - c + 2` builds a
+/// small tree of nodes and nothing is computed until the tree is assigned to a
+/// matrix, which then runs a single pass over the elements
+namespace kraken::expr {
+
+/// @brief marks a concrete matrix type (specialized next to each matrix)
+template <class T> struct is_matrix : std::false_type {};
+
+/// @brief marks a node of an expression tree
+template <class T> struct is_node : std::false_type {};
+
+/// @brief marks a non-owning view over the elements of a matrix
+template <class T> struct is_view : std::false_type {};
+
+/// @brief the `row` and `col` of an operand whose shape is part of its type
+/// (specialized next to each such matrix, and for the nodes over them)
+template <class T> struct fixed_shape : std::false_type {};
+
+template <class T>
+concept matrix_type = is_matrix<std::remove_cvref_t<T>>::value;
+template <class T>
+concept node = is_node<std::remove_cvref_t<T>>::value;
+template <class T>
+concept view = is_view<std::remove_cvref_t<T>>::value;
+/// @brief anything a matrix can be built from without being a matrix
+template <class T>
+concept evaluable = node<T> || view<T>;
+template <class T>
+concept operand = matrix_type<T> || node<T> || view<T>;
+
+/// @brief how a node holds an operand deduced as `T` by the operators below:
+/// nodes and views (which are tiny) by value, a named matrix by reference and
+/// a temporary matrix by value, moved in. `auto e = make_matrix() + b;` so
+/// owns the result of `make_matrix()`, while `b` must outlive `e`
+template <class T>
+using stored_t =
+    std::conditional_t<evaluable<T> || !std::is_reference_v<T>,
+                       std::remove_cvref_t<T>, const std::remove_cvref_t<T> &>;
+
+/// @brief the matrix type an operand materializes into
+template <class T> struct result_of {
+  using type = std::remove_cvref_t<T>;
+};
+template <evaluable T> struct result_of<T> {
+  using type = typename std::remove_cvref_t<T>::result_type;
+};
+template <class T> using result_t = typename result_of<T>::type;
+
+template <class T>
+using value_t = typename std::remove_cvref_t<T>::value_type;
+
+template <class T> using shape_of = fixed_shape<std::remove_cvref_t<T>>;
+
+/// @brief operands an element-wise node combines: the same element type and,
+/// when both shapes are known at compile time, the same shape. the shapes of
+/// run-time sized operands are asserted when the node is built
+template <class L, class R>
+concept compatible =
+    std::same_as<value_t<L>, value_t<R>> &&
+    (!shape_of<L>::value || !shape_of<R>::value ||
+     (shape_of<L>::row == shape_of<R>::row &&
+      shape_of<L>::col == shape_of<R>::col));
+
+/// @brief the distance in elements between two rows and between two columns
+/// of an operand that stores its elements, packed rows when it does not say
+template <class T>
+[[nodiscard]] constexpr auto row_stride_of(const T &x) noexcept
+    -> std::size_t {
+  if constexpr (requires { x.row_stride(); }) {
+    return x.row_stride();
+  } else {
+    return x.col();
+  }
+}
+template <class T>
+[[nodiscard]] constexpr auto col_stride_of(const T &x) noexcept
+    -> std::size_t {
+  if constexpr (requires { x.col_stride(); }) {
+    return x.col_stride();
+  } else {
+    return 1UL;
+  }
+}
+
+/// @brief true when writing `dst` element by element may change an element
+/// of `expr` before it is read: `expr` (or a node below it) is a matrix or a
+/// view whose elements share memory with `dst` in another arrangement, like
+/// `a = transposed_view(a)`. reading each element where it is written
+/// (`a = a + b`, `a += a`) is not aliasing. the check is by address range,
+/// so it may see aliasing where the order of the writes would not matter
+template <class Dst, class E>
+[[nodiscard]] constexpr auto aliases(const Dst &dst, const E &expr) noexcept
+    -> bool {
+  if constexpr (requires { expr.aliases(dst); }) {
+    return expr.aliases(dst);
+  } else if constexpr (requires {
+                         dst.data();
+                         expr.data();
+                       }) {
+    if (dst.size() == 0UL || expr.size() == 0UL) {
+      return false;
+    }
+    const void *const first{dst.data()};
+    const std::size_t rs{row_stride_of(dst)};
+    const std::size_t cs{col_stride_of(dst)};
+    if (first == static_cast<const void *>(expr.data()) &&
+        rs == row_stride_of(expr) && cs == col_stride_of(expr)) {
+      return false;
+    }
+    if (std::is_constant_evaluated()) {
+      // addresses of distinct objects cannot be ordered here, only the same
+      // first element in another arrangement is caught
+      return first == static_cast<const void *>(expr.data());
+    }
+    // the bytes from the first to past the last element of each
+    const auto span = [](const auto &x, const std::size_t r,
+                         const std::size_t c) {
+      const auto begin{reinterpret_cast<std::uintptr_t>(x.data())};
+      return std::pair{begin, begin + ((((x.row() - 1UL) * r) +
+                                        ((x.col() - 1UL) * c) + 1UL) *
+                                       sizeof(value_t<decltype(x)>))};
+    };
+    const auto [d0, d1] = span(dst, rs, cs);
+    const auto [e0, e1] =
+        span(expr, row_stride_of(expr), col_stride_of(expr));
+    return d0 < e1 && e0 < d1;
+  } else {
+    return false;
+  }
+}
+
+/// @brief `scalar - element`
+struct reverse_minus {
+  template <class Ty>
+  constexpr auto operator()(const Ty &elem, const Ty &scalar) const noexcept {
+    return scalar - elem;
+  }
+};
+
+/// @brief element-wise `op(lhs(i, j), rhs(i, j))`
+template <class Op, class L, class R> class binary {
+  static_assert(compatible<L, R>,
+                "- the operands differ in element type or in shape");
+
+private:
+  stored_t<L> m_lhs;
+  stored_t<R> m_rhs;
+
+public:
+  using value_type = value_t<L>;
+  using result_type = result_t<L>;
+  using size_type = std::size_t;
+
+  template <class A, class B>
+  constexpr binary(A &&lhs, B &&rhs) noexcept
+      : m_lhs{std::forward<A>(lhs)}, m_rhs{std::forward<B>(rhs)} {
+    if constexpr (!shape_of<L>::value || !shape_of<R>::value) {
+      assert(m_lhs.row() == m_rhs.row() && m_lhs.col() == m_rhs.col());
+    }
+  }
+
+  [[nodiscard]] constexpr auto row() const noexcept -> size_type {
+    return m_lhs.row();
+  }
+  [[nodiscard]] constexpr auto col() const noexcept -> size_type {
+    return m_lhs.col();
+  }
+  [[nodiscard]] constexpr auto size() const noexcept -> size_type {
+    return row() * col();
+  }
+  [[nodiscard]] constexpr auto at(const size_type row,
+                                  const size_type col) const -> value_type {
+    return static_cast<value_type>(
+        Op{}(m_lhs.at(row, col), m_rhs.at(row, col)));
+  }
+
+  template <class Dst>
+  [[nodiscard]] constexpr auto aliases(const Dst &dst) const noexcept -> bool {
+    return expr::aliases(dst, m_lhs) || expr::aliases(dst, m_rhs);
+  }
+};
+
+/// @brief element-wise `op(operand(i, j), scalar)`
+template <class Op, class E> class scalar {
+private:
+  stored_t<E> m_expr;
+  value_t<E> m_scalar;
+
+public:
+  using value_type = value_t<E>;
+  using result_type = result_t<E>;
+  using size_type = std::size_t;
+
+  template <class A>
+  constexpr scalar(A &&expr, const value_type value) noexcept
+      : m_expr{std::forward<A>(expr)}, m_scalar{value} {}
+
+  [[nodiscard]] constexpr auto row() const noexcept -> size_type {
+    return m_expr.row();
+  }
+  [[nodiscard]] constexpr auto col() const noexcept -> size_type {
+    return m_expr.col();
+  }
+  [[nodiscard]] constexpr auto size() const noexcept -> size_type {
+    return row() * col();
+  }
+  [[nodiscard]] constexpr auto at(const size_type row,
+                                  const size_type col) const -> value_type {
+    return static_cast<value_type>(Op{}(m_expr.at(row, col), m_scalar));
+  }
+
+  template <class Dst>
+  [[nodiscard]] constexpr auto aliases(const Dst &dst) const noexcept -> bool {
+    return expr::aliases(dst, m_expr);
+  }
+};
+
+template <class Op, class L, class R>
+struct is_node<binary<Op, L, R>> : std::true_type {};
+template <class Op, class E>
+struct is_node<scalar<Op, E>> : std::true_type {};
+template <class Op, class L, class R>
+struct fixed_shape<binary<Op, L, R>>
+    : std::conditional_t<shape_of<L>::value, shape_of<L>, shape_of<R>> {};
+template <class Op, class E>
+struct fixed_shape<scalar<Op, E>> : shape_of<E> {};
+
+/// @brief true when `dst` is stored column by column (a column-major
+/// `matrix_<>`, a transposed view), the walks below then go down the columns
+template <class Dst>
+[[nodiscard]] constexpr auto column_first(const Dst &dst) noexcept -> bool {
+  if constexpr (requires { dst.col_stride(); }) {
+    return dst.row_stride() < dst.col_stride();
+  } else {
+    return false;
+  }
+}
+
+/// @brief writes every element of `expr` into `dst` in one pass, in the
+/// order `dst` is stored so the inner loop is contiguous and vectorizable.
+/// when `expr` reads `dst` in another arrangement it is evaluated into a
+/// temporary first
+template <class Dst, class E>
+constexpr auto assign(Dst &dst, const E &expr) -> void {
+  assert(dst.row() == expr.row() && dst.col() == expr.col());
+  if (aliases(dst, expr)) {
+    const result_t<E> temp(expr);
+    assign(dst, temp);
+    return;
+  }
+  if (column_first(dst)) {
+    for (std::size_t j{}; j < expr.col(); ++j) {
+      for (std::size_t i{}; i < expr.row(); ++i) {
+        dst.at(i, j) = expr.at(i, j);
+      }
+    }
+    return;
+  }
+  for (std::size_t i{}; i < expr.row(); ++i) {
+    for (std::size_t j{}; j < expr.col(); ++j) {
+      dst.at(i, j) = expr.at(i, j);
+    }
+  }
+}
+
+/// @brief `dst = op(dst, expr)` in one pass, through a temporary like
+/// `assign` when `expr` reads `dst` in another arrangement
+template <class Op, class Dst, class E>
+constexpr auto compound_assign(Dst &dst, const E &expr) -> void {
+  assert(dst.row() == expr.row() && dst.col() == expr.col());
+  if (aliases(dst, expr)) {
+    const result_t<E> temp(expr);
+    compound_assign<Op>(dst, temp);
+    return;
+  }
+  const auto apply = [&](const std::size_t i, const std::size_t j) {
+    dst.at(i, j) =
+        static_cast<value_t<Dst>>(Op{}(dst.at(i, j), expr.at(i, j)));
+  };
+  if (column_first(dst)) {
+    for (std::size_t j{}; j < expr.col(); ++j) {
+      for (std::size_t i{}; i < expr.row(); ++i) {
+        apply(i, j);
+      }
+    }
+    return;
+  }
+  for (std::size_t i{}; i < expr.row(); ++i) {
+    for (std::size_t j{}; j < expr.col(); ++j) {
+      apply(i, j);
+    }
+  }
+}
+
+/// @brief evaluates an operand into its matrix type
+template <operand E>
+[[nodiscard]] constexpr auto eval(const E &expr) -> result_t<E> {
+  return result_t<E>(expr);
+}
+} // namespace kraken::expr
+
+/// @operators: build expression nodes, nothing is computed here. operands
+/// are forwarded so that a temporary matrix is moved into the node (see
+/// `stored_t`)
+
+template <kraken::expr::operand L, kraken::expr::operand R>
+requires kraken::expr::compatible<L, R>
+[[nodiscard]] constexpr auto operator+(L &&lhs, R &&rhs) noexcept {
+  return kraken::expr::binary<std::plus<>, L, R>{std::forward<L>(lhs),
+                                                 std::forward<R>(rhs)};
+}
+
+template <kraken::expr::operand L, kraken::expr::operand R>
+requires kraken::expr::compatible<L, R>
+[[nodiscard]] constexpr auto operator-(L &&lhs, R &&rhs) noexcept {
+  return kraken::expr::binary<std::minus<>, L, R>{std::forward<L>(lhs),
+                                                  std::forward<R>(rhs)};
+}
+
+template <kraken::expr::operand E>
+[[nodiscard]] constexpr auto operator+(E &&expr,
+                                       const kraken::expr::value_t<E> value) noexcept {
+  return kraken::expr::scalar<std::plus<>, E>{std::forward<E>(expr), value};
+}
+
+template <kraken::expr::operand E>
+[[nodiscard]] constexpr auto operator+(const kraken::expr::value_t<E> value,
+                                       E &&expr) noexcept {
+  return kraken::expr::scalar<std::plus<>, E>{std::forward<E>(expr), value};
+}
+
+template <kraken::expr::operand E>
+[[nodiscard]] constexpr auto operator-(E &&expr,
+                                       const kraken::expr::value_t<E> value) noexcept {
+  return kraken::expr::scalar<std::minus<>, E>{std::forward<E>(expr), value};
+}
+
+template <kraken::expr::operand E>
+[[nodiscard]] constexpr auto operator-(const kraken::expr::value_t<E> value,
+                                       E &&expr) noexcept {
+  return kraken::expr::scalar<kraken::expr::reverse_minus, E>{
+      std::forward<E>(expr), value};
+}
+
+template <kraken::expr::operand E>
+[[nodiscard]] constexpr auto operator-(E &&expr) noexcept {
+  return kraken::expr::scalar<std::multiplies<>, E>{
+      std::forward<E>(expr), static_cast<kraken::expr::value_t<E>>(-1)};
+}
+
+/// @brief scaling a node stays lazy, scaling a matrix from the left too
+template <kraken::expr::node E>
+[[nodiscard]] constexpr auto operator*(const E &expr,
+                                       const kraken::expr::value_t<E> value) noexcept {
+  return kraken::expr::scalar<std::multiplies<>, E>{expr, value};
+}
+
+template <kraken::expr::operand E>
+[[nodiscard]] constexpr auto operator*(const kraken::expr::value_t<E> value,
+                                       E &&expr) noexcept {
+  return kraken::expr::scalar<std::multiplies<>, E>{std::forward<E>(expr),
+                                                    value};
+}
+
+/// @brief a product is where a node gets materialized
+template <kraken::expr::node L, kraken::expr::operand R>
+[[nodiscard]] constexpr auto operator*(const L &lhs, const R &rhs) {
+  if constexpr (kraken::expr::node<R>) {
+    return kraken::expr::eval(lhs) * kraken::expr::eval(rhs);
+  } else {
+    return kraken::expr::eval(lhs) * rhs;
+  }
+}
+
+template <kraken::expr::operand L, kraken::expr::node R>
+requires(!kraken::expr::node<L>)
+[[nodiscard]] constexpr auto operator*(const L &lhs, const R &rhs) {
+  return lhs * kraken::expr::eval(rhs);
+}
+
+#endif // EXPRESSION_HPP
@@ -0,0 +1,296 @@
+#ifndef GEMM_HPP
+#define GEMM_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "aligned_buffer.hpp"
+#include "thread_pool.hpp"
+#include <algorithm> // std::min, std::max
+#include <cstddef>   // std::size_t
+#include <cstring>   // std::memcpy
+#include <utility>   // std::pair
+
+/// @brief dense linear-algebra kernels working on raw, strided buffers
+namespace kraken::blas {
+
+/// @brief width (in bytes) of the widest vector register the target has
+#if defined(__AVX512F__)
+inline constexpr std::size_t simd_bytes{64UL};
+#elif defined(__AVX__)
+inline constexpr std::size_t simd_bytes{32UL};
+#else
+inline constexpr std::size_t simd_bytes{16UL};
+#endif
+
+/// @brief block sizes of the packed gemm
+/// `MR x NR` is the register tile of the micro-kernel, `MC x KC` is the packed
+/// block of `A` (sized for L2) and `KC x NC` the packed panel of `B` (sized
+/// for L3)
+template <class Ty> struct gemm_blocking {
+  /// elements of `Ty` in one vector register
+  static constexpr std::size_t lanes{
+      simd_bytes >= sizeof(Ty) ? simd_bytes / sizeof(Ty) : 1UL};
+  static constexpr std::size_t MR{6UL};
+  static constexpr std::size_t NR{2UL * lanes};
+  static constexpr std::size_t MC{MR * 24UL};
+  static constexpr std::size_t KC{256UL};
+  static constexpr std::size_t NC{NR * 128UL};
+  /// products smaller than this (m * n * k) skip packing
+  static constexpr std::size_t small{16UL * 16UL * 16UL};
+};
+
+namespace detail {
+
+/// @brief packs a `mc x kc` block of `A` into row-panels of height `MR`,
+/// each panel is stored column by column, short panels are padded with `0`
+template <class Ty>
+auto pack_a(const std::size_t mc, const std::size_t kc, const Ty *a,
+            const std::size_t rsa, const std::size_t csa, Ty *packed)
+    -> void {
+  constexpr std::size_t MR{gemm_blocking<Ty>::MR};
+  for (std::size_t ir{}; ir < mc; ir += MR) {
+    const std::size_t mr{std::min(MR, mc - ir)};
+    for (std::size_t p{}; p < kc; ++p) {
+      for (std::size_t i{}; i < MR; ++i) {
+        *packed++ = i < mr ? a[((ir + i) * rsa) + (p * csa)] : Ty{};
+      }
+    }
+  }
+}
+
+/// @brief packs a `kc x nc` panel of `B` into column-panels of width `NR`,
+/// each panel is stored row by row, short panels are padded with `0`
+template <class Ty>
+auto pack_b(const std::size_t kc, const std::size_t nc, const Ty *b,
+            const std::size_t rsb, const std::size_t csb, Ty *packed)
+    -> void {
+  constexpr std::size_t NR{gemm_blocking<Ty>::NR};
+  for (std::size_t jr{}; jr < nc; jr += NR) {
+    const std::size_t nr{std::min(NR, nc - jr)};
+    for (std::size_t p{}; p < kc; ++p) {
+      for (std::size_t j{}; j < NR; ++j) {
+        *packed++ = j < nr ? b[(p * rsb) + ((jr + j) * csb)] : Ty{};
+      }
+    }
+  }
+}
+
+/// @brief register-tiled micro-kernel: `C(mr x nr) += alpha * A_panel *
+/// B_panel`, the full `MR x NR` tile is accumulated in registers and only the
+/// valid `mr x nr` corner is written back
+template <class Ty>
+auto micro_kernel(const std::size_t kc, const Ty alpha,
+                  const Ty *__restrict a, const Ty *__restrict b,
+                  Ty *__restrict c, const std::size_t rsc,
+                  const std::size_t csc, const std::size_t mr,
+                  const std::size_t nr) -> void {
+  constexpr std::size_t MR{gemm_blocking<Ty>::MR};
+  constexpr std::size_t NR{gemm_blocking<Ty>::NR};
+#if defined(__GNUC__)
+  // two vector registers per row of the tile: `MR * 2` accumulators
+  using vec [[gnu::vector_size(NR * sizeof(Ty) / 2UL)]] = Ty;
+  vec acc[MR][2]{};
+  for (std::size_t p{}; p < kc; ++p) {
+    vec b_lo;
+    vec b_hi;
+    std::memcpy(&b_lo, b, sizeof(vec));
+    std::memcpy(&b_hi, b + (NR / 2UL), sizeof(vec));
+    for (std::size_t i{}; i < MR; ++i) {
+      acc[i][0] += a[i] * b_lo;
+      acc[i][1] += a[i] * b_hi;
+    }
+    a += MR;
+    b += NR;
+  }
+  const auto tile = [&acc](const std::size_t i, const std::size_t j) -> Ty {
+    return acc[i][j / (NR / 2UL)][j % (NR / 2UL)];
+  };
+#else
+  Ty acc[MR][NR]{};
+  for (std::size_t p{}; p < kc; ++p) {
+    for (std::size_t i{}; i < MR; ++i) {
+      for (std::size_t j{}; j < NR; ++j) {
+        acc[i][j] += a[i] * b[j];
+      }
+    }
+    a += MR;
+    b += NR;
+  }
+  const auto tile = [&acc](const std::size_t i, const std::size_t j) -> Ty {
+    return acc[i][j];
+  };
+#endif
+  for (std::size_t i{}; i < mr; ++i) {
+    for (std::size_t j{}; j < nr; ++j) {
+      c[(i * rsc) + (j * csc)] += alpha * tile(i, j);
+    }
+  }
+}
+
+/// @brief un-packed i-k-j loop for products too small to amortize packing
+template <class Ty>
+auto gemm_small(const std::size_t m, const std::size_t n, const std::size_t k,
+                const Ty alpha, const Ty *a, const std::size_t rsa,
+                const std::size_t csa, const Ty *b, const std::size_t rsb,
+                const std::size_t csb, Ty *c, const std::size_t rsc,
+                const std::size_t csc) -> void {
+  for (std::size_t i{}; i < m; ++i) {
+    for (std::size_t p{}; p < k; ++p) {
+      const Ty a_ip{alpha * a[(i * rsa) + (p * csa)]};
+      for (std::size_t j{}; j < n; ++j) {
+        c[(i * rsc) + (j * csc)] += a_ip * b[(p * rsb) + (j * csb)];
+      }
+    }
+  }
+}
+
+/// @brief `C = beta * C`, a `beta` of `0` clears `C` (even NaNs)
+template <class Ty>
+auto scale_c(const std::size_t m, const std::size_t n, const Ty beta, Ty *c,
+             const std::size_t rsc, const std::size_t csc) -> void {
+  if (beta == Ty{1}) {
+    return;
+  }
+  for (std::size_t i{}; i < m; ++i) {
+    for (std::size_t j{}; j < n; ++j) {
+      c[(i * rsc) + (j * csc)] =
+          beta == Ty{} ? Ty{} : beta * c[(i * rsc) + (j * csc)];
+    }
+  }
+}
+
+/// @brief per-thread packing buffers, big enough for one `MC x KC` block of
+/// `A` and one `KC x NC` panel of `B`, allocated once per thread
+template <class Ty> auto packing_buffers() -> std::pair<Ty *, Ty *> {
+  using blk = gemm_blocking<Ty>;
+  thread_local kraken::detail::aligned_buffer<Ty> packed_a(blk::MC * blk::KC);
+  thread_local kraken::detail::aligned_buffer<Ty> packed_b(blk::KC * blk::NC);
+  return {packed_a.data(), packed_b.data()};
+}
+
+/// @brief runs the blocked product of the `mc x nc` block of `C` that
+/// starts at (`ic`, `jc`), `packed_a`, `packed_b` must hold `MC * KC` and
+/// `KC * NC` elements
+template <class Ty>
+auto gemm_block(const std::size_t ic, const std::size_t mc,
+                const std::size_t jc, const std::size_t nc,
+                const std::size_t k, const Ty alpha, const Ty *a,
+                const std::size_t rsa, const std::size_t csa, const Ty *b,
+                const std::size_t rsb, const std::size_t csb, Ty *c,
+                const std::size_t rsc, const std::size_t csc, Ty *packed_a,
+                Ty *packed_b) -> void {
+  using blk = gemm_blocking<Ty>;
+  for (std::size_t pc{}; pc < k; pc += blk::KC) {
+    const std::size_t kc{std::min(blk::KC, k - pc)};
+    pack_b(kc, nc, b + (pc * rsb) + (jc * csb), rsb, csb, packed_b);
+    for (std::size_t ib{}; ib < mc; ib += blk::MC) {
+      const std::size_t mcb{std::min(blk::MC, mc - ib)};
+      pack_a(mcb, kc, a + ((ic + ib) * rsa) + (pc * csa), rsa, csa, packed_a);
+      for (std::size_t jr{}; jr < nc; jr += blk::NR) {
+        for (std::size_t ir{}; ir < mcb; ir += blk::MR) {
+          micro_kernel(kc, alpha, packed_a + (ir * kc), packed_b + (jr * kc),
+                       c + ((ic + ib + ir) * rsc) + ((jc + jr) * csc), rsc,
+                       csc, std::min(blk::MR, mcb - ir),
+                       std::min(blk::NR, nc - jr));
+        }
+      }
+    }
+  }
+}
+} // namespace detail
+
+/// @brief general matrix-matrix product `C = alpha * A * B + beta * C`
+/// every operand is addressed with a row-stride and a column-stride, so
+/// row-major (`rs = ld, cs = 1`), column-major (`rs = 1, cs = ld`) and
+/// transposed operands are all handled without copies
+/// @param m rows of `A` and `C`
+/// @param n columns of `B` and `C`
+/// @param k columns of `A` and rows of `B`
+/// @param threads upper bound on the threads used, `0` means all of them
+template <class Ty>
+auto gemm(const std::size_t m, const std::size_t n, const std::size_t k,
+          const Ty alpha, const Ty *a, const std::size_t rsa,
+          const std::size_t csa, const Ty *b, const std::size_t rsb,
+          const std::size_t csb, const Ty beta, Ty *c, const std::size_t rsc,
+          const std::size_t csc, const std::size_t threads = 1UL) -> void {
+  using blk = gemm_blocking<Ty>;
+  if (m == 0UL || n == 0UL) {
+    return;
+  }
+  detail::scale_c(m, n, beta, c, rsc, csc);
+  if (k == 0UL || alpha == Ty{}) {
+    return;
+  }
+  if (m * n * k < blk::small) {
+    detail::gemm_small(m, n, k, alpha, a, rsa, csa, b, rsb, csb, c, rsc, csc);
+    return;
+  }
+  auto &pool{kraken::detail::thread_pool::instance()};
+  // tiles follow the requested count, `parallel_for` caps it to the pool
+  const std::size_t workers{threads == 0UL ? pool.concurrency() : threads};
+  if (workers <= 1UL) {
+    const auto [packed_a, packed_b] = detail::packing_buffers<Ty>();
+    for (std::size_t jc{}; jc < n; jc += blk::NC) {
+      detail::gemm_block(0UL, m, jc, std::min(blk::NC, n - jc), k, alpha, a,
+                         rsa, csa, b, rsb, csb, c, rsc, csc, packed_a,
+                         packed_b);
+    }
+    return;
+  }
+  // every task owns one `tile_m x tile_n` tile of `C`, tall-skinny products
+  // are cut along rows only, square ones along both directions
+  const std::size_t tiles_m{(m + blk::MC - 1) / blk::MC};
+  const std::size_t split_n{
+      std::max(1UL, std::min((2UL * workers + tiles_m - 1) / tiles_m,
+                             (n + blk::NR - 1) / blk::NR))};
+  const std::size_t tile_n{std::min(
+      blk::NC, (((n + split_n - 1) / split_n + blk::NR - 1) / blk::NR) *
+                   blk::NR)};
+  const std::size_t tiles_n{(n + tile_n - 1) / tile_n};
+  pool.parallel_for(tiles_m * tiles_n, workers, [&](const std::size_t tile) {
+    const auto [packed_a, packed_b] = detail::packing_buffers<Ty>();
+    const std::size_t ic{(tile / tiles_n) * blk::MC};
+    const std::size_t jc{(tile % tiles_n) * tile_n};
+    detail::gemm_block(ic, std::min(blk::MC, m - ic), jc,
+                       std::min(tile_n, n - jc), k, alpha, a, rsa, csa, b, rsb,
+                       csb, c, rsc, csc, packed_a, packed_b);
+  });
+}
+
+/// @brief row-major matrix-matrix product `C = alpha * A * B + beta * C`
+/// @param lda, ldb, ldc distance (in elements) between two rows
+/// @param threads upper bound on the threads used, `0` means all of them
+template <class Ty>
+auto gemm(const std::size_t m, const std::size_t n, const std::size_t k,
+          const Ty alpha, const Ty *a, const std::size_t lda, const Ty *b,
+          const std::size_t ldb, const Ty beta, Ty *c, const std::size_t ldc,
+          const std::size_t threads = 1UL) -> void {
+  gemm(m, n, k, alpha, a, lda, 1UL, b, ldb, 1UL, beta, c, ldc, 1UL, threads);
+}
+} // namespace kraken::blas
+
+#endif // GEMM_HPP
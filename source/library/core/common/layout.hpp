@@ -0,0 +1,227 @@
+#ifndef LAYOUT_HPP
+#define LAYOUT_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "aligned_buffer.hpp" // cache_line
+#include <cstddef>            // std::size_t, std::ptrdiff_t
+#include <compare>            // operator<=>
+#include <iterator>           // std::random_access_iterator_tag
+#include <type_traits>        // std::remove_const_t, std::is_same_v
+
+/// @brief storage policies of `matrix_<>`, a layout decides the alignment of
+/// the buffer and the leading dimension `ld` (distance in elements between
+/// the starts of two rows). element (i, j) lives at `i * ld + j`, the
+/// `ld - col` elements at the end of every row are padding and stay `0`.
+/// `col_major<>` turns any of them around: the columns are stored back to
+/// back, (i, j) lives at `j * ld + i` and `ld` is picked from `row`
+namespace kraken::layout {
+
+/// @brief rows are back to back, `ld == col` (the default)
+struct packed {
+  template <class Ty> static constexpr std::size_t alignment{alignof(Ty)};
+  template <class Ty, std::size_t COL> static constexpr std::size_t ld{COL};
+};
+
+/// @brief 64-byte aligned buffer whose rows start on a cache-line
+/// @tparam LD leading dimension, `0` picks one: `col` rounded up to a whole
+/// cache-line, plus one more cache-line when a row would be a multiple of
+/// 4 KiB (a column walk would then hit the same cache set every row)
+template <std::size_t LD = 0UL> struct padded {
+  template <class Ty>
+  static constexpr std::size_t alignment{kraken::detail::cache_line};
+
+private:
+  template <class Ty, std::size_t COL>
+  static constexpr auto pick() noexcept -> std::size_t {
+    constexpr std::size_t per_line{kraken::detail::cache_line / sizeof(Ty) > 0UL
+                                       ? kraken::detail::cache_line / sizeof(Ty)
+                                       : 1UL};
+    std::size_t ld{((COL + per_line - 1UL) / per_line) * per_line};
+    if ((ld * sizeof(Ty)) % 4096UL == 0UL) {
+      ld += per_line;
+    }
+    return ld;
+  }
+
+public:
+  template <class Ty, std::size_t COL>
+  static constexpr std::size_t ld{LD == 0UL ? pick<Ty, COL>() : LD};
+};
+
+/// @brief column-major storage with the alignment and leading dimension of
+/// `Base`, which sees the number of rows where it would see `col`
+template <class Base = packed> struct col_major {
+  template <class Ty>
+  static constexpr std::size_t alignment{Base::template alignment<Ty>};
+  template <class Ty, std::size_t ROW>
+  static constexpr std::size_t ld{Base::template ld<Ty, ROW>};
+};
+
+template <class Layout> struct is_col_major : std::false_type {};
+template <class Base>
+struct is_col_major<col_major<Base>> : std::true_type {};
+
+/// @brief the layout whose buffer, read as is, holds the transpose: a
+/// row-major `row x col` buffer is a column-major `col x row` one
+template <class Layout> struct transposed {
+  using type = col_major<Layout>;
+};
+template <class Base> struct transposed<col_major<Base>> {
+  using type = Base;
+};
+template <class Layout>
+using transposed_t = typename transposed<Layout>::type;
+
+/// @brief the layout of a matrix of another shape built from one of layout
+/// `Layout`: an explicit leading dimension was picked for the old shape and
+/// may be too short, so `padded<LD>` picks one again
+template <class Layout> struct reshaped {
+  using type = Layout;
+};
+template <std::size_t LD> struct reshaped<padded<LD>> {
+  using type = padded<>;
+};
+template <class Base> struct reshaped<col_major<Base>> {
+  using type = col_major<typename reshaped<Base>::type>;
+};
+template <class Layout> using reshaped_t = typename reshaped<Layout>::type;
+} // namespace kraken::layout
+
+namespace kraken::detail {
+
+/// @brief walks the `COL` elements of every row, `RS` elements apart from one
+/// row to the next and `CS` from one column to the next, so begin()/end() of
+/// a padded or column-major matrix see the same elements, in the same order
+/// (row by row), as a packed one
+template <class Ty, std::size_t COL, std::size_t RS, std::size_t CS = 1UL>
+class strided_iterator {
+private:
+  Ty *m_base{nullptr};
+  std::ptrdiff_t m_index{};
+
+  static constexpr auto offset(const std::ptrdiff_t index) noexcept
+      -> std::ptrdiff_t {
+    constexpr auto col{static_cast<std::ptrdiff_t>(COL)};
+    return ((index / col) * static_cast<std::ptrdiff_t>(RS)) +
+           ((index % col) * static_cast<std::ptrdiff_t>(CS));
+  }
+
+public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::remove_const_t<Ty>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = Ty *;
+  using reference = Ty &;
+
+  constexpr strided_iterator() noexcept = default;
+  constexpr strided_iterator(Ty *base, const difference_type index) noexcept
+      : m_base{base}, m_index{index} {}
+  /// @brief iterator -> const_iterator
+  template <class U>
+  requires(std::is_same_v<Ty, const U>) constexpr strided_iterator(
+      const strided_iterator<U, COL, RS, CS> &other) noexcept
+      : m_base{other.base()}, m_index{other.index()} {}
+
+  [[nodiscard]] constexpr auto base() const noexcept -> Ty * { return m_base; }
+  [[nodiscard]] constexpr auto index() const noexcept -> difference_type {
+    return m_index;
+  }
+
+  [[nodiscard]] constexpr auto operator*() const noexcept -> reference {
+    return m_base[offset(m_index)];
+  }
+  [[nodiscard]] constexpr auto operator->() const noexcept -> pointer {
+    return m_base + offset(m_index);
+  }
+  [[nodiscard]] constexpr auto operator[](const difference_type n) const noexcept
+      -> reference {
+    return m_base[offset(m_index + n)];
+  }
+
+  constexpr auto operator++() noexcept -> strided_iterator & {
+    ++m_index;
+    return *this;
+  }
+  constexpr auto operator++(int) noexcept -> strided_iterator {
+    auto temp{*this};
+    ++m_index;
+    return temp;
+  }
+  constexpr auto operator--() noexcept -> strided_iterator & {
+    --m_index;
+    return *this;
+  }
+  constexpr auto operator--(int) noexcept -> strided_iterator {
+    auto temp{*this};
+    --m_index;
+    return temp;
+  }
+  constexpr auto operator+=(const difference_type n) noexcept
+      -> strided_iterator & {
+    m_index += n;
+    return *this;
+  }
+  constexpr auto operator-=(const difference_type n) noexcept
+      -> strided_iterator & {
+    m_index -= n;
+    return *this;
+  }
+  [[nodiscard]] friend constexpr auto
+  operator+(strided_iterator it, const difference_type n) noexcept
+      -> strided_iterator {
+    return it += n;
+  }
+  [[nodiscard]] friend constexpr auto operator+(const difference_type n,
+                                                strided_iterator it) noexcept
+      -> strided_iterator {
+    return it += n;
+  }
+  [[nodiscard]] friend constexpr auto
+  operator-(strided_iterator it, const difference_type n) noexcept
+      -> strided_iterator {
+    return it -= n;
+  }
+  [[nodiscard]] friend constexpr auto
+  operator-(const strided_iterator &lhs, const strided_iterator &rhs) noexcept
+      -> difference_type {
+    return lhs.m_index - rhs.m_index;
+  }
+  [[nodiscard]] friend constexpr auto
+  operator==(const strided_iterator &lhs, const strided_iterator &rhs) noexcept
+      -> bool {
+    return lhs.m_index == rhs.m_index;
+  }
+  [[nodiscard]] friend constexpr auto
+  operator<=>(const strided_iterator &lhs,
+              const strided_iterator &rhs) noexcept {
+    return lhs.m_index <=> rhs.m_index;
+  }
+};
+} // namespace kraken::detail
+
+#endif // LAYOUT_HPP
@@ -0,0 +1,526 @@
+#ifndef LEVEL1_HPP
+#define LEVEL1_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <cmath>       // std::sqrt, std::abs, std::isfinite
+#include <cstddef>     // std::size_t
+#include <limits>      // std::numeric_limits
+#include <type_traits> // std::is_floating_point_v
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+/// @brief level-1 kernels (vector-vector) on `n` elements that are `inc` apart,
+/// unit strides of `float` and `double` run on AVX-512 or AVX2 + FMA registers
+/// when the target has them, every other case takes the scalar loop
+namespace kraken::blas {
+
+namespace detail {
+
+/// @brief the vector register of `Ty`, `enabled` is false when there is none
+template <class Ty> struct simd {
+  static constexpr bool enabled{false};
+};
+
+#if defined(__AVX512F__)
+// gcc 12 flags the `_mm512_undefined_*` inside its own avx-512 intrinsics
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+template <> struct simd<float> {
+  static constexpr bool enabled{true};
+  static constexpr std::size_t lanes{16UL};
+  using type = __m512;
+  static auto zero() noexcept -> type { return _mm512_setzero_ps(); }
+  static auto set(const float v) noexcept -> type { return _mm512_set1_ps(v); }
+  static auto load(const float *p) noexcept -> type { return _mm512_loadu_ps(p); }
+  static auto store(float *p, const type v) noexcept -> void {
+    _mm512_storeu_ps(p, v);
+  }
+  /// `p[idx[0]], ..., p[idx[15]]`, two gathers of eight 64-bit indices
+  static auto gather(const float *p, const std::size_t *idx) noexcept -> type {
+    const __m256 lo{_mm512_i64gather_ps(_mm512_loadu_si512(idx), p, 4)};
+    const __m256 hi{_mm512_i64gather_ps(_mm512_loadu_si512(idx + 8), p, 4)};
+    return _mm512_castpd_ps(_mm512_insertf64x4(
+        _mm512_castpd256_pd512(_mm256_castps_pd(lo)), _mm256_castps_pd(hi), 1));
+  }
+  static auto mul(const type a, const type b) noexcept -> type {
+    return _mm512_mul_ps(a, b);
+  }
+  static auto add(const type a, const type b) noexcept -> type {
+    return _mm512_add_ps(a, b);
+  }
+  /// `a * b + c`
+  static auto fma(const type a, const type b, const type c) noexcept -> type {
+    return _mm512_fmadd_ps(a, b, c);
+  }
+  static auto abs(const type a) noexcept -> type { return _mm512_abs_ps(a); }
+  static auto max(const type a, const type b) noexcept -> type {
+    return _mm512_max_ps(a, b);
+  }
+  static auto min(const type a, const type b) noexcept -> type {
+    return _mm512_min_ps(a, b);
+  }
+  /// folds the 128-bit quarters onto each other, `_mm512_reduce_add_ps` does
+  /// the same but trips `-Wmaybe-uninitialized` on gcc 12
+  static auto sum(type a) noexcept -> float {
+    a = _mm512_add_ps(a, _mm512_shuffle_f32x4(a, a, _MM_SHUFFLE(1, 0, 3, 2)));
+    a = _mm512_add_ps(a, _mm512_shuffle_f32x4(a, a, _MM_SHUFFLE(2, 3, 0, 1)));
+    __m128 r{_mm512_castps512_ps128(a)};
+    r = _mm_add_ps(r, _mm_movehl_ps(r, r));
+    r = _mm_add_ss(r, _mm_movehdup_ps(r));
+    return _mm_cvtss_f32(r);
+  }
+  static auto hmax(type a) noexcept -> float {
+    a = _mm512_max_ps(a, _mm512_shuffle_f32x4(a, a, _MM_SHUFFLE(1, 0, 3, 2)));
+    a = _mm512_max_ps(a, _mm512_shuffle_f32x4(a, a, _MM_SHUFFLE(2, 3, 0, 1)));
+    __m128 r{_mm512_castps512_ps128(a)};
+    r = _mm_max_ps(r, _mm_movehl_ps(r, r));
+    r = _mm_max_ss(r, _mm_movehdup_ps(r));
+    return _mm_cvtss_f32(r);
+  }
+  static auto hmin(type a) noexcept -> float {
+    a = _mm512_min_ps(a, _mm512_shuffle_f32x4(a, a, _MM_SHUFFLE(1, 0, 3, 2)));
+    a = _mm512_min_ps(a, _mm512_shuffle_f32x4(a, a, _MM_SHUFFLE(2, 3, 0, 1)));
+    __m128 r{_mm512_castps512_ps128(a)};
+    r = _mm_min_ps(r, _mm_movehl_ps(r, r));
+    r = _mm_min_ss(r, _mm_movehdup_ps(r));
+    return _mm_cvtss_f32(r);
+  }
+};
+
+template <> struct simd<double> {
+  static constexpr bool enabled{true};
+  static constexpr std::size_t lanes{8UL};
+  using type = __m512d;
+  static auto zero() noexcept -> type { return _mm512_setzero_pd(); }
+  static auto set(const double v) noexcept -> type { return _mm512_set1_pd(v); }
+  static auto load(const double *p) noexcept -> type {
+    return _mm512_loadu_pd(p);
+  }
+  static auto store(double *p, const type v) noexcept -> void {
+    _mm512_storeu_pd(p, v);
+  }
+  static auto gather(const double *p, const std::size_t *idx) noexcept
+      -> type {
+    return _mm512_i64gather_pd(_mm512_loadu_si512(idx), p, 8);
+  }
+  static auto mul(const type a, const type b) noexcept -> type {
+    return _mm512_mul_pd(a, b);
+  }
+  static auto add(const type a, const type b) noexcept -> type {
+    return _mm512_add_pd(a, b);
+  }
+  static auto fma(const type a, const type b, const type c) noexcept -> type {
+    return _mm512_fmadd_pd(a, b, c);
+  }
+  static auto abs(const type a) noexcept -> type { return _mm512_abs_pd(a); }
+  static auto max(const type a, const type b) noexcept -> type {
+    return _mm512_max_pd(a, b);
+  }
+  static auto min(const type a, const type b) noexcept -> type {
+    return _mm512_min_pd(a, b);
+  }
+  static auto sum(type a) noexcept -> double {
+    a = _mm512_add_pd(a, _mm512_shuffle_f64x2(a, a, _MM_SHUFFLE(1, 0, 3, 2)));
+    a = _mm512_add_pd(a, _mm512_shuffle_f64x2(a, a, _MM_SHUFFLE(2, 3, 0, 1)));
+    __m128d r{_mm512_castpd512_pd128(a)};
+    r = _mm_add_sd(r, _mm_unpackhi_pd(r, r));
+    return _mm_cvtsd_f64(r);
+  }
+  static auto hmax(type a) noexcept -> double {
+    a = _mm512_max_pd(a, _mm512_shuffle_f64x2(a, a, _MM_SHUFFLE(1, 0, 3, 2)));
+    a = _mm512_max_pd(a, _mm512_shuffle_f64x2(a, a, _MM_SHUFFLE(2, 3, 0, 1)));
+    __m128d r{_mm512_castpd512_pd128(a)};
+    r = _mm_max_sd(r, _mm_unpackhi_pd(r, r));
+    return _mm_cvtsd_f64(r);
+  }
+  static auto hmin(type a) noexcept -> double {
+    a = _mm512_min_pd(a, _mm512_shuffle_f64x2(a, a, _MM_SHUFFLE(1, 0, 3, 2)));
+    a = _mm512_min_pd(a, _mm512_shuffle_f64x2(a, a, _MM_SHUFFLE(2, 3, 0, 1)));
+    __m128d r{_mm512_castpd512_pd128(a)};
+    r = _mm_min_sd(r, _mm_unpackhi_pd(r, r));
+    return _mm_cvtsd_f64(r);
+  }
+};
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#elif defined(__AVX2__) && defined(__FMA__)
+template <> struct simd<float> {
+  static constexpr bool enabled{true};
+  static constexpr std::size_t lanes{8UL};
+  using type = __m256;
+  static auto zero() noexcept -> type { return _mm256_setzero_ps(); }
+  static auto set(const float v) noexcept -> type { return _mm256_set1_ps(v); }
+  static auto load(const float *p) noexcept -> type { return _mm256_loadu_ps(p); }
+  static auto store(float *p, const type v) noexcept -> void {
+    _mm256_storeu_ps(p, v);
+  }
+  /// `p[idx[0]], ..., p[idx[7]]`, two gathers of four 64-bit indices
+  static auto gather(const float *p, const std::size_t *idx) noexcept -> type {
+    const auto *const i{reinterpret_cast<const __m256i *>(idx)};
+    return _mm256_set_m128(
+        _mm256_i64gather_ps(p, _mm256_loadu_si256(i + 1), 4),
+        _mm256_i64gather_ps(p, _mm256_loadu_si256(i), 4));
+  }
+  static auto mul(const type a, const type b) noexcept -> type {
+    return _mm256_mul_ps(a, b);
+  }
+  static auto add(const type a, const type b) noexcept -> type {
+    return _mm256_add_ps(a, b);
+  }
+  static auto fma(const type a, const type b, const type c) noexcept -> type {
+    return _mm256_fmadd_ps(a, b, c);
+  }
+  /// clears the sign bit
+  static auto abs(const type a) noexcept -> type {
+    return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a);
+  }
+  static auto max(const type a, const type b) noexcept -> type {
+    return _mm256_max_ps(a, b);
+  }
+  static auto min(const type a, const type b) noexcept -> type {
+    return _mm256_min_ps(a, b);
+  }
+  static auto sum(const type a) noexcept -> float {
+    __m128 r{_mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1))};
+    r = _mm_add_ps(r, _mm_movehl_ps(r, r));
+    r = _mm_add_ss(r, _mm_movehdup_ps(r));
+    return _mm_cvtss_f32(r);
+  }
+  static auto hmax(const type a) noexcept -> float {
+    __m128 r{_mm_max_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1))};
+    r = _mm_max_ps(r, _mm_movehl_ps(r, r));
+    r = _mm_max_ss(r, _mm_movehdup_ps(r));
+    return _mm_cvtss_f32(r);
+  }
+  static auto hmin(const type a) noexcept -> float {
+    __m128 r{_mm_min_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1))};
+    r = _mm_min_ps(r, _mm_movehl_ps(r, r));
+    r = _mm_min_ss(r, _mm_movehdup_ps(r));
+    return _mm_cvtss_f32(r);
+  }
+};
+
+template <> struct simd<double> {
+  static constexpr bool enabled{true};
+  static constexpr std::size_t lanes{4UL};
+  using type = __m256d;
+  static auto zero() noexcept -> type { return _mm256_setzero_pd(); }
+  static auto set(const double v) noexcept -> type { return _mm256_set1_pd(v); }
+  static auto load(const double *p) noexcept -> type {
+    return _mm256_loadu_pd(p);
+  }
+  static auto store(double *p, const type v) noexcept -> void {
+    _mm256_storeu_pd(p, v);
+  }
+  static auto gather(const double *p, const std::size_t *idx) noexcept
+      -> type {
+    return _mm256_i64gather_pd(
+        p, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(idx)), 8);
+  }
+  static auto mul(const type a, const type b) noexcept -> type {
+    return _mm256_mul_pd(a, b);
+  }
+  static auto add(const type a, const type b) noexcept -> type {
+    return _mm256_add_pd(a, b);
+  }
+  static auto fma(const type a, const type b, const type c) noexcept -> type {
+    return _mm256_fmadd_pd(a, b, c);
+  }
+  static auto abs(const type a) noexcept -> type {
+    return _mm256_andnot_pd(_mm256_set1_pd(-0.), a);
+  }
+  static auto max(const type a, const type b) noexcept -> type {
+    return _mm256_max_pd(a, b);
+  }
+  static auto min(const type a, const type b) noexcept -> type {
+    return _mm256_min_pd(a, b);
+  }
+  static auto sum(const type a) noexcept -> double {
+    __m128d r{_mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1))};
+    r = _mm_add_sd(r, _mm_unpackhi_pd(r, r));
+    return _mm_cvtsd_f64(r);
+  }
+  static auto hmax(const type a) noexcept -> double {
+    __m128d r{_mm_max_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1))};
+    r = _mm_max_sd(r, _mm_unpackhi_pd(r, r));
+    return _mm_cvtsd_f64(r);
+  }
+  static auto hmin(const type a) noexcept -> double {
+    __m128d r{_mm_min_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1))};
+    r = _mm_min_sd(r, _mm_unpackhi_pd(r, r));
+    return _mm_cvtsd_f64(r);
+  }
+};
+#endif
+
+/// @brief `|val|` for signed and unsigned types alike
+template <class Ty> constexpr auto magnitude(const Ty val) noexcept -> Ty {
+  if constexpr (std::is_signed_v<Ty>) {
+    return val < Ty{} ? static_cast<Ty>(-val) : val;
+  } else {
+    return val;
+  }
+}
+
+/// @brief largest `|x[i]|`, `0` for an empty vector
+template <class Ty>
+auto amax(const std::size_t n, const Ty *x, const std::size_t incx) noexcept
+    -> Ty {
+  Ty result{};
+  std::size_t i{};
+  if constexpr (simd<Ty>::enabled) {
+    using v = simd<Ty>;
+    if (incx == 1UL && n >= v::lanes) {
+      auto acc{v::zero()};
+      for (; i + v::lanes <= n; i += v::lanes) {
+        acc = v::max(acc, v::abs(v::load(x + i)));
+      }
+      result = v::hmax(acc);
+    }
+  }
+  for (; i < n; ++i) {
+    const Ty m{magnitude(x[i * incx])};
+    result = m > result ? m : result;
+  }
+  return result;
+}
+} // namespace detail
+
+/// @brief `y = alpha * x + y`
+template <class Ty>
+auto axpy(const std::size_t n, const Ty alpha, const Ty *x,
+          const std::size_t incx, Ty *y, const std::size_t incy) noexcept
+    -> void {
+  std::size_t i{};
+  if constexpr (detail::simd<Ty>::enabled) {
+    using v = detail::simd<Ty>;
+    if (incx == 1UL && incy == 1UL) {
+      const auto a{v::set(alpha)};
+      for (; i + (2UL * v::lanes) <= n; i += 2UL * v::lanes) {
+        v::store(y + i, v::fma(a, v::load(x + i), v::load(y + i)));
+        v::store(y + i + v::lanes,
+                 v::fma(a, v::load(x + i + v::lanes), v::load(y + i + v::lanes)));
+      }
+      for (; i + v::lanes <= n; i += v::lanes) {
+        v::store(y + i, v::fma(a, v::load(x + i), v::load(y + i)));
+      }
+    }
+  }
+  for (; i < n; ++i) {
+    y[i * incy] = static_cast<Ty>(y[i * incy] + (alpha * x[i * incx]));
+  }
+}
+
+/// @brief `x = alpha * x`
+template <class Ty>
+auto scal(const std::size_t n, const Ty alpha, Ty *x,
+          const std::size_t incx) noexcept -> void {
+  std::size_t i{};
+  if constexpr (detail::simd<Ty>::enabled) {
+    using v = detail::simd<Ty>;
+    if (incx == 1UL) {
+      const auto a{v::set(alpha)};
+      for (; i + v::lanes <= n; i += v::lanes) {
+        v::store(x + i, v::mul(a, v::load(x + i)));
+      }
+    }
+  }
+  // counted down over a pointer, gcc 12 misreads the trip count of `i < n`
+  // (and of `i * incx`) after the vector loop once it is inlined into a
+  // matrix or a view of known size
+  Ty *p{x + (i * incx)};
+  for (std::size_t k{n - i}; k > 0UL; --k, p += incx) {
+    *p = static_cast<Ty>(*p * alpha);
+  }
+}
+
+/// @brief hadamard (elementwise) product in place, `y[i] = x[i] * y[i]`
+template <class Ty>
+auto hadamard(const std::size_t n, const Ty *x, const std::size_t incx, Ty *y,
+              const std::size_t incy) noexcept -> void {
+  std::size_t i{};
+  if constexpr (detail::simd<Ty>::enabled) {
+    using v = detail::simd<Ty>;
+    if (incx == 1UL && incy == 1UL) {
+      for (; i + v::lanes <= n; i += v::lanes) {
+        v::store(y + i, v::mul(v::load(x + i), v::load(y + i)));
+      }
+    }
+  }
+  for (std::size_t k{n - i}; k > 0UL; --k, ++i) {
+    y[i * incy] = static_cast<Ty>(x[i * incx] * y[i * incy]);
+  }
+}
+
+/// @brief `sum(x[i] * y[i])`, four independent accumulators hide the latency
+/// of the fma
+template <class Ty>
+[[nodiscard]] auto dot(const std::size_t n, const Ty *x, const std::size_t incx,
+                       const Ty *y, const std::size_t incy) noexcept -> Ty {
+  Ty result{};
+  std::size_t i{};
+  if constexpr (detail::simd<Ty>::enabled) {
+    using v = detail::simd<Ty>;
+    if (incx == 1UL && incy == 1UL && n >= v::lanes) {
+      auto acc0{v::zero()};
+      auto acc1{v::zero()};
+      auto acc2{v::zero()};
+      auto acc3{v::zero()};
+      for (; i + (4UL * v::lanes) <= n; i += 4UL * v::lanes) {
+        acc0 = v::fma(v::load(x + i), v::load(y + i), acc0);
+        acc1 = v::fma(v::load(x + i + v::lanes), v::load(y + i + v::lanes), acc1);
+        acc2 = v::fma(v::load(x + i + (2UL * v::lanes)),
+                      v::load(y + i + (2UL * v::lanes)), acc2);
+        acc3 = v::fma(v::load(x + i + (3UL * v::lanes)),
+                      v::load(y + i + (3UL * v::lanes)), acc3);
+      }
+      for (; i + v::lanes <= n; i += v::lanes) {
+        acc0 = v::fma(v::load(x + i), v::load(y + i), acc0);
+      }
+      result = v::sum(v::add(v::add(acc0, acc1), v::add(acc2, acc3)));
+    }
+  }
+  for (; i < n; ++i) {
+    result = static_cast<Ty>(result + (x[i * incx] * y[i * incy]));
+  }
+  return result;
+}
+
+/// @brief sparse dot product `sum(x[i] * y[indx[i] * incy])`, `x` holds the
+/// nonzeros of a sparse vector and `indx` their positions in the dense `y`,
+/// unit strides gather `y` straight into vector registers
+template <class Ty>
+[[nodiscard]] auto doti(const std::size_t n, const Ty *x,
+                        const std::size_t *indx, const Ty *y,
+                        const std::size_t incy) noexcept -> Ty {
+  Ty result{};
+  std::size_t i{};
+  if constexpr (detail::simd<Ty>::enabled) {
+    using v = detail::simd<Ty>;
+    if (incy == 1UL && n >= v::lanes) {
+      auto acc0{v::zero()};
+      auto acc1{v::zero()};
+      for (; i + (2UL * v::lanes) <= n; i += 2UL * v::lanes) {
+        acc0 = v::fma(v::load(x + i), v::gather(y, indx + i), acc0);
+        acc1 = v::fma(v::load(x + i + v::lanes),
+                      v::gather(y, indx + i + v::lanes), acc1);
+      }
+      for (; i + v::lanes <= n; i += v::lanes) {
+        acc0 = v::fma(v::load(x + i), v::gather(y, indx + i), acc0);
+      }
+      result = v::sum(v::add(acc0, acc1));
+    }
+  }
+  for (; i < n; ++i) {
+    result = static_cast<Ty>(result + (x[i] * y[indx[i] * incy]));
+  }
+  return result;
+}
+
+/// @brief sparse update `y[indx[i] * incy] += alpha * x[i]`, the positions in
+/// `indx` must be distinct
+template <class Ty>
+auto axpyi(const std::size_t n, const Ty alpha, const Ty *x,
+           const std::size_t *indx, Ty *y, const std::size_t incy) noexcept
+    -> void {
+  for (std::size_t i{}; i < n; ++i) {
+    y[indx[i] * incy] = static_cast<Ty>(y[indx[i] * incy] + (alpha * x[i]));
+  }
+}
+
+/// @brief `sum(|x[i]|)`
+template <class Ty>
+[[nodiscard]] auto asum(const std::size_t n, const Ty *x,
+                        const std::size_t incx) noexcept -> Ty {
+  Ty result{};
+  std::size_t i{};
+  if constexpr (detail::simd<Ty>::enabled) {
+    using v = detail::simd<Ty>;
+    if (incx == 1UL && n >= v::lanes) {
+      auto acc0{v::zero()};
+      auto acc1{v::zero()};
+      for (; i + (2UL * v::lanes) <= n; i += 2UL * v::lanes) {
+        acc0 = v::add(acc0, v::abs(v::load(x + i)));
+        acc1 = v::add(acc1, v::abs(v::load(x + i + v::lanes)));
+      }
+      for (; i + v::lanes <= n; i += v::lanes) {
+        acc0 = v::add(acc0, v::abs(v::load(x + i)));
+      }
+      result = v::sum(v::add(acc0, acc1));
+    }
+  }
+  for (; i < n; ++i) {
+    result = static_cast<Ty>(result + detail::magnitude(x[i * incx]));
+  }
+  return result;
+}
+
+/// @brief euclidean norm `sqrt(sum(x[i]^2))`, the plain sum of squares is
+/// taken first and only when it over or underflows is the vector scaled by
+/// its largest element (a second pass)
+template <class Ty>
+requires(std::is_floating_point_v<Ty>) [[nodiscard]] auto nrm2(
+    const std::size_t n, const Ty *x, const std::size_t incx) noexcept -> Ty {
+  const Ty ssq{dot(n, x, incx, x, incx)};
+  if (std::isfinite(ssq) && ssq >= std::numeric_limits<Ty>::min()) {
+    return std::sqrt(ssq);
+  }
+  const Ty scale{detail::amax(n, x, incx)};
+  if (scale == Ty{} || !std::isfinite(scale)) {
+    return scale;
+  }
+  Ty scaled{};
+  for (std::size_t i{}; i < n; ++i) {
+    const Ty t{x[i * incx] / scale};
+    scaled += t * t;
+  }
+  return scale * std::sqrt(scaled);
+}
+
+/// @brief index of the first element with the largest `|x[i]|`, `0` for an
+/// empty vector. the maximum is found with vector registers, then a scalar
+/// scan stops at its first occurrence
+template <class Ty>
+[[nodiscard]] auto iamax(const std::size_t n, const Ty *x,
+                         const std::size_t incx) noexcept -> std::size_t {
+  const Ty largest{detail::amax(n, x, incx)};
+  for (std::size_t i{}; i < n; ++i) {
+    if (detail::magnitude(x[i * incx]) == largest) {
+      return i;
+    }
+  }
+  return 0UL;
+}
+} // namespace kraken::blas
+
+#endif // LEVEL1_HPP
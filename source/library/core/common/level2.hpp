@@ -0,0 +1,111 @@
+#ifndef LEVEL2_HPP
+#define LEVEL2_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "level1.hpp" // dot, axpy, scal
+#include "thread_pool.hpp"
+#include <algorithm> // std::min
+#include <cstddef>   // std::size_t
+
+/// @brief level-2 kernels (matrix-vector) on row-major buffers, the inner
+/// loops are the vectorized level-1 kernels and large problems are split
+/// between the threads of the shared pool
+namespace kraken::blas {
+
+/// @brief how a kernel reads its matrix operand: `none` is `A`, `trans` is
+/// `A^T`
+enum class op : unsigned char { none, trans };
+
+/// @brief below this many elements of `A` a level-2 kernel stays on the
+/// calling thread
+inline constexpr std::size_t level2_parallel{1UL << 18};
+
+/// @brief `y = alpha * op(A) * x + beta * y` with `A` an `m x n` row-major
+/// matrix, `op::none` takes one `dot` per row of `A` (`x` has `n`, `y` `m`
+/// elements), `op::trans` one `axpy` per row of `A` (`x` has `m`, `y` `n`
+/// elements). the rows of `y` are shared between up to `threads` threads
+/// @param lda distance (in elements) between two rows of `A`
+/// @param threads `0` means every hardware thread
+template <class Ty>
+auto gemv(const op trans, const std::size_t m, const std::size_t n,
+          const Ty alpha, const Ty *a, const std::size_t lda, const Ty *x,
+          const std::size_t incx, const Ty beta, Ty *y,
+          const std::size_t incy, const std::size_t threads = 1UL) -> void {
+  const std::size_t len_y{trans == op::none ? m : n};
+  // `beta == 0` overwrites `y`, even a `nan` in it
+  const auto scale_y = [&](const std::size_t first, const std::size_t last) {
+    if (beta == Ty{}) {
+      for (std::size_t i{first}; i < last; ++i) {
+        y[i * incy] = Ty{};
+      }
+    } else {
+      scal(last - first, beta, y + (first * incy), incy);
+    }
+  };
+  // every task owns the elements `[first, last)` of `y`
+  const auto rows = [&](const std::size_t first, const std::size_t last) {
+    if (trans == op::none) {
+      for (std::size_t i{first}; i < last; ++i) {
+        const Ty sum{dot(n, a + (i * lda), 1UL, x, incx)};
+        y[i * incy] = beta == Ty{} ? static_cast<Ty>(alpha * sum)
+                                   : static_cast<Ty>((alpha * sum) +
+                                                     (beta * y[i * incy]));
+      }
+      return;
+    }
+    scale_y(first, last);
+    for (std::size_t i{}; i < m; ++i) {
+      axpy(last - first, static_cast<Ty>(alpha * x[i * incx]),
+           a + (i * lda) + first, 1UL, y + (first * incy), incy);
+    }
+  };
+  if (m == 0UL || n == 0UL || alpha == Ty{}) {
+    scale_y(0UL, len_y);
+    return;
+  }
+  auto &pool{kraken::detail::thread_pool::instance()};
+  const std::size_t workers{threads == 0UL ? pool.concurrency() : threads};
+  if (workers <= 1UL || m * n < level2_parallel) {
+    rows(0UL, len_y);
+    return;
+  }
+  // a few chunks per thread, `op::trans` chunks stay whole cache lines wide
+  const std::size_t chunks{std::min(4UL * workers, len_y)};
+  const std::size_t step{
+      trans == op::none
+          ? (len_y + chunks - 1UL) / chunks
+          : ((((len_y + chunks - 1UL) / chunks) + 15UL) / 16UL) * 16UL};
+  pool.parallel_for((len_y + step - 1UL) / step, workers,
+                    [&](const std::size_t chunk) {
+                      const std::size_t first{chunk * step};
+                      rows(first, std::min(len_y, first + step));
+                    });
+}
+} // namespace kraken::blas
+
+#endif // LEVEL2_HPP
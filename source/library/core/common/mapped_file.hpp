@@ -0,0 +1,278 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <cstddef> // std::size_t, std::byte
+#include <cstdint> // std::uint64_t
+#include <utility> // std::exchange
+
+#if defined(__unix__) || defined(__APPLE__)
+#define KRAKEN_HAS_MMAP 1
+#include <fcntl.h>    // open
+#include <sys/mman.h> // mmap, munmap, madvise, msync
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // close, ftruncate, sysconf
+#else
+#define KRAKEN_HAS_MMAP 0
+#endif
+
+namespace kraken {
+
+/// @brief how a file is mapped
+/// - `read_only`: shared with every other process that maps the file, pages
+///   come from the page cache and are never duplicated
+/// - `read_write`: writes go back to the file
+/// - `copy_on_write`: writes stay private to this mapping
+enum class mapping : unsigned char { read_only, read_write, copy_on_write };
+
+/// @brief how the pages of a mapping are going to be touched
+enum class access : unsigned char { normal, sequential, random };
+
+namespace detail {
+
+/// @brief bytes spanned by `row` rows of `col` elements of `size` bytes each,
+/// `ld` elements apart (the last row is `col` long), as a file holds them
+/// @return `false` if that does not fit in 64 bits, `bytes` is left at `0`
+[[nodiscard]] constexpr auto extent_bytes(const std::uint64_t row,
+                                          const std::uint64_t col,
+                                          const std::uint64_t ld,
+                                          const std::uint64_t size,
+                                          std::uint64_t &bytes) noexcept
+    -> bool {
+  constexpr std::uint64_t most{~std::uint64_t{}};
+  bytes = 0U;
+  if (row == 0U) {
+    return true;
+  }
+  if (ld != 0U && row - 1U > most / ld) {
+    return false;
+  }
+  const std::uint64_t gaps{(row - 1U) * ld};
+  if (col > most - gaps || (size != 0U && gaps + col > most / size)) {
+    return false;
+  }
+  bytes = (gaps + col) * size;
+  return true;
+}
+
+/// @brief owning, move-only mapping of a whole file, opening it costs the
+/// same for any size and the pages are read lazily on first touch. like the
+/// standard streams it does not throw, check `is_open()` instead
+class mapped_file {
+private:
+  std::byte *m_data{nullptr};
+  std::size_t m_size{};
+  mapping m_mode{mapping::read_only};
+
+public:
+  mapped_file() noexcept = default;
+
+  /// @brief maps an existing file, an empty or missing file is not opened
+  explicit mapped_file(const char *path,
+                       const mapping mode = mapping::read_only) noexcept
+      : m_mode{mode} {
+#if KRAKEN_HAS_MMAP
+    const int fd{::open(path, mode == mapping::read_write ? O_RDWR : O_RDONLY)};
+    if (fd < 0) {
+      return;
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+      map(fd, static_cast<std::size_t>(info.st_size));
+    }
+    ::close(fd);
+#else
+    (void)path;
+#endif
+  }
+
+  mapped_file(const mapped_file &) = delete;
+  auto operator=(const mapped_file &) -> mapped_file & = delete;
+
+  mapped_file(mapped_file &&move) noexcept
+      : m_data{std::exchange(move.m_data, nullptr)},
+        m_size{std::exchange(move.m_size, 0UL)}, m_mode{move.m_mode} {}
+
+  auto operator=(mapped_file &&other) noexcept -> mapped_file & {
+    if (this != &other) {
+      unmap();
+      m_data = std::exchange(other.m_data, nullptr);
+      m_size = std::exchange(other.m_size, 0UL);
+      m_mode = other.m_mode;
+    }
+    return *this;
+  }
+
+  ~mapped_file() { unmap(); }
+
+  /// @brief creates (or truncates) `path` with `size` zero bytes and maps it
+  /// `read_write`, the file is sparse until it is written
+  [[nodiscard]] static auto create(const char *path, const std::size_t size)
+      -> mapped_file {
+    mapped_file file{};
+    file.m_mode = mapping::read_write;
+#if KRAKEN_HAS_MMAP
+    const int fd{::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644)};
+    if (fd < 0) {
+      return file;
+    }
+    if (size > 0UL && ::ftruncate(fd, static_cast<off_t>(size)) == 0) {
+      file.map(fd, size);
+    }
+    ::close(fd);
+#else
+    (void)path;
+    (void)size;
+#endif
+    return file;
+  }
+
+  /// @get:
+  [[nodiscard]] auto is_open() const noexcept -> bool {
+    return m_data != nullptr;
+  }
+  [[nodiscard]] auto data() const noexcept -> std::byte * { return m_data; }
+  [[nodiscard]] auto size() const noexcept -> std::size_t { return m_size; }
+  [[nodiscard]] auto mode() const noexcept -> mapping { return m_mode; }
+  [[nodiscard]] auto writable() const noexcept -> bool {
+    return m_mode != mapping::read_only;
+  }
+
+  /// @brief tells the kernel how the whole mapping is going to be read
+  auto advise(const access pattern) const noexcept -> void {
+#if KRAKEN_HAS_MMAP
+    if (is_open()) {
+      ::madvise(m_data, m_size,
+                pattern == access::sequential ? MADV_SEQUENTIAL
+                : pattern == access::random   ? MADV_RANDOM
+                                              : MADV_NORMAL);
+    }
+#else
+    (void)pattern;
+#endif
+  }
+
+  /// @brief starts reading `[offset, offset + count)` in the background, so a
+  /// later touch does not wait on the disk
+  auto prefetch(const std::size_t offset, const std::size_t count) const
+      noexcept -> void {
+#if KRAKEN_HAS_MMAP
+    if (is_open() && offset < m_size) {
+      const auto [first, bytes] = page_range(offset, count);
+      ::madvise(m_data + first, bytes, MADV_WILLNEED);
+    }
+#else
+    (void)offset;
+    (void)count;
+#endif
+  }
+
+  /// @brief lets the kernel drop the pages of `[offset, offset + count)` from
+  /// this process, they are read again from the file on the next touch (a
+  /// `read_write` mapping keeps its writes, a `copy_on_write` one would lose
+  /// them and is left alone)
+  auto evict(const std::size_t offset, const std::size_t count) const noexcept
+      -> void {
+#if KRAKEN_HAS_MMAP
+    if (is_open() && offset < m_size && m_mode != mapping::copy_on_write) {
+      const auto [first, bytes] = page_range(offset, count);
+      ::madvise(m_data + first, bytes, MADV_DONTNEED);
+    }
+#else
+    (void)offset;
+    (void)count;
+#endif
+  }
+
+  /// @brief starts writing the dirty pages of `[offset, offset + count)` of a
+  /// `read_write` mapping back to the file, without waiting for the disk
+  auto write_back(const std::size_t offset, const std::size_t count) const
+      noexcept -> void {
+#if KRAKEN_HAS_MMAP
+    if (is_open() && offset < m_size && m_mode == mapping::read_write) {
+      const auto [first, bytes] = page_range(offset, count);
+      ::msync(m_data + first, bytes, MS_ASYNC);
+    }
+#else
+    (void)offset;
+    (void)count;
+#endif
+  }
+
+  /// @brief writes the dirty pages of a `read_write` mapping back to the file
+  /// @return false if the write failed
+  auto flush() const noexcept -> bool {
+#if KRAKEN_HAS_MMAP
+    if (is_open() && m_mode == mapping::read_write) {
+      return ::msync(m_data, m_size, MS_SYNC) == 0;
+    }
+#endif
+    return true;
+  }
+
+private:
+#if KRAKEN_HAS_MMAP
+  auto map(const int fd, const std::size_t size) noexcept -> void {
+    const int prot{m_mode == mapping::read_only ? PROT_READ
+                                                : PROT_READ | PROT_WRITE};
+    const int flags{m_mode == mapping::copy_on_write ? MAP_PRIVATE
+                                                     : MAP_SHARED};
+    void *addr{::mmap(nullptr, size, prot, flags, fd, 0)};
+    if (addr != MAP_FAILED) {
+      m_data = static_cast<std::byte *>(addr);
+      m_size = size;
+    }
+  }
+
+  /// @brief `madvise` wants a page-aligned start, the range is widened to
+  /// whole pages and clipped to the mapping
+  [[nodiscard]] auto page_range(const std::size_t offset,
+                                const std::size_t count) const noexcept
+      -> std::pair<std::size_t, std::size_t> {
+    const auto page{static_cast<std::size_t>(::sysconf(_SC_PAGESIZE))};
+    const std::size_t first{(offset / page) * page};
+    const std::size_t last{
+        count > m_size - offset ? m_size : offset + count};
+    return {first, last - first};
+  }
+#endif
+
+  auto unmap() noexcept -> void {
+#if KRAKEN_HAS_MMAP
+    if (m_data != nullptr) {
+      ::munmap(m_data, m_size);
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0UL;
+  }
+}; // end of class mapped_file
+} // namespace detail
+} // namespace kraken
+
+#endif // MAPPED_FILE_HPP
@@ -0,0 +1,153 @@
+#ifndef PACKED_HPP
+#define PACKED_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "level1.hpp"  // dot, axpy, scal
+#include <cstddef>     // std::size_t
+#include <type_traits> // std::is_same_v
+
+/// @brief the part of an `n x n` matrix a packed buffer keeps, row by row
+namespace kraken::packed {
+
+/// @brief `a(i, j)` with `j >= i`, row `i` holds `n - i` elements
+struct upper {};
+/// @brief `a(i, j)` with `j <= i`, row `i` holds `i + 1` elements
+struct lower {};
+/// @brief `a(i, j) == a(j, i)`, stored as its upper triangle
+struct symmetric {};
+
+template <class Shape>
+concept shape = std::is_same_v<Shape, upper> || std::is_same_v<Shape, lower> ||
+                std::is_same_v<Shape, symmetric>;
+
+/// @brief elements kept for an `n x n` matrix
+[[nodiscard]] constexpr auto size(const std::size_t n) noexcept
+    -> std::size_t {
+  return (n * (n + 1UL)) / 2UL;
+}
+
+/// @brief position of the first kept element of row `i`, that is `a(i, i)`
+/// for `upper` and `a(i, 0)` for `lower`
+template <shape Shape>
+[[nodiscard]] constexpr auto row_offset(const std::size_t n,
+                                        const std::size_t i) noexcept
+    -> std::size_t {
+  if constexpr (std::is_same_v<Shape, lower>) {
+    return (i * (i + 1UL)) / 2UL;
+  } else {
+    return (i * ((2UL * n) - i + 1UL)) / 2UL;
+  }
+}
+
+/// @brief position of `a(i, j)`, which must be kept
+template <shape Shape>
+[[nodiscard]] constexpr auto offset(const std::size_t n, const std::size_t i,
+                                    const std::size_t j) noexcept
+    -> std::size_t {
+  if constexpr (std::is_same_v<Shape, lower>) {
+    return row_offset<Shape>(n, i) + j;
+  } else {
+    return row_offset<Shape>(n, i) + (j - i);
+  }
+}
+} // namespace kraken::packed
+
+/// @brief level-2 kernels on packed buffers (`tpmv`, `tpsv`, `spmv` in blas
+/// terms), every row of the packing is contiguous so the inner loops are the
+/// vectorized level-1 `dot` and `axpy`
+namespace kraken::blas {
+
+/// @brief `x = A * x` with `A` a packed triangle
+template <kraken::packed::shape Shape, class Ty>
+requires(!std::is_same_v<Shape, kraken::packed::symmetric>) auto tpmv(
+    const std::size_t n, const Ty *ap, Ty *x, const std::size_t incx) noexcept
+    -> void {
+  if constexpr (std::is_same_v<Shape, kraken::packed::upper>) {
+    // row `i` reads `x[i..n)`, ascending rows never read what they wrote
+    for (std::size_t i{}; i < n; ++i) {
+      const Ty *const row{ap + kraken::packed::row_offset<Shape>(n, i)};
+      x[i * incx] = dot(n - i, row, 1UL, x + (i * incx), incx);
+    }
+  } else {
+    // row `i` reads `x[0..i]`, so the rows go from the last one up
+    for (std::size_t i{n}; i-- > 0UL;) {
+      const Ty *const row{ap + kraken::packed::row_offset<Shape>(n, i)};
+      x[i * incx] = dot(i + 1UL, row, 1UL, x, incx);
+    }
+  }
+}
+
+/// @brief solves `A * x = b` in place (`x` holds `b` on entry) with `A` a
+/// packed triangle, backward substitution for `upper`, forward for `lower`
+template <kraken::packed::shape Shape, class Ty>
+requires(!std::is_same_v<Shape, kraken::packed::symmetric>) auto tpsv(
+    const std::size_t n, const Ty *ap, Ty *x, const std::size_t incx) noexcept
+    -> void {
+  if constexpr (std::is_same_v<Shape, kraken::packed::upper>) {
+    for (std::size_t i{n}; i-- > 0UL;) {
+      const Ty *const row{ap + kraken::packed::row_offset<Shape>(n, i)};
+      const Ty rest{
+          dot(n - i - 1UL, row + 1, 1UL, x + ((i + 1UL) * incx), incx)};
+      x[i * incx] = static_cast<Ty>((x[i * incx] - rest) / row[0]);
+    }
+  } else {
+    for (std::size_t i{}; i < n; ++i) {
+      const Ty *const row{ap + kraken::packed::row_offset<Shape>(n, i)};
+      const Ty rest{dot(i, row, 1UL, x, incx)};
+      x[i * incx] = static_cast<Ty>((x[i * incx] - rest) / row[i]);
+    }
+  }
+}
+
+/// @brief `y = alpha * A * x + beta * y` with `A` symmetric and packed as its
+/// upper triangle, row `i` gives `y[i]` a `dot` and the rows below an `axpy`
+template <class Ty>
+auto spmv(const std::size_t n, const Ty alpha, const Ty *ap, const Ty *x,
+          const std::size_t incx, const Ty beta, Ty *y,
+          const std::size_t incy) noexcept -> void {
+  if (beta == Ty{}) {
+    for (std::size_t i{}; i < n; ++i) {
+      y[i * incy] = Ty{};
+    }
+  } else {
+    scal(n, beta, y, incy);
+  }
+  for (std::size_t i{}; i < n; ++i) {
+    const Ty *const row{
+        ap + kraken::packed::row_offset<kraken::packed::upper>(n, i)};
+    const Ty ax{static_cast<Ty>(alpha * x[i * incx])};
+    const Ty rest{
+        dot(n - i - 1UL, row + 1, 1UL, x + ((i + 1UL) * incx), incx)};
+    y[i * incy] =
+        static_cast<Ty>(y[i * incy] + (ax * row[0]) + (alpha * rest));
+    axpy(n - i - 1UL, ax, row + 1, 1UL, y + ((i + 1UL) * incy), incy);
+  }
+}
+} // namespace kraken::blas
+
+#endif // PACKED_HPP
@@ -0,0 +1,139 @@
+#ifndef PERMUTE_HPP
+#define PERMUTE_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "level1.hpp" // detail::simd
+#include <algorithm>  // std::copy_n
+#include <cassert>    // assert
+#include <cstddef>    // std::size_t
+#include <vector>     // std::vector
+
+/// @brief bulk row and column permutations of a row-major `rows x cols`
+/// matrix whose rows are `ld` apart. a permutation gathers: row (column) `i`
+/// of the result is row (column) `perm[i]` of the input, like the `P * A`
+/// (`A * P^T`) of a pivoted factorization
+namespace kraken::blas {
+
+namespace detail {
+
+/// @brief `dst[j] = src[idx[j]]`, `float` and `double` gather straight into
+/// vector registers when the target has them
+template <class Ty>
+auto gather(const std::size_t n, const Ty *src, const std::size_t *idx,
+            Ty *dst) noexcept -> void {
+  std::size_t j{};
+  if constexpr (simd<Ty>::enabled) {
+    using v = simd<Ty>;
+    for (; j + v::lanes <= n; j += v::lanes) {
+      v::store(dst + j, v::gather(src, idx + j));
+    }
+  }
+  for (std::size_t k{n - j}; k > 0UL; --k, ++j) {
+    dst[j] = src[idx[j]];
+  }
+}
+} // namespace detail
+
+/// @brief true when `perm` holds every index of `[0, n)` exactly once
+[[nodiscard]] inline auto is_permutation(const std::size_t n,
+                                         const std::size_t *perm) -> bool {
+  std::vector<bool> seen(n, false);
+  for (std::size_t i{}; i < n; ++i) {
+    if (perm[i] >= n || seen[perm[i]]) {
+      return false;
+    }
+    seen[perm[i]] = true;
+  }
+  return true;
+}
+
+/// @brief in-place row permutation: the cycles of `perm` are followed, every
+/// row moves once as a whole (one `memcpy`) and only the first row of each
+/// cycle goes through a one-row buffer
+template <class Ty>
+auto permute_rows(const std::size_t rows, const std::size_t cols,
+                  const std::size_t *perm, Ty *a, const std::size_t lda)
+    -> void {
+  assert(is_permutation(rows, perm) && "- not a permutation");
+  std::vector<bool> visited(rows, false);
+  std::vector<Ty> carried(cols);
+  for (std::size_t start{}; start < rows; ++start) {
+    if (visited[start] || perm[start] == start) {
+      continue;
+    }
+    std::copy_n(a + (start * lda), cols, carried.data());
+    std::size_t at{start};
+    while (perm[at] != start) {
+      visited[at] = true;
+      std::copy_n(a + (perm[at] * lda), cols, a + (at * lda));
+      at = perm[at];
+    }
+    visited[at] = true;
+    std::copy_n(carried.data(), cols, a + (at * lda));
+  }
+}
+
+/// @brief out-of-place row permutation `b = P * a`, one `memcpy` per row
+template <class Ty>
+auto permute_rows(const std::size_t rows, const std::size_t cols,
+                  const std::size_t *perm, const Ty *a, const std::size_t lda,
+                  Ty *b, const std::size_t ldb) noexcept -> void {
+  assert(is_permutation(rows, perm) && "- not a permutation");
+  for (std::size_t i{}; i < rows; ++i) {
+    std::copy_n(a + (perm[i] * lda), cols, b + (i * ldb));
+  }
+}
+
+/// @brief in-place column permutation, each row is copied into a one-row
+/// buffer and gathered back, so the matrix is read and written row by row
+/// whatever the permutation
+template <class Ty>
+auto permute_cols(const std::size_t rows, const std::size_t cols,
+                  const std::size_t *perm, Ty *a, const std::size_t lda)
+    -> void {
+  assert(is_permutation(cols, perm) && "- not a permutation");
+  std::vector<Ty> row(cols);
+  for (std::size_t i{}; i < rows; ++i) {
+    std::copy_n(a + (i * lda), cols, row.data());
+    detail::gather(cols, row.data(), perm, a + (i * lda));
+  }
+}
+
+/// @brief out-of-place column permutation `b = a * P^T`, a gather per row
+template <class Ty>
+auto permute_cols(const std::size_t rows, const std::size_t cols,
+                  const std::size_t *perm, const Ty *a, const std::size_t lda,
+                  Ty *b, const std::size_t ldb) noexcept -> void {
+  assert(is_permutation(cols, perm) && "- not a permutation");
+  for (std::size_t i{}; i < rows; ++i) {
+    detail::gather(cols, a + (i * lda), perm, b + (i * ldb));
+  }
+}
+} // namespace kraken::blas
+
+#endif // PERMUTE_HPP
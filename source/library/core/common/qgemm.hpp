@@ -0,0 +1,468 @@
+#ifndef QGEMM_HPP
+#define QGEMM_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "aligned_buffer.hpp"
+#include "thread_pool.hpp"
+#include <algorithm> // std::min, std::max
+#include <concepts>  // std::same_as
+#include <cstddef>   // std::size_t
+#include <cstdint>   // std::int8_t, std::uint8_t, std::int16_t, std::int32_t
+#include <cstring>   // std::memcpy
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+/// @brief quantized matrix-matrix product: 8 or 16-bit integer operands,
+/// 32-bit integer accumulation, and an optional dequantized `float` output
+/// with one scale per row of `A` and one per column of `B`
+namespace kraken::blas {
+
+/// @brief element types `qgemm` takes
+template <class Ty>
+concept quantized = std::same_as<Ty, std::int8_t> ||
+                    std::same_as<Ty, std::uint8_t> ||
+                    std::same_as<Ty, std::int16_t>;
+
+namespace detail {
+
+/// @brief a vector of `int32` accumulators and the integer dot-product steps,
+/// `enabled` is false when the target has none
+/// - `dot4(acc, a, b)` adds four `uint8 * int8` products to every lane
+///   (`vpdpbusd`), `quad` is false when the target does not have it
+/// - `dot2(acc, a, b)` adds two `int16 * int16` products to every lane
+///   (`vpdpwssd`, or `vpmaddwd` + `vpaddd` without VNNI)
+#if defined(__AVX512BW__)
+struct qvec {
+  static constexpr bool enabled{true};
+#if defined(__AVX512VNNI__)
+  static constexpr bool quad{true};
+#else
+  static constexpr bool quad{false};
+#endif
+  static constexpr std::size_t lanes{16UL};
+  using type = __m512i;
+  static auto zero() noexcept -> type { return _mm512_setzero_si512(); }
+  static auto set(const std::int32_t v) noexcept -> type {
+    return _mm512_set1_epi32(v);
+  }
+  static auto load(const std::int32_t *p) noexcept -> type {
+    return _mm512_loadu_si512(p);
+  }
+  static auto store(std::int32_t *p, const type v) noexcept -> void {
+    _mm512_storeu_si512(p, v);
+  }
+#if defined(__AVX512VNNI__)
+  static auto dot4(const type acc, const type a, const type b) noexcept
+      -> type {
+    return _mm512_dpbusd_epi32(acc, a, b);
+  }
+  static auto dot2(const type acc, const type a, const type b) noexcept
+      -> type {
+    return _mm512_dpwssd_epi32(acc, a, b);
+  }
+#else
+  static auto dot2(const type acc, const type a, const type b) noexcept
+      -> type {
+    return _mm512_add_epi32(acc, _mm512_madd_epi16(a, b));
+  }
+#endif
+};
+#elif defined(__AVX2__)
+struct qvec {
+  static constexpr bool enabled{true};
+#if defined(__AVXVNNI__) || (defined(__AVX512VNNI__) && defined(__AVX512VL__))
+  static constexpr bool quad{true};
+#else
+  static constexpr bool quad{false};
+#endif
+  static constexpr std::size_t lanes{8UL};
+  using type = __m256i;
+  static auto zero() noexcept -> type { return _mm256_setzero_si256(); }
+  static auto set(const std::int32_t v) noexcept -> type {
+    return _mm256_set1_epi32(v);
+  }
+  static auto load(const std::int32_t *p) noexcept -> type {
+    return _mm256_loadu_si256(reinterpret_cast<const type *>(p));
+  }
+  static auto store(std::int32_t *p, const type v) noexcept -> void {
+    _mm256_storeu_si256(reinterpret_cast<type *>(p), v);
+  }
+#if defined(__AVX512VNNI__) && defined(__AVX512VL__)
+  static auto dot4(const type acc, const type a, const type b) noexcept
+      -> type {
+    return _mm256_dpbusd_epi32(acc, a, b);
+  }
+  static auto dot2(const type acc, const type a, const type b) noexcept
+      -> type {
+    return _mm256_dpwssd_epi32(acc, a, b);
+  }
+#elif defined(__AVXVNNI__)
+  static auto dot4(const type acc, const type a, const type b) noexcept
+      -> type {
+    return _mm256_dpbusd_avx_epi32(acc, a, b);
+  }
+  static auto dot2(const type acc, const type a, const type b) noexcept
+      -> type {
+    return _mm256_dpwssd_avx_epi32(acc, a, b);
+  }
+#else
+  static auto dot2(const type acc, const type a, const type b) noexcept
+      -> type {
+    return _mm256_add_epi32(acc, _mm256_madd_epi16(a, b));
+  }
+#endif
+};
+#else
+struct qvec {
+  static constexpr bool enabled{false};
+  static constexpr bool quad{false};
+  static constexpr std::size_t lanes{1UL};
+};
+#endif
+
+/// @brief how two operand types are packed for the micro-kernel
+/// both operands are stored as 32-bit words that hold `group` consecutive
+/// elements along `k`: four bytes for `dot4` when both are 8-bit and the
+/// target has VNNI, otherwise two `int16` for `dot2`. `dot4` wants an unsigned
+/// `A` and a signed `B`, so an `int8` `A` is shifted by `+128` and a `uint8`
+/// `B` by `-128`, the shifts are taken out again in the epilogue
+template <quantized TA, quantized TB> struct qpacking {
+  using simd = qvec;
+  static constexpr bool quad{qvec::quad && sizeof(TA) == 1UL &&
+                             sizeof(TB) == 1UL};
+  static constexpr std::size_t group{quad ? 4UL : 2UL};
+  static constexpr std::int32_t shift_a{
+      quad && std::same_as<TA, std::int8_t> ? 128 : 0};
+  static constexpr std::int32_t shift_b{
+      quad && std::same_as<TB, std::uint8_t> ? -128 : 0};
+  /// `MR * 2` accumulators, the 32 registers of AVX-512 fit a taller tile
+  static constexpr std::size_t MR{qvec::lanes == 16UL ? 8UL : 6UL};
+  static constexpr std::size_t NR{2UL * qvec::lanes};
+  /// rows of `C` per task
+  static constexpr std::size_t MC{MR * 16UL};
+  /// bytes of a packed panel of `B`, about the size of L2
+  static constexpr std::size_t panel_bytes{1UL << 19};
+  /// products smaller than this (m * n * k) skip packing
+  static constexpr std::size_t small{16UL * 16UL * 16UL};
+};
+
+/// @brief stores `group` elements as one 32-bit word, shifted by `shift`
+/// and narrowed to a byte for `dot4` or widened to an `int16` for `dot2`
+template <std::size_t group, class Ty>
+[[nodiscard]] auto qword(const Ty *src, const std::size_t count,
+                         const std::size_t inc, const std::int32_t shift)
+    -> std::int32_t {
+  std::int32_t word{};
+  if constexpr (group == 4UL) {
+    unsigned char bytes[4]{};
+    for (std::size_t t{}; t < count; ++t) {
+      bytes[t] = static_cast<unsigned char>(
+          static_cast<std::int32_t>(src[t * inc]) + shift);
+    }
+    std::memcpy(&word, bytes, sizeof(word));
+  } else {
+    std::int16_t halves[2]{};
+    for (std::size_t t{}; t < count; ++t) {
+      halves[t] = static_cast<std::int16_t>(src[t * inc]);
+    }
+    std::memcpy(&word, halves, sizeof(word));
+  }
+  return word;
+}
+
+/// @brief packs `MR` rows of `A` (the last panel may be short) into words
+/// along `k`, column by column, and adds up each row
+template <class P, class TA>
+auto qpack_a(const std::size_t mr, const std::size_t k, const TA *a,
+             const std::size_t lda, std::int32_t *packed, std::int32_t *sums)
+    -> void {
+  for (std::size_t i{}; i < P::MR; ++i) {
+    std::int32_t sum{};
+    for (std::size_t p{}; i < mr && p < k; ++p) {
+      sum += a[(i * lda) + p];
+    }
+    sums[i] = sum;
+  }
+  for (std::size_t p{}; p < k; p += P::group) {
+    const std::size_t count{std::min(P::group, k - p)};
+    for (std::size_t i{}; i < P::MR; ++i) {
+      *packed++ = i < mr ? qword<P::group>(a + (i * lda) + p, count, 1UL,
+                                           P::shift_a)
+                         : 0;
+    }
+  }
+}
+
+/// @brief packs `nc` columns of `B` into column-panels of width `NR`, each
+/// panel holds one word per column and `group` rows, and adds up each column
+template <class P, class TB>
+auto qpack_b(const std::size_t nc, const std::size_t k, const TB *b,
+             const std::size_t ldb, std::int32_t *packed, std::int32_t *sums)
+    -> void {
+  for (std::size_t j{}; j < nc; ++j) {
+    std::int32_t sum{};
+    for (std::size_t p{}; p < k; ++p) {
+      sum += b[(p * ldb) + j];
+    }
+    sums[j] = sum;
+  }
+  for (std::size_t jr{}; jr < nc; jr += P::NR) {
+    const std::size_t nr{std::min(P::NR, nc - jr)};
+    for (std::size_t p{}; p < k; p += P::group) {
+      const std::size_t count{std::min(P::group, k - p)};
+      for (std::size_t j{}; j < P::NR; ++j) {
+        *packed++ = j < nr ? qword<P::group>(b + (p * ldb) + jr + j, count,
+                                             ldb, P::shift_b)
+                           : 0;
+      }
+    }
+  }
+}
+
+/// @brief `tile = A_panel * B_panel` over `words` steps of `k`, the `MR x NR`
+/// tile lives in `MR * 2` vector registers
+template <class P>
+auto qmicro_kernel(const std::size_t words, const std::int32_t *__restrict a,
+                   const std::int32_t *__restrict b,
+                   std::int32_t (&tile)[P::MR][P::NR]) -> void {
+  using V = typename P::simd;
+  typename V::type acc[P::MR][2];
+  for (std::size_t i{}; i < P::MR; ++i) {
+    acc[i][0] = V::zero();
+    acc[i][1] = V::zero();
+  }
+  for (std::size_t p{}; p < words; ++p) {
+    const auto b_lo{V::load(b)};
+    const auto b_hi{V::load(b + V::lanes)};
+    for (std::size_t i{}; i < P::MR; ++i) {
+      const auto a_i{V::set(a[i])};
+      if constexpr (P::quad) {
+        acc[i][0] = V::dot4(acc[i][0], a_i, b_lo);
+        acc[i][1] = V::dot4(acc[i][1], a_i, b_hi);
+      } else {
+        acc[i][0] = V::dot2(acc[i][0], a_i, b_lo);
+        acc[i][1] = V::dot2(acc[i][1], a_i, b_hi);
+      }
+    }
+    a += P::MR;
+    b += P::NR;
+  }
+  for (std::size_t i{}; i < P::MR; ++i) {
+    V::store(tile[i], acc[i][0]);
+    V::store(tile[i] + V::lanes, acc[i][1]);
+  }
+}
+
+/// @brief plain i-k-j loop for products too small to amortize packing (or
+/// targets without integer vectors), one row of `int32` sums at a time
+template <quantized TA, quantized TB, class Out>
+auto qgemm_small(const std::size_t m, const std::size_t n, const std::size_t k,
+                 const TA *a, const std::size_t lda, const TB *b,
+                 const std::size_t ldb, const Out &out) -> void {
+  kraken::detail::aligned_buffer<std::int32_t> row(n);
+  kraken::detail::aligned_buffer<std::int32_t> col_sum(n);
+  std::fill_n(col_sum.data(), n, 0);
+  for (std::size_t p{}; p < k; ++p) {
+    for (std::size_t j{}; j < n; ++j) {
+      col_sum.data()[j] += b[(p * ldb) + j];
+    }
+  }
+  for (std::size_t i{}; i < m; ++i) {
+    std::fill_n(row.data(), n, 0);
+    std::int32_t row_sum{};
+    for (std::size_t p{}; p < k; ++p) {
+      const std::int32_t a_ip{a[(i * lda) + p]};
+      row_sum += a_ip;
+      for (std::size_t j{}; j < n; ++j) {
+        row.data()[j] += a_ip * b[(p * ldb) + j];
+      }
+    }
+    out(i, 0UL, n, row.data(), row_sum, col_sum.data());
+  }
+}
+
+/// @brief packed product, `C` is cut into `MC x nc` tiles shared between up
+/// to `threads` threads, every tile packs its panel of `B` (`k x nc`) once
+/// and streams `MR` rows of `A` through it
+template <quantized TA, quantized TB, class Out>
+auto qgemm_packed(const std::size_t m, const std::size_t n,
+                  const std::size_t k, const TA *a, const std::size_t lda,
+                  const TB *b, const std::size_t ldb, const Out &out,
+                  const std::size_t threads) -> void {
+  using P = qpacking<TA, TB>;
+  const std::size_t words{(k + P::group - 1UL) / P::group};
+  // `B` is cut into panels of `nc` columns that fit the budget
+  const std::size_t nc{std::max(
+      P::NR, (P::panel_bytes / (words * sizeof(std::int32_t) * P::NR)) *
+                 P::NR)};
+  const std::size_t tiles_m{(m + P::MC - 1UL) / P::MC};
+  const std::size_t tiles_n{(n + nc - 1UL) / nc};
+  // the packed `uint8`/`int8` words add `shift * sum` to every product
+  constexpr std::int64_t shifts{std::int64_t{P::shift_a} * P::shift_b};
+  auto task = [&](const std::size_t first_tile, const std::size_t last_tile) {
+    kraken::detail::aligned_buffer<std::int32_t> packed_b(
+        ((std::min(nc, n) + P::NR - 1UL) / P::NR) * P::NR * words);
+    kraken::detail::aligned_buffer<std::int32_t> col_sum(nc);
+    kraken::detail::aligned_buffer<std::int32_t> packed_a(P::MR * words);
+    std::int32_t row_sum[P::MR];
+    std::int32_t tile[P::MR][P::NR];
+    std::size_t packed_jc{n};
+    for (std::size_t t{first_tile}; t < last_tile; ++t) {
+      // tiles walk down a column of `C` first so a panel of `B` is reused
+      const std::size_t ic{(t % tiles_m) * P::MC};
+      const std::size_t jc{(t / tiles_m) * nc};
+      const std::size_t mc{std::min(P::MC, m - ic)};
+      const std::size_t ncb{std::min(nc, n - jc)};
+      if (jc != packed_jc) {
+        qpack_b<P>(ncb, k, b + jc, ldb, packed_b.data(), col_sum.data());
+        packed_jc = jc;
+      }
+      for (std::size_t ir{}; ir < mc; ir += P::MR) {
+        const std::size_t mr{std::min(P::MR, mc - ir)};
+        qpack_a<P>(mr, k, a + ((ic + ir) * lda), lda, packed_a.data(),
+                   row_sum);
+        for (std::size_t jr{}; jr < ncb; jr += P::NR) {
+          qmicro_kernel<P>(words, packed_a.data(),
+                           packed_b.data() + (jr * words), tile);
+          const std::size_t nr{std::min(P::NR, ncb - jr)};
+          for (std::size_t i{}; i < mr; ++i) {
+            if constexpr (P::shift_a != 0 || P::shift_b != 0) {
+              const std::int64_t shift_i{(std::int64_t{P::shift_b} *
+                                          row_sum[i]) +
+                                         (static_cast<std::int64_t>(k) *
+                                          shifts)};
+              for (std::size_t j{}; j < nr; ++j) {
+                tile[i][j] = static_cast<std::int32_t>(
+                    tile[i][j] - shift_i -
+                    (std::int64_t{P::shift_a} * col_sum.data()[jr + j]));
+              }
+            }
+            out(ic + ir + i, jc + jr, nr, tile[i], row_sum[i],
+                col_sum.data() + jr);
+          }
+        }
+      }
+    }
+  };
+  auto &pool{kraken::detail::thread_pool::instance()};
+  const std::size_t workers{
+      std::min(threads == 0UL ? pool.concurrency() : threads,
+               tiles_m * tiles_n)};
+  if (workers <= 1UL) {
+    task(0UL, tiles_m * tiles_n);
+    return;
+  }
+  // contiguous runs of tiles, so most tasks pack each panel of `B` once
+  const std::size_t step{(tiles_m * tiles_n + workers - 1UL) / workers};
+  pool.parallel_for(workers, workers, [&](const std::size_t w) {
+    task(std::min(w * step, tiles_m * tiles_n),
+         std::min((w + 1UL) * step, tiles_m * tiles_n));
+  });
+}
+
+/// @brief `out(i, j, count, sums, row_sum, col_sums)` for every row segment
+/// of `C`, `sums[t]` is `sum_p a(i, p) * b(p, j + t)`, `row_sum` the sum of
+/// row `i` of `A` and `col_sums[t]` that of column `j + t` of `B`. `A` is
+/// `m x k` and `B` is `k x n`, both row-major, the sums are exact in `int32`
+/// while `k * max|a| * max|b| < 2^31`
+template <quantized TA, quantized TB, class Out>
+auto qgemm_driver(const std::size_t m, const std::size_t n,
+                  const std::size_t k, const TA *a, const std::size_t lda,
+                  const TB *b, const std::size_t ldb, const Out &out,
+                  const std::size_t threads) -> void {
+  if (m == 0UL || n == 0UL) {
+    return;
+  }
+  if constexpr (qvec::enabled) {
+    if (m * n * k >= qpacking<TA, TB>::small) {
+      qgemm_packed(m, n, k, a, lda, b, ldb, out, threads);
+      return;
+    }
+  }
+  qgemm_small(m, n, k, a, lda, b, ldb, out);
+}
+} // namespace detail
+
+/// @brief integer product `C = A * B` with `int32` accumulation, exact while
+/// `k * max|a| * max|b| < 2^31`
+/// @param m rows of `A` and `C`
+/// @param n columns of `B` and `C`
+/// @param k columns of `A` and rows of `B`
+/// @param lda, ldb, ldc distance (in elements) between two rows
+/// @param threads `0` means every hardware thread
+template <quantized TA, quantized TB>
+auto qgemm(const std::size_t m, const std::size_t n, const std::size_t k,
+           const TA *a, const std::size_t lda, const TB *b,
+           const std::size_t ldb, std::int32_t *c, const std::size_t ldc,
+           const std::size_t threads = 1UL) -> void {
+  detail::qgemm_driver(
+      m, n, k, a, lda, b, ldb,
+      [c, ldc](const std::size_t i, const std::size_t j,
+               const std::size_t count, const std::int32_t *sums,
+               std::int32_t, const std::int32_t *) {
+        std::copy_n(sums, count, c + (i * ldc) + j);
+      },
+      threads);
+}
+
+/// @brief quantized product with a dequantized output, `A` holds
+/// `a_scale[i] * (a(i, p) - a_zero)` and `B` `b_scale[j] * (b(p, j) -
+/// b_zero)`, so `C(i, j) = a_scale[i] * b_scale[j] * sum_p (a(i, p) - a_zero)
+/// * (b(p, j) - b_zero)`. the sum is taken in `int32`, the zero points are
+/// folded in afterwards from the row sums of `A` and the column sums of `B`
+/// @param a_scale one scale per row of `A` (per token / per tensor)
+/// @param b_scale one scale per column of `B` (per output channel)
+/// @param threads `0` means every hardware thread
+template <quantized TA, quantized TB>
+auto qgemm(const std::size_t m, const std::size_t n, const std::size_t k,
+           const TA *a, const std::size_t lda, const std::int32_t a_zero,
+           const float *a_scale, const TB *b, const std::size_t ldb,
+           const std::int32_t b_zero, const float *b_scale, float *c,
+           const std::size_t ldc, const std::size_t threads = 1UL) -> void {
+  const std::int64_t zeros{static_cast<std::int64_t>(k) * a_zero * b_zero};
+  detail::qgemm_driver(
+      m, n, k, a, lda, b, ldb,
+      [&](const std::size_t i, const std::size_t j, const std::size_t count,
+          const std::int32_t *sums, const std::int32_t row_sum,
+          const std::int32_t *col_sums) {
+        const std::int64_t row_i{zeros - (std::int64_t{b_zero} * row_sum)};
+        float *c_i{c + (i * ldc) + j};
+        const float *scale_j{b_scale + j};
+        for (std::size_t t{}; t < count; ++t) {
+          const std::int64_t centered{row_i + sums[t] -
+                                      (std::int64_t{a_zero} * col_sums[t])};
+          c_i[t] = a_scale[i] * scale_j[t] * static_cast<float>(centered);
+        }
+      },
+      threads);
+}
+} // namespace kraken::blas
+
+#endif // QGEMM_HPP
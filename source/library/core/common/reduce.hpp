@@ -0,0 +1,302 @@
+#ifndef REDUCE_HPP
+#define REDUCE_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "level1.hpp"      // detail::simd
+#include "thread_pool.hpp" // kraken::detail::thread_pool
+#include <algorithm>       // std::min, std::max, std::copy_n
+#include <cassert>         // assert
+#include <cstddef>         // std::size_t
+#include <type_traits>     // std::is_same_v, std::is_integral_v
+#include <vector>          // std::vector
+
+/// @brief axis-wise reductions of a `rows x cols` matrix whose element
+/// `(i, j)` is at `a[i * rs + j * cs]`: one result per row (`reduce_rows`) or
+/// per column (`reduce_cols`). along the contiguous axis the elements are
+/// folded in vector registers, across it the lines are streamed in memory
+/// order into a band of accumulators that stays in L1, so the column sums of
+/// a row-major matrix never walk down a column
+namespace kraken::blas {
+
+/// @brief what `reduce_rows` and `reduce_cols` compute, `mean` is the sum
+/// divided by the count (truncated for integers). an integer `sum` wraps like
+/// any arithmetic in the element type, the sum behind a `mean` is taken in 64
+/// bits so the mean of narrow integers is exact
+enum class reduction { sum, min, max, mean };
+
+namespace detail {
+
+/// @brief elements of one band of accumulators, 16 KiB (half an L1)
+template <class Ty>
+inline constexpr std::size_t reduce_band{
+    std::max(16384UL / sizeof(Ty), 1UL)};
+
+/// @brief fewest elements a reduction hands to a thread
+inline constexpr std::size_t reduce_grain{1UL << 15U};
+
+/// @brief what the sum behind the `mean` of `Ty` is taken in
+template <class Ty>
+using mean_t = std::conditional_t<
+    std::is_integral_v<Ty>,
+    std::conditional_t<std::is_signed_v<Ty>, long long, unsigned long long>,
+    Ty>;
+
+template <reduction Op, class Ty>
+[[nodiscard]] constexpr auto fold(const Ty x, const Ty y) noexcept -> Ty {
+  if constexpr (Op == reduction::min) {
+    return y < x ? y : x;
+  } else if constexpr (Op == reduction::max) {
+    return x < y ? y : x;
+  } else {
+    return static_cast<Ty>(x + y);
+  }
+}
+
+template <reduction Op, class V>
+[[nodiscard]] auto fold_v(const typename V::type x,
+                          const typename V::type y) noexcept ->
+    typename V::type {
+  if constexpr (Op == reduction::min) {
+    return V::min(x, y);
+  } else if constexpr (Op == reduction::max) {
+    return V::max(x, y);
+  } else {
+    return V::add(x, y);
+  }
+}
+
+/// @brief `Op` over the contiguous `x[0, n)`, `n > 0`, in `Acc`. four
+/// independent vector accumulators hide the latency of the adds, a wider
+/// `Acc` is left to the compiler
+template <reduction Op, class Ty, class Acc = Ty>
+[[nodiscard]] auto reduce_line(const std::size_t n, const Ty *x) noexcept
+    -> Acc {
+  std::size_t i{1};
+  Acc result{x[0]};
+  if constexpr (std::is_same_v<Acc, Ty> && simd<Ty>::enabled) {
+    using v = simd<Ty>;
+    if (n >= 4UL * v::lanes) {
+      auto acc0{v::load(x)};
+      auto acc1{v::load(x + v::lanes)};
+      auto acc2{v::load(x + (2UL * v::lanes))};
+      auto acc3{v::load(x + (3UL * v::lanes))};
+      for (i = 4UL * v::lanes; i + (4UL * v::lanes) <= n;
+           i += 4UL * v::lanes) {
+        acc0 = fold_v<Op, v>(acc0, v::load(x + i));
+        acc1 = fold_v<Op, v>(acc1, v::load(x + i + v::lanes));
+        acc2 = fold_v<Op, v>(acc2, v::load(x + i + (2UL * v::lanes)));
+        acc3 = fold_v<Op, v>(acc3, v::load(x + i + (3UL * v::lanes)));
+      }
+      acc0 = fold_v<Op, v>(fold_v<Op, v>(acc0, acc1),
+                           fold_v<Op, v>(acc2, acc3));
+      for (; i + v::lanes <= n; i += v::lanes) {
+        acc0 = fold_v<Op, v>(acc0, v::load(x + i));
+      }
+      if constexpr (Op == reduction::min) {
+        result = v::hmin(acc0);
+      } else if constexpr (Op == reduction::max) {
+        result = v::hmax(acc0);
+      } else {
+        result = v::sum(acc0);
+      }
+    }
+  }
+  for (std::size_t k{n - i}; k > 0UL; --k, ++i) {
+    result = fold<Op>(result, static_cast<Acc>(x[i]));
+  }
+  return result;
+}
+
+/// @brief `acc[k] = acc[k] Op x[k]` for the contiguous `k < n`
+template <reduction Op, class Ty, class Acc>
+auto fold_into(const std::size_t n, const Ty *x, Acc *acc) noexcept -> void {
+  std::size_t k{};
+  if constexpr (std::is_same_v<Acc, Ty> && simd<Ty>::enabled) {
+    using v = simd<Ty>;
+    for (; k + v::lanes <= n; k += v::lanes) {
+      v::store(acc + k, fold_v<Op, v>(v::load(acc + k), v::load(x + k)));
+    }
+  }
+  for (std::size_t r{n - k}; r > 0UL; --r, ++k) {
+    acc[k] = fold<Op>(acc[k], static_cast<Acc>(x[k]));
+  }
+}
+
+/// @brief `y[l * incy] = Op(line l)` for `lines` contiguous lines of `len`
+/// elements, `ld` apart, the lines are shared between the threads
+template <reduction Op, class Ty, class Acc>
+auto reduce_lines(const std::size_t lines, const std::size_t len,
+                  const Ty *a, const std::size_t ld, Acc *y,
+                  const std::size_t incy, const std::size_t threads) -> void {
+  const std::size_t per{std::max(reduce_grain / len, 1UL)};
+  kraken::detail::thread_pool::instance().parallel_for(
+      (lines + per - 1UL) / per, threads, [&](const std::size_t t) {
+        const std::size_t last{std::min((t + 1UL) * per, lines)};
+        for (std::size_t l{t * per}; l < last; ++l) {
+          y[l * incy] = reduce_line<Op, Ty, Acc>(len, a + (l * ld));
+        }
+      });
+}
+
+/// @brief `y[k * incy] = Op(a[l * ld + k] for every line l)`: the lines are
+/// read in memory order, one band of `reduce_band` columns at a time, into
+/// accumulators that stay in L1. the bands are shared between the threads,
+/// when there are fewer bands than threads the lines are cut into blocks too
+/// and the partial results of the blocks folded at the end
+template <reduction Op, class Ty, class Acc>
+auto reduce_across(const std::size_t lines, const std::size_t len,
+                   const Ty *a, const std::size_t ld, Acc *y,
+                   const std::size_t incy, const std::size_t threads)
+    -> void {
+  auto &pool{kraken::detail::thread_pool::instance()};
+  constexpr std::size_t band{reduce_band<Ty>};
+  const std::size_t bands{(len + band - 1UL) / band};
+  // blocks follow the requested count, `parallel_for` caps it to the pool
+  const std::size_t workers{threads == 0UL ? pool.concurrency() : threads};
+  std::size_t blocks{1UL};
+  if (workers > bands) {
+    blocks = std::min({(workers + bands - 1UL) / bands, lines,
+                       std::max((lines * std::min(len, band)) / reduce_grain,
+                                1UL)});
+  }
+  std::vector<Acc> partial{};
+  Acc *acc{y};
+  if (blocks > 1UL || incy != 1UL) {
+    partial.resize(blocks * len);
+    acc = partial.data();
+  }
+  pool.parallel_for(blocks * bands, workers, [&](const std::size_t t) {
+    const std::size_t block{t / bands};
+    const std::size_t first{(t % bands) * band};
+    const std::size_t width{std::min(band, len - first)};
+    const std::size_t l0{(lines * block) / blocks};
+    const std::size_t l1{(lines * (block + 1UL)) / blocks};
+    Acc *out{acc + (block * len) + first};
+    std::copy_n(a + (l0 * ld) + first, width, out);
+    for (std::size_t l{l0 + 1UL}; l < l1; ++l) {
+      fold_into<Op>(width, a + (l * ld) + first, out);
+    }
+  });
+  for (std::size_t b{1}; b < blocks; ++b) {
+    fold_into<Op>(len, acc + (b * len), acc);
+  }
+  if (acc != y) {
+    for (std::size_t k{}; k < len; ++k) {
+      y[k * incy] = acc[k];
+    }
+  }
+}
+
+/// @brief one `Op` per row: along the rows when they are contiguous, across
+/// the columns when those are, element by element for any other strides
+template <reduction Op, class Ty, class Acc>
+auto reduce_rows(const std::size_t rows, const std::size_t cols, const Ty *a,
+                 const std::size_t rs, const std::size_t cs, Acc *y,
+                 const std::size_t incy, const std::size_t threads) -> void {
+  if (cs == 1UL) {
+    reduce_lines<Op>(rows, cols, a, rs, y, incy, threads);
+  } else if (rs == 1UL) {
+    reduce_across<Op>(cols, rows, a, cs, y, incy, threads);
+  } else {
+    for (std::size_t i{}; i < rows; ++i) {
+      Acc result{a[i * rs]};
+      for (std::size_t j{1}; j < cols; ++j) {
+        result = fold<Op>(result, static_cast<Acc>(a[(i * rs) + (j * cs)]));
+      }
+      y[i * incy] = result;
+    }
+  }
+}
+} // namespace detail
+
+/// @brief `y[i * incy] = op(row i)` for every row of the `rows x cols` matrix
+/// `a`, `(i, j)` at `a[i * rs + j * cs]`
+/// @param threads `0` means every hardware thread
+template <class Ty>
+auto reduce_rows(const reduction op, const std::size_t rows,
+                 const std::size_t cols, const Ty *a, const std::size_t rs,
+                 const std::size_t cs, Ty *y, const std::size_t incy,
+                 const std::size_t threads = 1UL) -> void {
+  if (rows == 0UL) {
+    return;
+  }
+  if (cols == 0UL) {
+    assert(op == reduction::sum && "- no min, max or mean of nothing");
+    for (std::size_t i{}; i < rows; ++i) {
+      y[i * incy] = Ty{};
+    }
+    return;
+  }
+  switch (op) {
+  case reduction::min:
+    detail::reduce_rows<reduction::min>(rows, cols, a, rs, cs, y, incy,
+                                        threads);
+    return;
+  case reduction::max:
+    detail::reduce_rows<reduction::max>(rows, cols, a, rs, cs, y, incy,
+                                        threads);
+    return;
+  case reduction::sum:
+    detail::reduce_rows<reduction::sum>(rows, cols, a, rs, cs, y, incy,
+                                        threads);
+    return;
+  default:
+    break;
+  }
+  // the count need not fit in `Ty` (256 columns of `std::uint8_t`), the sum
+  // and the division are done in `mean_t`
+  using wide = detail::mean_t<Ty>;
+  if constexpr (std::is_same_v<wide, Ty>) {
+    detail::reduce_rows<reduction::sum>(rows, cols, a, rs, cs, y, incy,
+                                        threads);
+    for (std::size_t i{}; i < rows; ++i) {
+      y[i * incy] = static_cast<Ty>(y[i * incy] / static_cast<Ty>(cols));
+    }
+  } else {
+    std::vector<wide> sums(rows);
+    detail::reduce_rows<reduction::sum>(rows, cols, a, rs, cs, sums.data(),
+                                        1UL, threads);
+    for (std::size_t i{}; i < rows; ++i) {
+      y[i * incy] = static_cast<Ty>(sums[i] / static_cast<wide>(cols));
+    }
+  }
+}
+
+/// @brief `y[j * incy] = op(column j)` for every column of the `rows x cols`
+/// matrix `a`, that is `reduce_rows` on its transpose
+/// @param threads `0` means every hardware thread
+template <class Ty>
+auto reduce_cols(const reduction op, const std::size_t rows,
+                 const std::size_t cols, const Ty *a, const std::size_t rs,
+                 const std::size_t cs, Ty *y, const std::size_t incy,
+                 const std::size_t threads = 1UL) -> void {
+  reduce_rows(op, cols, rows, a, cs, rs, y, incy, threads);
+}
+} // namespace kraken::blas
+
+#endif // REDUCE_HPP
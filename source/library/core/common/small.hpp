@@ -0,0 +1,205 @@
+#ifndef SMALL_HPP
+#define SMALL_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <cassert>  // assert
+#include <cstddef>  // std::size_t
+#include <utility>  // std::index_sequence
+
+/// @brief fully unrolled kernels for matrices of at most `4 x 4`, every loop
+/// is a fold over an index_sequence so there is no loop counter and no branch
+/// left, all of them work at compile time too
+namespace kraken::blas {
+
+/// @brief the largest `row` or `col` the small kernels are used for
+inline constexpr std::size_t small_max{4UL};
+
+namespace detail {
+
+/// @brief `c(i, j) = sum_k a(i, k) * b(k, j)` for one element
+template <std::size_t K, class Ty, std::size_t... k>
+constexpr auto small_dot(const Ty *a, const Ty *b, const std::size_t ldb,
+                         std::index_sequence<k...>) noexcept -> Ty {
+  return static_cast<Ty>(((a[k] * b[k * ldb]) + ...));
+}
+
+/// @brief one row of `c`, the `N` independent sums vectorize across `j`
+template <std::size_t K, class Ty, std::size_t... j>
+constexpr auto small_gemm_row(const Ty *a, const Ty *b, const std::size_t ldb,
+                              Ty *c, std::index_sequence<j...>) noexcept
+    -> void {
+  ((c[j] = small_dot<K>(a, b + j, ldb, std::make_index_sequence<K>{})), ...);
+}
+} // namespace detail
+
+/// @brief `c = a * b` with `a` M x K, `b` K x N, every loop unrolled
+template <std::size_t M, std::size_t N, std::size_t K, class Ty>
+constexpr auto small_gemm(const Ty *a, const std::size_t lda, const Ty *b,
+                          const std::size_t ldb, Ty *c,
+                          const std::size_t ldc) noexcept -> void {
+  static_assert(M <= small_max && N <= small_max && K <= small_max);
+  [&]<std::size_t... i>(std::index_sequence<i...>) {
+    (detail::small_gemm_row<K>(a + (i * lda), b, ldb, c + (i * ldc),
+                               std::make_index_sequence<N>{}),
+     ...);
+  }
+  (std::make_index_sequence<M>{});
+}
+
+/// @brief closed-form determinant of an `N x N` matrix, `N <= 4`
+template <std::size_t N, class Ty>
+[[nodiscard]] constexpr auto small_det(const Ty *a, const std::size_t lda) noexcept
+    -> Ty {
+  static_assert(N >= 1UL && N <= small_max);
+  const auto at{[a, lda](const std::size_t r, const std::size_t c) {
+    return a[(r * lda) + c];
+  }};
+  if constexpr (N == 1UL) {
+    return at(0, 0);
+  } else if constexpr (N == 2UL) {
+    return static_cast<Ty>((at(0, 0) * at(1, 1)) - (at(0, 1) * at(1, 0)));
+  } else if constexpr (N == 3UL) {
+    return static_cast<Ty>(
+        (at(0, 0) * ((at(1, 1) * at(2, 2)) - (at(1, 2) * at(2, 1)))) -
+        (at(0, 1) * ((at(1, 0) * at(2, 2)) - (at(1, 2) * at(2, 0)))) +
+        (at(0, 2) * ((at(1, 0) * at(2, 1)) - (at(1, 1) * at(2, 0)))));
+  } else {
+    // 2x2 minors of the top two rows (s) and the bottom two rows (c)
+    const Ty s0{static_cast<Ty>((at(0, 0) * at(1, 1)) - (at(1, 0) * at(0, 1)))};
+    const Ty s1{static_cast<Ty>((at(0, 0) * at(1, 2)) - (at(1, 0) * at(0, 2)))};
+    const Ty s2{static_cast<Ty>((at(0, 0) * at(1, 3)) - (at(1, 0) * at(0, 3)))};
+    const Ty s3{static_cast<Ty>((at(0, 1) * at(1, 2)) - (at(1, 1) * at(0, 2)))};
+    const Ty s4{static_cast<Ty>((at(0, 1) * at(1, 3)) - (at(1, 1) * at(0, 3)))};
+    const Ty s5{static_cast<Ty>((at(0, 2) * at(1, 3)) - (at(1, 2) * at(0, 3)))};
+    const Ty c0{static_cast<Ty>((at(2, 0) * at(3, 1)) - (at(3, 0) * at(2, 1)))};
+    const Ty c1{static_cast<Ty>((at(2, 0) * at(3, 2)) - (at(3, 0) * at(2, 2)))};
+    const Ty c2{static_cast<Ty>((at(2, 0) * at(3, 3)) - (at(3, 0) * at(2, 3)))};
+    const Ty c3{static_cast<Ty>((at(2, 1) * at(3, 2)) - (at(3, 1) * at(2, 2)))};
+    const Ty c4{static_cast<Ty>((at(2, 1) * at(3, 3)) - (at(3, 1) * at(2, 3)))};
+    const Ty c5{static_cast<Ty>((at(2, 2) * at(3, 3)) - (at(3, 2) * at(2, 3)))};
+    return static_cast<Ty>((s0 * c5) - (s1 * c4) + (s2 * c3) + (s3 * c2) -
+                           (s4 * c1) + (s5 * c0));
+  }
+}
+
+/// @brief closed-form adjugate of an `N x N` matrix, `N <= 4`, `b` must not
+/// alias `a`. there is no branch at all, so `Ty` may also be a vector type
+/// holding one element of several matrices
+/// @return the determinant
+template <std::size_t N, class Ty>
+constexpr auto small_adjugate(const Ty *a, const std::size_t lda, Ty *b,
+                             const std::size_t ldb) noexcept -> Ty {
+  static_assert(N >= 1UL && N <= small_max);
+  const auto at{[a, lda](const std::size_t r, const std::size_t c) {
+    return a[(r * lda) + c];
+  }};
+  const auto out{[b, ldb](const std::size_t r, const std::size_t c) -> Ty & {
+    return b[(r * ldb) + c];
+  }};
+  if constexpr (N == 1UL) {
+    out(0, 0) = static_cast<Ty>(Ty{} + 1);
+    return at(0, 0);
+  } else if constexpr (N == 2UL) {
+    const Ty det{small_det<2UL>(a, lda)};
+    out(0, 0) = at(1, 1);
+    out(0, 1) = -at(0, 1);
+    out(1, 0) = -at(1, 0);
+    out(1, 1) = at(0, 0);
+    return det;
+  } else if constexpr (N == 3UL) {
+    // cofactors of the first column give the determinant for free
+    const Ty b00{(at(1, 1) * at(2, 2)) - (at(1, 2) * at(2, 1))};
+    const Ty b10{(at(1, 2) * at(2, 0)) - (at(1, 0) * at(2, 2))};
+    const Ty b20{(at(1, 0) * at(2, 1)) - (at(1, 1) * at(2, 0))};
+    const Ty det{(at(0, 0) * b00) + (at(0, 1) * b10) + (at(0, 2) * b20)};
+    out(0, 0) = b00;
+    out(0, 1) = (at(0, 2) * at(2, 1)) - (at(0, 1) * at(2, 2));
+    out(0, 2) = (at(0, 1) * at(1, 2)) - (at(0, 2) * at(1, 1));
+    out(1, 0) = b10;
+    out(1, 1) = (at(0, 0) * at(2, 2)) - (at(0, 2) * at(2, 0));
+    out(1, 2) = (at(0, 2) * at(1, 0)) - (at(0, 0) * at(1, 2));
+    out(2, 0) = b20;
+    out(2, 1) = (at(0, 1) * at(2, 0)) - (at(0, 0) * at(2, 1));
+    out(2, 2) = (at(0, 0) * at(1, 1)) - (at(0, 1) * at(1, 0));
+    return det;
+  } else {
+    const Ty s0{(at(0, 0) * at(1, 1)) - (at(1, 0) * at(0, 1))};
+    const Ty s1{(at(0, 0) * at(1, 2)) - (at(1, 0) * at(0, 2))};
+    const Ty s2{(at(0, 0) * at(1, 3)) - (at(1, 0) * at(0, 3))};
+    const Ty s3{(at(0, 1) * at(1, 2)) - (at(1, 1) * at(0, 2))};
+    const Ty s4{(at(0, 1) * at(1, 3)) - (at(1, 1) * at(0, 3))};
+    const Ty s5{(at(0, 2) * at(1, 3)) - (at(1, 2) * at(0, 3))};
+    const Ty c0{(at(2, 0) * at(3, 1)) - (at(3, 0) * at(2, 1))};
+    const Ty c1{(at(2, 0) * at(3, 2)) - (at(3, 0) * at(2, 2))};
+    const Ty c2{(at(2, 0) * at(3, 3)) - (at(3, 0) * at(2, 3))};
+    const Ty c3{(at(2, 1) * at(3, 2)) - (at(3, 1) * at(2, 2))};
+    const Ty c4{(at(2, 1) * at(3, 3)) - (at(3, 1) * at(2, 3))};
+    const Ty c5{(at(2, 2) * at(3, 3)) - (at(3, 2) * at(2, 3))};
+    const Ty det{(s0 * c5) - (s1 * c4) + (s2 * c3) + (s3 * c2) - (s4 * c1) +
+                 (s5 * c0)};
+    out(0, 0) = (at(1, 1) * c5) - (at(1, 2) * c4) + (at(1, 3) * c3);
+    out(0, 1) = (-at(0, 1) * c5) + (at(0, 2) * c4) - (at(0, 3) * c3);
+    out(0, 2) = (at(3, 1) * s5) - (at(3, 2) * s4) + (at(3, 3) * s3);
+    out(0, 3) = (-at(2, 1) * s5) + (at(2, 2) * s4) - (at(2, 3) * s3);
+    out(1, 0) = (-at(1, 0) * c5) + (at(1, 2) * c2) - (at(1, 3) * c1);
+    out(1, 1) = (at(0, 0) * c5) - (at(0, 2) * c2) + (at(0, 3) * c1);
+    out(1, 2) = (-at(3, 0) * s5) + (at(3, 2) * s2) - (at(3, 3) * s1);
+    out(1, 3) = (at(2, 0) * s5) - (at(2, 2) * s2) + (at(2, 3) * s1);
+    out(2, 0) = (at(1, 0) * c4) - (at(1, 1) * c2) + (at(1, 3) * c0);
+    out(2, 1) = (-at(0, 0) * c4) + (at(0, 1) * c2) - (at(0, 3) * c0);
+    out(2, 2) = (at(3, 0) * s4) - (at(3, 1) * s2) + (at(3, 3) * s0);
+    out(2, 3) = (-at(2, 0) * s4) + (at(2, 1) * s2) - (at(2, 3) * s0);
+    out(3, 0) = (-at(1, 0) * c3) + (at(1, 1) * c1) - (at(1, 2) * c0);
+    out(3, 1) = (at(0, 0) * c3) - (at(0, 1) * c1) + (at(0, 2) * c0);
+    out(3, 2) = (-at(3, 0) * s3) + (at(3, 1) * s1) - (at(3, 2) * s0);
+    out(3, 3) = (at(2, 0) * s3) - (at(2, 1) * s1) + (at(2, 2) * s0);
+    return det;
+  }
+}
+
+/// @brief closed-form inverse (adjugate / determinant) of an `N x N` matrix,
+/// `N <= 4`, `b` must not alias `a`
+/// @return the determinant, `b` is left untouched when it is `0`
+template <std::size_t N, class Ty>
+constexpr auto small_inverse(const Ty *a, const std::size_t lda, Ty *b,
+                             const std::size_t ldb) noexcept -> Ty {
+  Ty adj[N * N]{};
+  const Ty det{small_adjugate<N>(a, lda, adj, N)};
+  if (det == Ty{}) {
+    return det;
+  }
+  const Ty inv{Ty{1} / det};
+  [&]<std::size_t... k>(std::index_sequence<k...>) {
+    ((b[((k / N) * ldb) + (k % N)] = adj[k] * inv), ...);
+  }
+  (std::make_index_sequence<N * N>{});
+  return det;
+}
+} // namespace kraken::blas
+
+#endif // SMALL_HPP
@@ -0,0 +1,342 @@
+#ifndef SORT_HPP
+#define SORT_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "basic_bit_cast.hpp" // kraken::cal::bit_cast
+#include "permute.hpp"        // kraken::blas::permute_rows
+#include "thread_pool.hpp"    // kraken::detail::thread_pool
+#include <algorithm>          // std::sort, std::stable_sort, std::merge
+#include <array>              // std::array
+#include <cstddef>            // std::size_t
+#include <cstdint>            // std::uint8_t, ..., std::uint64_t
+#include <limits>             // std::numeric_limits
+#include <numeric>            // std::iota
+#include <type_traits>        // std::is_integral_v, std::is_unsigned_v
+#include <utility>            // std::swap
+#include <vector>             // std::vector
+
+/// @brief sorting kernels on contiguous buffers: an LSD radix sort for
+/// integers and IEEE floats, a multi-threaded sort that merges sorted runs,
+/// and the stable ordering of matrix rows by key columns
+namespace kraken::blas {
+
+/// @brief element types the radix sort handles, every one maps to an
+/// unsigned word of the same size that sorts in the same order
+template <class Ty>
+concept radix_sortable =
+    ((std::is_integral_v<Ty> && !std::is_same_v<Ty, bool>) ||
+     (std::is_floating_point_v<Ty> && std::numeric_limits<Ty>::is_iec559)) &&
+    (sizeof(Ty) == 1UL || sizeof(Ty) == 2UL || sizeof(Ty) == 4UL ||
+     sizeof(Ty) == 8UL);
+
+namespace detail {
+
+template <std::size_t Bytes> struct radix_word {};
+template <> struct radix_word<1UL> { using type = std::uint8_t; };
+template <> struct radix_word<2UL> { using type = std::uint16_t; };
+template <> struct radix_word<4UL> { using type = std::uint32_t; };
+template <> struct radix_word<8UL> { using type = std::uint64_t; };
+
+/// @brief `value` as an unsigned word with the same order: integers get the
+/// sign bit flipped, negative floats every bit and positive floats the sign
+/// bit, so `-0.` comes before `0.` and a `nan` lands at the end its sign
+/// bit says
+template <radix_sortable Ty>
+[[nodiscard]] constexpr auto radix_key(const Ty value) noexcept {
+  using word = typename radix_word<sizeof(Ty)>::type;
+  constexpr word sign{
+      static_cast<word>(word{1} << (std::numeric_limits<word>::digits - 1))};
+  if constexpr (std::is_unsigned_v<Ty>) {
+    return static_cast<word>(value);
+  } else if constexpr (std::is_integral_v<Ty>) {
+    return static_cast<word>(static_cast<word>(value) ^ sign);
+  } else {
+    const auto bits{kraken::cal::bit_cast<word>(value)};
+    return static_cast<word>((bits & sign) != 0 ? ~bits : bits | sign);
+  }
+}
+
+/// @brief stable LSD radix sort of `n` items by the unsigned word `key(item)`,
+/// one byte per pass: the histograms of every pass are counted in a single
+/// read and a pass whose byte is the same for every item is skipped
+template <class Item, class Key>
+auto radix_passes(const std::size_t n, Item *data, Item *scratch, Key &&key)
+    -> void {
+  using word = decltype(key(*data));
+  constexpr std::size_t passes{sizeof(word)};
+  const auto digit = [&key](const Item &item, const std::size_t pass) {
+    return static_cast<std::size_t>((key(item) >> (8U * pass)) & 0xFFU);
+  };
+  std::array<std::array<std::size_t, 256UL>, passes> counts{};
+  for (std::size_t i{}; i < n; ++i) {
+    for (std::size_t p{}; p < passes; ++p) {
+      ++counts[p][digit(data[i], p)];
+    }
+  }
+  Item *from{data};
+  Item *to{scratch};
+  for (std::size_t p{}; p < passes; ++p) {
+    auto &count{counts[p]};
+    if (count[digit(from[0], p)] == n) {
+      continue;
+    }
+    for (std::size_t d{}, total{}; d < 256UL; ++d) {
+      const std::size_t c{count[d]};
+      count[d] = total;
+      total += c;
+    }
+    for (std::size_t i{}; i < n; ++i) {
+      to[count[digit(from[i], p)]++] = from[i];
+    }
+    std::swap(from, to);
+  }
+  if (from != data) {
+    std::copy_n(from, n, data);
+  }
+}
+
+/// @brief the order the sort kernels use, on radix keys when the element has
+/// them so merged radix runs stay in radix order
+template <class Ty>
+[[nodiscard]] constexpr auto sort_order(const bool ascending) noexcept {
+  return [ascending](const Ty &lhs, const Ty &rhs) {
+    if constexpr (radix_sortable<Ty>) {
+      return ascending ? radix_key(lhs) < radix_key(rhs)
+                       : radix_key(rhs) < radix_key(lhs);
+    } else {
+      return ascending ? lhs < rhs : rhs < lhs;
+    }
+  };
+}
+
+/// @brief below this many elements `std::sort` beats the radix passes
+inline constexpr std::size_t radix_cutoff{1024UL};
+
+/// @brief fewest elements of a run the threaded sort hands to a thread
+inline constexpr std::size_t sort_grain{1UL << 15U};
+
+/// @brief number of elements of `a` among the first `k` of the stable merge
+/// of `a` and `b` (ties taken from `a` first), the merge path split point
+template <class Ty, class Compare>
+[[nodiscard]] auto co_rank(const std::size_t k, const Ty *a,
+                           const std::size_t na, const Ty *b,
+                           const std::size_t nb, Compare &&comp)
+    -> std::size_t {
+  std::size_t lo{k > nb ? k - nb : 0UL};
+  std::size_t hi{std::min(k, na)};
+  while (lo < hi) {
+    const std::size_t i{lo + ((hi - lo) / 2UL)};
+    const std::size_t j{k - i};
+    if (j > 0UL && !comp(b[j - 1UL], a[i])) {
+      lo = i + 1UL; // `a[i]` is merged before `b[j - 1]`
+    } else {
+      hi = i;
+    }
+  }
+  return lo;
+}
+} // namespace detail
+
+/// @brief LSD radix sort, `O(n)` for any distribution of keys with `n` extra
+/// elements of memory. a descending sort runs on the complemented keys
+template <radix_sortable Ty>
+auto radix_sort(const std::size_t n, Ty *data, const bool ascending = true)
+    -> void {
+  if (n < 2UL) {
+    return;
+  }
+  using word = typename detail::radix_word<sizeof(Ty)>::type;
+  std::vector<Ty> scratch(n);
+  if (ascending) {
+    detail::radix_passes(n, data, scratch.data(),
+                         [](const Ty v) { return detail::radix_key(v); });
+  } else {
+    detail::radix_passes(n, data, scratch.data(), [](const Ty v) {
+      return static_cast<word>(~detail::radix_key(v));
+    });
+  }
+}
+
+/// @brief stably reorders the `n` indices in `index` by `key[index[i] * inc]`,
+/// indices with equal keys keep their order so sorting by the least
+/// significant key first and the most significant last orders by all of them
+template <radix_sortable Ty>
+auto radix_argsort(const std::size_t n, const Ty *key, const std::size_t inc,
+                   std::size_t *index, const bool ascending = true) -> void {
+  if (n < 2UL) {
+    return;
+  }
+  using word = typename detail::radix_word<sizeof(Ty)>::type;
+  struct item {
+    word key;
+    std::size_t index;
+  };
+  std::vector<item> items(n);
+  std::vector<item> scratch(n);
+  for (std::size_t i{}; i < n; ++i) {
+    const word k{detail::radix_key(key[index[i] * inc])};
+    items[i] = {ascending ? k : static_cast<word>(~k), index[i]};
+  }
+  detail::radix_passes(n, items.data(), scratch.data(),
+                       [](const item &i) { return i.key; });
+  for (std::size_t i{}; i < n; ++i) {
+    index[i] = items[i].index;
+  }
+}
+
+namespace detail {
+
+/// @brief sorts one contiguous run on the calling thread
+template <class Ty>
+auto sort_run(const std::size_t n, Ty *data, const bool ascending) -> void {
+  if constexpr (radix_sortable<Ty>) {
+    if (n >= radix_cutoff) {
+      radix_sort(n, data, ascending);
+      return;
+    }
+  }
+  std::sort(data, data + n, sort_order<Ty>(ascending));
+}
+} // namespace detail
+
+/// @brief sorts `n` contiguous elements on up to `threads` threads: the
+/// buffer is cut into one run per thread, each run is sorted on its own
+/// (radix sort when the element allows it, `std::sort` otherwise), then the
+/// runs are merged pairwise, every merge split along its merge path so each
+/// round keeps all the threads busy
+/// @param threads `0` means every thread of the pool
+template <class Ty>
+auto sort(const std::size_t n, Ty *data, const bool ascending = true,
+          const std::size_t threads = 1UL) -> void {
+  auto &pool{kraken::detail::thread_pool::instance()};
+  // runs follow the requested count, `parallel_for` caps it to the pool
+  const std::size_t runs{std::min(
+      threads == 0UL ? pool.concurrency() : threads, n / detail::sort_grain)};
+  if (runs <= 1UL) {
+    detail::sort_run(n, data, ascending);
+    return;
+  }
+  std::vector<std::size_t> bounds(runs + 1UL);
+  for (std::size_t r{}; r <= runs; ++r) {
+    bounds[r] = (n * r) / runs;
+  }
+  pool.parallel_for(runs, runs, [&](const std::size_t r) {
+    detail::sort_run(bounds[r + 1UL] - bounds[r], data + bounds[r],
+                     ascending);
+  });
+  const auto comp{detail::sort_order<Ty>(ascending)};
+  std::vector<Ty> scratch(n);
+  Ty *from{data};
+  Ty *to{scratch.data()};
+  while (bounds.size() > 2UL) {
+    const std::size_t pairs{(bounds.size() - 1UL) / 2UL};
+    const std::size_t parts{std::max(runs / pairs, 1UL)};
+    const bool odd{(bounds.size() - 1UL) % 2UL != 0UL};
+    pool.parallel_for(
+        (pairs * parts) + (odd ? 1UL : 0UL), runs, [&](const std::size_t t) {
+          if (t == pairs * parts) { // the last run has nobody to merge with
+            const std::size_t lo{bounds[bounds.size() - 2UL]};
+            std::copy_n(from + lo, n - lo, to + lo);
+            return;
+          }
+          const std::size_t pair{t / parts};
+          const std::size_t part{t % parts};
+          const std::size_t lo{bounds[2UL * pair]};
+          const std::size_t mid{bounds[(2UL * pair) + 1UL]};
+          const std::size_t hi{bounds[(2UL * pair) + 2UL]};
+          const Ty *a{from + lo};
+          const Ty *b{from + mid};
+          const std::size_t na{mid - lo};
+          const std::size_t nb{hi - mid};
+          const std::size_t k0{((na + nb) * part) / parts};
+          const std::size_t k1{((na + nb) * (part + 1UL)) / parts};
+          const std::size_t i0{detail::co_rank(k0, a, na, b, nb, comp)};
+          const std::size_t i1{detail::co_rank(k1, a, na, b, nb, comp)};
+          std::merge(a + i0, a + i1, b + (k0 - i0), b + (k1 - i1),
+                     to + lo + k0, comp);
+        });
+    std::vector<std::size_t> merged{};
+    for (std::size_t r{}; r < bounds.size(); r += 2UL) {
+      merged.push_back(bounds[r]);
+    }
+    if (merged.back() != n) {
+      merged.push_back(n);
+    }
+    bounds = std::move(merged);
+    std::swap(from, to);
+  }
+  if (from != data) {
+    std::copy_n(from, n, data);
+  }
+}
+
+/// @brief the stable order of the rows of a `rows`-row matrix (row `i` at
+/// `a + i * rs`, its elements `cs` apart) by the key columns: `keys[0]`
+/// first, ties broken by `keys[1]` and so on. only the key columns are read,
+/// with radix passes from the last key to the first when the element allows
+/// it, `std::stable_sort` otherwise
+/// @param perm receives the order, row `i` of the sorted matrix is the row
+/// `perm[i]` (see `permute_rows`)
+template <class Ty>
+auto order_rows(const std::size_t rows, const Ty *a, const std::size_t rs,
+                const std::size_t cs, const std::size_t *keys,
+                const std::size_t nkeys, std::size_t *perm,
+                const bool ascending = true) -> void {
+  std::iota(perm, perm + rows, 0UL);
+  if constexpr (radix_sortable<Ty>) {
+    for (std::size_t k{nkeys}; k > 0UL; --k) {
+      radix_argsort(rows, a + (keys[k - 1UL] * cs), rs, perm, ascending);
+    }
+  } else {
+    std::stable_sort(perm, perm + rows,
+                     [&](const std::size_t lhs, const std::size_t rhs) {
+                       for (std::size_t k{}; k < nkeys; ++k) {
+                         const Ty &x{a[(lhs * rs) + (keys[k] * cs)]};
+                         const Ty &y{a[(rhs * rs) + (keys[k] * cs)]};
+                         if (x < y || y < x) {
+                           return ascending == (x < y);
+                         }
+                       }
+                       return false;
+                     });
+  }
+}
+
+/// @brief sorts the rows of a row-major `rows x cols` matrix by the key
+/// columns (see `order_rows`), every row then moves once as a whole
+template <class Ty>
+auto sort_rows(const std::size_t rows, const std::size_t cols, Ty *a,
+               const std::size_t lda, const std::size_t *keys,
+               const std::size_t nkeys, const bool ascending = true) -> void {
+  std::vector<std::size_t> perm(rows);
+  order_rows(rows, a, lda, 1UL, keys, nkeys, perm.data(), ascending);
+  permute_rows(rows, cols, perm.data(), a, lda);
+}
+} // namespace kraken::blas
+
+#endif // SORT_HPP
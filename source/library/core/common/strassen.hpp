@@ -0,0 +1,205 @@
+#ifndef STRASSEN_HPP
+#define STRASSEN_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "aligned_buffer.hpp"
+#include "gemm.hpp"  // gemm
+#include <algorithm> // std::max
+#include <cstddef>   // std::size_t
+
+/// @brief Strassen-Winograd: 7 half-size products and 15 additions instead of
+/// 8 products per level, `O(n^2.81)`, the half-size products recurse until a
+/// dimension drops to `cutoff` and then go to the blocked `gemm`
+///
+/// error: Strassen-type methods are only stable normwise,
+/// `|C - fl(C)|_max <= f(n) * u * |A|_max * |B|_max` with `f(n)` about
+/// `(n / cutoff)^log2(18) * cutoff^2` (Higham, "Accuracy and Stability of
+/// Numerical Algorithms", 23.2.2), every level multiplies the bound by up to
+/// 18, so small elements of `C` can lose relative accuracy when `A` or `B`
+/// mix very different magnitudes, the classical product bounds each element
+/// by `k * u * (|A| * |B|)`
+namespace kraken::blas {
+
+/// @brief default largest dimension that is not split any more, measured
+/// (double, avx-512, one thread): 512 is 8% faster than gemm at n = 2048 and
+/// 27% faster at n = 4096, 1024 only pays off from n = 4096
+inline constexpr std::size_t strassen_cutoff{512UL};
+
+namespace detail {
+
+/// @brief `c = a + b` or `c = a - b` on `m x n` blocks, `c` may be `a` or `b`
+template <bool Add, class Ty>
+auto block_add(const std::size_t m, const std::size_t n, const Ty *a,
+               const std::size_t lda, const Ty *b, const std::size_t ldb,
+               Ty *c, const std::size_t ldc) noexcept -> void {
+  for (std::size_t i{}; i < m; ++i) {
+    const Ty *const ra{a + (i * lda)};
+    const Ty *const rb{b + (i * ldb)};
+    Ty *const rc{c + (i * ldc)};
+    for (std::size_t j{}; j < n; ++j) {
+      rc[j] = Add ? static_cast<Ty>(ra[j] + rb[j])
+                  : static_cast<Ty>(ra[j] - rb[j]);
+    }
+  }
+}
+
+/// @brief workspace (elements) of a `m x n x k` product, the two temporaries
+/// of every level of the recursion
+[[nodiscard]] constexpr auto strassen_workspace(const std::size_t m,
+                                                const std::size_t n,
+                                                const std::size_t k,
+                                                const std::size_t cutoff)
+    -> std::size_t {
+  std::size_t total{};
+  for (std::size_t mm{m}, nn{n}, kk{k};
+       mm > cutoff && nn > cutoff && kk > cutoff;
+       mm /= 2UL, nn /= 2UL, kk /= 2UL) {
+    total += ((mm / 2UL) * std::max(kk / 2UL, nn / 2UL)) +
+             ((kk / 2UL) * (nn / 2UL));
+  }
+  return total;
+}
+
+/// @brief `C = A * B`, one level of Strassen-Winograd on the even part, the
+/// odd last row / column / inner index are fixed up with `gemm` ("dynamic
+/// peeling"). `ws` holds `strassen_workspace(m, n, k, cutoff)` elements
+template <class Ty>
+auto winograd(const std::size_t m, const std::size_t n, const std::size_t k,
+              const Ty *a, const std::size_t lda, const Ty *b,
+              const std::size_t ldb, Ty *c, const std::size_t ldc,
+              const std::size_t cutoff, const std::size_t threads, Ty *ws)
+    -> void {
+  if (m <= cutoff || n <= cutoff || k <= cutoff) {
+    gemm(m, n, k, Ty{1}, a, lda, b, ldb, Ty{}, c, ldc, threads);
+    return;
+  }
+  const std::size_t m2{m / 2UL};
+  const std::size_t n2{n / 2UL};
+  const std::size_t k2{k / 2UL};
+  const Ty *const a11{a};
+  const Ty *const a12{a + k2};
+  const Ty *const a21{a + (m2 * lda)};
+  const Ty *const a22{a21 + k2};
+  const Ty *const b11{b};
+  const Ty *const b12{b + n2};
+  const Ty *const b21{b + (k2 * ldb)};
+  const Ty *const b22{b21 + n2};
+  Ty *const c11{c};
+  Ty *const c12{c + n2};
+  Ty *const c21{c + (m2 * ldc)};
+  Ty *const c22{c21 + n2};
+  // `x` is `m2 x max(k2, n2)`, `y` is `k2 x n2`, the quadrants of `C` hold
+  // the other intermediates (Douglas et al., 1994)
+  const std::size_t ldx{std::max(k2, n2)};
+  Ty *const x{ws};
+  Ty *const y{x + (m2 * ldx)};
+  Ty *const next{y + (k2 * n2)};
+  const auto mul = [&](const Ty *pa, const std::size_t la, const Ty *pb,
+                       const std::size_t lb, Ty *pc, const std::size_t lc) {
+    winograd(m2, n2, k2, pa, la, pb, lb, pc, lc, cutoff, threads, next);
+  };
+  block_add<false>(m2, k2, a11, lda, a21, lda, x, ldx);  // s3
+  block_add<false>(k2, n2, b22, ldb, b12, ldb, y, n2);   // t3
+  mul(x, ldx, y, n2, c21, ldc);                          // p7
+  block_add<true>(m2, k2, a21, lda, a22, lda, x, ldx);   // s1
+  block_add<false>(k2, n2, b12, ldb, b11, ldb, y, n2);   // t1
+  mul(x, ldx, y, n2, c22, ldc);                          // p5
+  block_add<false>(m2, k2, x, ldx, a11, lda, x, ldx);    // s2
+  block_add<false>(k2, n2, b22, ldb, y, n2, y, n2);      // t2
+  mul(x, ldx, y, n2, c12, ldc);                          // p6
+  block_add<false>(m2, k2, a12, lda, x, ldx, x, ldx);    // s4
+  mul(x, ldx, b22, ldb, c11, ldc);                       // p3
+  mul(a11, lda, b11, ldb, x, ldx);                       // p1
+  block_add<true>(m2, n2, x, ldx, c12, ldc, c12, ldc);   // u2 = p1 + p6
+  block_add<true>(m2, n2, c12, ldc, c21, ldc, c21, ldc); // u3 = u2 + p7
+  block_add<true>(m2, n2, c12, ldc, c22, ldc, c12, ldc); // u4 = u2 + p5
+  block_add<true>(m2, n2, c21, ldc, c22, ldc, c22, ldc); // u7 = u3 + p5
+  block_add<true>(m2, n2, c12, ldc, c11, ldc, c12, ldc); // u5 = u4 + p3
+  block_add<false>(k2, n2, y, n2, b21, ldb, y, n2);      // t4
+  mul(a22, lda, y, n2, c11, ldc);                        // p4
+  block_add<false>(m2, n2, c21, ldc, c11, ldc, c21, ldc); // u6 = u3 - p4
+  mul(a12, lda, b21, ldb, c11, ldc);                     // p2
+  block_add<true>(m2, n2, x, ldx, c11, ldc, c11, ldc);   // u1 = p1 + p2
+  // peeling: the odd inner index, then the odd last column and row
+  if (k % 2UL != 0UL) {
+    gemm(2UL * m2, 2UL * n2, 1UL, Ty{1}, a + (k - 1UL), lda,
+         b + ((k - 1UL) * ldb), ldb, Ty{1}, c, ldc, threads);
+  }
+  if (n % 2UL != 0UL) {
+    gemm(m, 1UL, k, Ty{1}, a, lda, b + (n - 1UL), ldb, Ty{}, c + (n - 1UL),
+         ldc, threads);
+  }
+  if (m % 2UL != 0UL) {
+    gemm(1UL, 2UL * n2, k, Ty{1}, a + ((m - 1UL) * lda), lda, b, ldb, Ty{},
+         c + ((m - 1UL) * ldc), ldc, threads);
+  }
+}
+} // namespace detail
+
+/// @brief row-major `C = alpha * A * B + beta * C` with Strassen-Winograd,
+/// see the error note above, the workspace is allocated once per call and
+/// is bounded by `(m * max(k, n) + k * n) / 3` elements (plus `m * n` when
+/// `alpha != 1` or `beta != 0`)
+/// @param cutoff products with a dimension `<= cutoff` go to `gemm`
+/// @param threads threads of the `gemm` leaves, `0` means all of them
+template <class Ty>
+auto strassen(const std::size_t m, const std::size_t n, const std::size_t k,
+              const Ty alpha, const Ty *a, const std::size_t lda, const Ty *b,
+              const std::size_t ldb, const Ty beta, Ty *c,
+              const std::size_t ldc,
+              const std::size_t cutoff = strassen_cutoff,
+              const std::size_t threads = 1UL) -> void {
+  const std::size_t floor{std::max(cutoff, 1UL)};
+  if (m <= floor || n <= floor || k <= floor) {
+    gemm(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, threads);
+    return;
+  }
+  const std::size_t work{detail::strassen_workspace(m, n, k, floor)};
+  if (alpha == Ty{1} && beta == Ty{}) {
+    kraken::detail::aligned_buffer<Ty> ws(work);
+    detail::winograd(m, n, k, a, lda, b, ldb, c, ldc, floor, threads,
+                     ws.data());
+    return;
+  }
+  // the recursion overwrites its output, so `A * B` goes to a temporary
+  kraken::detail::aligned_buffer<Ty> ws(work + (m * n));
+  Ty *const product{ws.data() + work};
+  detail::winograd(m, n, k, a, lda, b, ldb, product, n, floor, threads,
+                   ws.data());
+  for (std::size_t i{}; i < m; ++i) {
+    for (std::size_t j{}; j < n; ++j) {
+      Ty &dst{c[(i * ldc) + j]};
+      dst = beta == Ty{} ? static_cast<Ty>(alpha * product[(i * n) + j])
+                         : static_cast<Ty>((alpha * product[(i * n) + j]) +
+                                           (beta * dst));
+    }
+  }
+}
+} // namespace kraken::blas
+
+#endif // STRASSEN_HPP
@@ -0,0 +1,143 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <algorithm> // std::min, std::max
+#include <atomic>
+#include <condition_variable>
+#include <cstddef> // std::size_t
+#include <deque>
+#include <functional> // std::function
+#include <memory>     // std::shared_ptr
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kraken::detail {
+
+/// @brief fixed set of worker threads fed from one job queue, the library
+/// keeps a single instance (`thread_pool::instance()`) so kernels never pay
+/// for thread creation
+class thread_pool {
+private:
+  std::vector<std::jthread> m_workers{};
+  std::deque<std::function<void()>> m_jobs{};
+  std::mutex m_mutex{};
+  std::condition_variable_any m_wake{};
+
+  auto work(const std::stop_token &stop) -> void {
+    for (;;) {
+      std::function<void()> job{};
+      {
+        std::unique_lock lock{m_mutex};
+        if (!m_wake.wait(lock, stop, [this] { return !m_jobs.empty(); })) {
+          return;
+        }
+        job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+      }
+      job();
+    }
+  }
+
+public:
+  /// @param workers number of threads besides the calling one
+  explicit thread_pool(const std::size_t workers) {
+    m_workers.reserve(workers);
+    for (std::size_t i{}; i < workers; ++i) {
+      m_workers.emplace_back(
+          [this](const std::stop_token &stop) { work(stop); });
+    }
+  }
+
+  thread_pool(const thread_pool &) = delete;
+  auto operator=(const thread_pool &) -> thread_pool & = delete;
+
+  ~thread_pool() {
+    for (auto &&i : m_workers) {
+      i.request_stop();
+    }
+  }
+
+  /// @brief the shared pool, one worker per hardware thread minus the caller
+  [[nodiscard]] static auto instance() -> thread_pool & {
+    static thread_pool pool{
+        std::max(std::thread::hardware_concurrency(), 1U) - 1U};
+    return pool;
+  }
+
+  /// @return number of threads a call can use, counting the calling one
+  [[nodiscard]] auto concurrency() const noexcept -> std::size_t {
+    return m_workers.size() + 1UL;
+  }
+
+  /// @brief runs `fn(i)` for every `i` in [0, count) on at most `threads`
+  /// threads (the calling one included) and returns once all are done
+  /// @param threads `0` means every thread of the pool
+  template <class Fn>
+  auto parallel_for(const std::size_t count, std::size_t threads, Fn &&fn)
+      -> void {
+    threads = std::min({threads == 0UL ? concurrency() : threads,
+                        concurrency(), count});
+    if (threads <= 1UL) {
+      for (std::size_t i{}; i < count; ++i) {
+        fn(i);
+      }
+      return;
+    }
+    // indices are handed out one by one, so the caller only ever waits on
+    // indices some running thread has already claimed (no nested deadlock)
+    struct state {
+      std::atomic<std::size_t> next{};
+      std::atomic<std::size_t> done{};
+    };
+    const auto shared{std::make_shared<state>()};
+    const auto run = [shared, count, &fn] {
+      for (std::size_t i{shared->next++}; i < count; i = shared->next++) {
+        fn(i);
+        if (++shared->done == count) {
+          shared->done.notify_all();
+        }
+      }
+    };
+    {
+      std::scoped_lock lock{m_mutex};
+      for (std::size_t i{1}; i < threads; ++i) {
+        m_jobs.emplace_back(run);
+      }
+    }
+    m_wake.notify_all();
+    run();
+    for (std::size_t done{shared->done}; done != count; done = shared->done) {
+      shared->done.wait(done);
+    }
+  }
+};
+} // namespace kraken::detail
+
+#endif // THREAD_POOL_HPP
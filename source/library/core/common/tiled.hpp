@@ -0,0 +1,139 @@
+#ifndef TILED_HPP
+#define TILED_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <algorithm>   // std::sort
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint64_t
+#include <numeric>     // std::iota
+#include <type_traits> // std::is_same_v
+#include <vector>      // std::vector
+
+/// @brief block-major storage: the matrix is cut in `T x T` tiles, every tile
+/// is contiguous (row-major inside) and the tiles follow each other in the
+/// buffer in one of two orders
+namespace kraken::tiled {
+
+/// @brief tiles row after row of tiles
+struct rows {};
+/// @brief tiles along a Z-order (Morton) curve: tiles close in both
+/// directions stay close in memory, at every scale
+struct morton {};
+
+template <class Order>
+concept order = std::is_same_v<Order, rows> || std::is_same_v<Order, morton>;
+
+/// @brief default side of a tile: 4 KiB of `float`, 8 KiB of `double`, one
+/// or two pages, so a column walk touches a page every 32 rows, not every row
+template <class Ty>
+inline constexpr std::size_t side{sizeof(Ty) >= 4UL ? 32UL : 64UL};
+
+/// @brief spreads the low 32 bits of `x` to the even bits
+[[nodiscard]] constexpr auto spread(std::uint64_t x) noexcept
+    -> std::uint64_t {
+  x &= 0xFFFFFFFFULL;
+  x = (x | (x << 16U)) & 0x0000FFFF0000FFFFULL;
+  x = (x | (x << 8U)) & 0x00FF00FF00FF00FFULL;
+  x = (x | (x << 4U)) & 0x0F0F0F0F0F0F0F0FULL;
+  x = (x | (x << 2U)) & 0x3333333333333333ULL;
+  x = (x | (x << 1U)) & 0x5555555555555555ULL;
+  return x;
+}
+
+/// @brief position of tile (`ti`, `tj`) on the Z-order curve: the bits of
+/// `ti` and `tj` interleaved
+[[nodiscard]] constexpr auto morton_key(const std::size_t ti,
+                                        const std::size_t tj) noexcept
+    -> std::uint64_t {
+  return (spread(ti) << 1U) | spread(tj);
+}
+
+/// @brief where every tile of a `tile_rows x tile_cols` grid is stored:
+/// entry `ti * tile_cols + tj` is the index of tile (`ti`, `tj`) in the
+/// buffer. a grid that is not a square power of two is walked along the
+/// curve of the enclosing one, skipping the missing tiles, so no room is lost
+template <order Order>
+[[nodiscard]] auto tile_offsets(const std::size_t tile_rows,
+                                const std::size_t tile_cols)
+    -> std::vector<std::size_t> {
+  std::vector<std::size_t> by_position(tile_rows * tile_cols);
+  std::iota(by_position.begin(), by_position.end(), 0UL);
+  if constexpr (std::is_same_v<Order, morton>) {
+    std::sort(by_position.begin(), by_position.end(),
+              [tile_cols](const std::size_t lhs, const std::size_t rhs) {
+                return morton_key(lhs / tile_cols, lhs % tile_cols) <
+                       morton_key(rhs / tile_cols, rhs % tile_cols);
+              });
+    // `by_position` now lists the tiles in storage order, invert it
+    std::vector<std::size_t> offsets(by_position.size());
+    for (std::size_t stored{}; stored < by_position.size(); ++stored) {
+      offsets[by_position[stored]] = stored;
+    }
+    return offsets;
+  } else {
+    return by_position;
+  }
+}
+} // namespace kraken::tiled
+
+/// @brief kernels on whole tiles, the side is known at compile time so every
+/// inner loop is a fixed number of full vectors
+namespace kraken::blas {
+
+/// @brief `C += A * B` on contiguous `T x T` tiles. two rows of `C` stay in
+/// registers while `k` runs, each row of `B` loaded is used twice (about
+/// twice the speed of the packed `gemm` on one tile, which repacks it)
+template <std::size_t T, class Ty>
+auto tile_gemm(const Ty *a, const Ty *b, Ty *c) noexcept -> void {
+  constexpr std::size_t R{T % 2UL == 0UL ? 2UL : 1UL};
+  for (std::size_t i{}; i < T; i += R) {
+    Ty acc[R][T];
+    for (std::size_t r{}; r < R; ++r) {
+      for (std::size_t j{}; j < T; ++j) {
+        acc[r][j] = c[((i + r) * T) + j];
+      }
+    }
+    for (std::size_t p{}; p < T; ++p) {
+      const Ty *b_row{b + (p * T)};
+      for (std::size_t r{}; r < R; ++r) {
+        const Ty a_ip{a[((i + r) * T) + p]};
+        for (std::size_t j{}; j < T; ++j) {
+          acc[r][j] += a_ip * b_row[j];
+        }
+      }
+    }
+    for (std::size_t r{}; r < R; ++r) {
+      for (std::size_t j{}; j < T; ++j) {
+        c[((i + r) * T) + j] = acc[r][j];
+      }
+    }
+  }
+}
+} // namespace kraken::blas
+
+#endif // TILED_HPP
@@ -0,0 +1,253 @@
+#ifndef TRANSPOSE_HPP
+#define TRANSPOSE_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "aligned_buffer.hpp" // cache_line
+#include <algorithm>          // std::min, std::max, std::copy_n
+#include <cstddef>            // std::size_t
+#include <utility>            // std::swap
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace kraken::blas {
+
+namespace detail {
+
+/// @brief transposes one `size x size` tile: `dst(j, i) = src(i, j)`,
+/// specializations keep the whole tile in vector registers
+template <class Ty> struct tile_transpose {
+  static constexpr std::size_t size{8UL};
+  static auto apply(const Ty *src, const std::size_t lds, Ty *dst,
+                    const std::size_t ldd) noexcept -> void {
+    for (std::size_t i{}; i < size; ++i) {
+      for (std::size_t j{}; j < size; ++j) {
+        dst[(j * ldd) + i] = src[(i * lds) + j];
+      }
+    }
+  }
+};
+
+#if defined(__AVX__)
+template <> struct tile_transpose<float> {
+  static constexpr std::size_t size{8UL};
+  static auto apply(const float *src, const std::size_t lds, float *dst,
+                    const std::size_t ldd) noexcept -> void {
+    __m256 r[8];
+    for (std::size_t i{}; i < 8UL; ++i) {
+      r[i] = _mm256_loadu_ps(src + (i * lds));
+    }
+    __m256 t[8];
+    for (std::size_t i{}; i < 8UL; i += 2UL) {
+      t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+      t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+    }
+    for (std::size_t i{}; i < 8UL; i += 4UL) {
+      r[i] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+      r[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+      r[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+      r[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+    }
+    for (std::size_t i{}; i < 4UL; ++i) {
+      _mm256_storeu_ps(dst + (i * ldd), _mm256_permute2f128_ps(r[i], r[i + 4], 0x20));
+      _mm256_storeu_ps(dst + ((i + 4UL) * ldd),
+                       _mm256_permute2f128_ps(r[i], r[i + 4], 0x31));
+    }
+  }
+};
+
+template <> struct tile_transpose<double> {
+  static constexpr std::size_t size{4UL};
+  static auto apply(const double *src, const std::size_t lds, double *dst,
+                    const std::size_t ldd) noexcept -> void {
+    const __m256d r0{_mm256_loadu_pd(src)};
+    const __m256d r1{_mm256_loadu_pd(src + lds)};
+    const __m256d r2{_mm256_loadu_pd(src + (2UL * lds))};
+    const __m256d r3{_mm256_loadu_pd(src + (3UL * lds))};
+    const __m256d t0{_mm256_unpacklo_pd(r0, r1)};
+    const __m256d t1{_mm256_unpackhi_pd(r0, r1)};
+    const __m256d t2{_mm256_unpacklo_pd(r2, r3)};
+    const __m256d t3{_mm256_unpackhi_pd(r2, r3)};
+    _mm256_storeu_pd(dst, _mm256_permute2f128_pd(t0, t2, 0x20));
+    _mm256_storeu_pd(dst + ldd, _mm256_permute2f128_pd(t1, t3, 0x20));
+    _mm256_storeu_pd(dst + (2UL * ldd), _mm256_permute2f128_pd(t0, t2, 0x31));
+    _mm256_storeu_pd(dst + (3UL * ldd), _mm256_permute2f128_pd(t1, t3, 0x31));
+  }
+};
+#elif defined(__SSE2__) || defined(_M_X64)
+template <> struct tile_transpose<float> {
+  static constexpr std::size_t size{4UL};
+  static auto apply(const float *src, const std::size_t lds, float *dst,
+                    const std::size_t ldd) noexcept -> void {
+    __m128 r0{_mm_loadu_ps(src)};
+    __m128 r1{_mm_loadu_ps(src + lds)};
+    __m128 r2{_mm_loadu_ps(src + (2UL * lds))};
+    __m128 r3{_mm_loadu_ps(src + (3UL * lds))};
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(dst, r0);
+    _mm_storeu_ps(dst + ldd, r1);
+    _mm_storeu_ps(dst + (2UL * ldd), r2);
+    _mm_storeu_ps(dst + (3UL * ldd), r3);
+  }
+};
+
+template <> struct tile_transpose<double> {
+  static constexpr std::size_t size{2UL};
+  static auto apply(const double *src, const std::size_t lds, double *dst,
+                    const std::size_t ldd) noexcept -> void {
+    const __m128d r0{_mm_loadu_pd(src)};
+    const __m128d r1{_mm_loadu_pd(src + lds)};
+    _mm_storeu_pd(dst, _mm_unpacklo_pd(r0, r1));
+    _mm_storeu_pd(dst + ldd, _mm_unpackhi_pd(r0, r1));
+  }
+};
+#endif
+
+/// @brief side of the square blocks both transposes walk through, one row of
+/// a block is 256 bytes so a source block and a destination block sit in L1
+template <class Ty>
+inline constexpr std::size_t transpose_block{
+    std::max(tile_transpose<Ty>::size, 256UL / sizeof(Ty))};
+
+/// @brief side of the blocks `transpose_square` buffers on the stack, shrunk
+/// from `transpose_block` (whole tiles first) until the buffer fits in 8 KiB
+template <class Ty>
+[[nodiscard]] constexpr auto square_block() noexcept -> std::size_t {
+  constexpr std::size_t tile{tile_transpose<Ty>::size};
+  std::size_t side{transpose_block<Ty>};
+  while (side > 1UL && side * side * sizeof(Ty) > 8192UL) {
+    side -= side > tile ? tile : 1UL;
+  }
+  return side;
+}
+
+/// @brief transposes a block that fits in L1, tile by tile, walking the
+/// destination rows so every store lands in a line that was just written
+template <class Ty>
+auto transpose_leaf_block(const std::size_t rows, const std::size_t cols,
+                          const Ty *src, const std::size_t lds, Ty *dst,
+                          const std::size_t ldd) noexcept -> void {
+  constexpr std::size_t T{tile_transpose<Ty>::size};
+  const std::size_t full_rows{rows - (rows % T)};
+  const std::size_t full_cols{cols - (cols % T)};
+  for (std::size_t j{}; j < full_cols; j += T) {
+    for (std::size_t i{}; i < full_rows; i += T) {
+      tile_transpose<Ty>::apply(src + (i * lds) + j, lds, dst + (j * ldd) + i,
+                                ldd);
+    }
+  }
+  // ragged right and bottom edges
+  for (std::size_t i{}; i < rows; ++i) {
+    for (std::size_t j{i < full_rows ? full_cols : 0UL}; j < cols; ++j) {
+      dst[(j * ldd) + i] = src[(i * lds) + j];
+    }
+  }
+}
+} // namespace detail
+
+/// @brief out-of-place transpose of a row-major `rows x cols` matrix:
+/// `dst(j, i) = src(i, j)`, `src` and `dst` must not overlap
+/// the matrix is walked block by block, each block tile by tile with the tile
+/// transposed inside vector registers
+/// @param lds, ldd distance (in elements) between two rows
+template <class Ty>
+auto transpose(const std::size_t rows, const std::size_t cols, const Ty *src,
+               const std::size_t lds, Ty *dst, const std::size_t ldd) noexcept
+    -> void {
+  constexpr std::size_t B{detail::transpose_block<Ty>};
+  for (std::size_t i{}; i < rows; i += B) {
+    for (std::size_t j{}; j < cols; j += B) {
+      detail::transpose_leaf_block(std::min(B, rows - i), std::min(B, cols - j),
+                                   src + (i * lds) + j, lds,
+                                   dst + (j * ldd) + i, ldd);
+    }
+  }
+}
+
+/// @brief in-place transpose of a row-major `n x n` matrix, the blocks on
+/// each side of the diagonal are transposed through an 8 KiB stack buffer
+/// and swapped
+/// @param ld distance (in elements) between two rows
+template <class Ty>
+auto transpose_square(const std::size_t n, Ty *data,
+                      const std::size_t ld) noexcept -> void {
+  constexpr std::size_t B{detail::square_block<Ty>()};
+  alignas(kraken::detail::cache_line) Ty buffer[B * B];
+  for (std::size_t i{}; i < n; i += B) {
+    const std::size_t bi{std::min(B, n - i)};
+    // diagonal block
+    detail::transpose_leaf_block(bi, bi, data + (i * ld) + i, ld, buffer, B);
+    for (std::size_t r{}; r < bi; ++r) {
+      std::copy_n(buffer + (r * B), bi, data + ((i + r) * ld) + i);
+    }
+    for (std::size_t j{i + B}; j < n; j += B) {
+      const std::size_t bj{std::min(B, n - j)};
+      Ty *upper{data + (i * ld) + j}; // bi x bj
+      Ty *lower{data + (j * ld) + i}; // bj x bi
+      detail::transpose_leaf_block(bi, bj, upper, ld, buffer, B);
+      detail::transpose_leaf_block(bj, bi, lower, ld, upper, ld);
+      for (std::size_t r{}; r < bj; ++r) {
+        std::copy_n(buffer + (r * B), bi, lower + (r * ld));
+      }
+    }
+  }
+}
+/// @brief in-place transpose of a contiguous row-major `rows x cols` matrix
+/// into a `cols x rows` one, by following the cycles of the permutation
+/// `k -> (k * rows) mod (rows * cols - 1)`, no extra memory: a cycle is only
+/// rotated from its smallest position, found by walking it first
+template <class Ty>
+auto transpose_inplace(const std::size_t rows, const std::size_t cols,
+                       Ty *data) noexcept -> void {
+  if (rows == cols) {
+    transpose_square(rows, data, cols);
+    return;
+  }
+  if (rows <= 1UL || cols <= 1UL) {
+    return; // a vector keeps its layout
+  }
+  const std::size_t last{(rows * cols) - 1UL}; // the first and last stay
+  for (std::size_t start{1}; start < last; ++start) {
+    std::size_t at{(start * rows) % last};
+    while (at > start) {
+      at = (at * rows) % last;
+    }
+    if (at < start) {
+      continue; // already rotated from a smaller position
+    }
+    Ty carried{data[start]};
+    do {
+      at = (at * rows) % last;
+      std::swap(carried, data[at]);
+    } while (at != start);
+  }
+}
+} // namespace kraken::blas
+
+#endif // TRANSPOSE_HPP
@@ -0,0 +1,489 @@
+#ifndef DYNAMIC_MATRIX_HPP
+#define DYNAMIC_MATRIX_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "common/aligned_buffer.hpp"
+#include "common/expression.hpp" // lazy +, -
+#include "common/gemm.hpp"
+#include "common/level1.hpp"
+#include "common/level2.hpp" // kraken::blas::gemv
+#include "common/sort.hpp"   // kraken::blas::sort
+#include "common/strassen.hpp"
+#include "common/transpose.hpp"
+#include "matrix.hpp" // matrix_<>, row_col
+#include <algorithm>  // std::copy_n, std::fill_n, std::swap_ranges
+#include <cassert>    // assert
+#include <cstddef>    // std::size_t
+#include <initializer_list>
+#include <iomanip> // std::setw
+#include <iterator>
+#include <limits>  // std::numeric_limits
+#include <new>     // std::bad_array_new_length
+#include <ostream> // std::ostream
+#include <type_traits>
+#include <utility> // std::exchange
+
+//
+
+/// @brief a matrix whose row-col are known at run time only, the elements are
+/// stored in a 1D row-major buffer allocated on the heap
+template <class Ty>
+requires(!std::is_class_v<Ty>) class dynamic_matrix_ {
+public:
+  using value_type = Ty;
+  using pointer = value_type *;
+  using const_pointer = const value_type *;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using iterator = value_type *;
+  using const_iterator = const value_type *;
+  using size_type = std::size_t;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  /// @brief alignment of the buffer in bytes (one cache-line)
+  static constexpr size_type alignment{kraken::detail::cache_line};
+
+private:
+  pointer m_data{nullptr};
+  size_type m_row{};
+  size_type m_col{};
+
+  [[nodiscard]] static auto allocate(const size_type count) -> pointer {
+    return kraken::detail::aligned_allocate<value_type>(count);
+  }
+
+  static auto deallocate(pointer ptr) noexcept -> void {
+    kraken::detail::aligned_deallocate(ptr);
+  }
+
+  /// @brief element count of a `row x col` buffer, throws like `new[]` when
+  /// the byte size does not fit in a `size_type`
+  [[nodiscard]] static auto extent(const size_type row, const size_type col)
+      -> size_type {
+    constexpr size_type max{std::numeric_limits<size_type>::max() /
+                            sizeof(value_type)};
+    if (row != 0UL && col > max / row) {
+      throw std::bad_array_new_length{};
+    }
+    return row * col;
+  }
+
+public:
+  dynamic_matrix_() noexcept = default;
+
+  /// @brief creates a `row x col` matrix filled with `value`
+  dynamic_matrix_(const size_type row, const size_type col,
+                  const value_type value = value_type{})
+      : m_data{allocate(extent(row, col))}, m_row{row}, m_col{col} {
+    std::fill_n(m_data, size(), value);
+  }
+
+  /// @brief init-list constructor, missing elements are set to `0`
+  dynamic_matrix_(const size_type row, const size_type col,
+                  std::initializer_list<value_type> init)
+      : dynamic_matrix_(row, col) {
+    assert(init.size() <= size());
+    std::copy_n(init.begin(), std::min(init.size(), size()), m_data);
+  }
+
+  /// @brief copies a fixed size matrix
+  template <std::size_t ROW, std::size_t COL, class Layout>
+  explicit dynamic_matrix_(const matrix_<value_type, ROW, COL, Layout> &mat)
+      : m_data{allocate(ROW * COL)}, m_row{ROW}, m_col{COL} {
+    std::copy_n(mat.begin(), size(), m_data);
+  }
+
+  /// @brief copy constructor
+  dynamic_matrix_(const dynamic_matrix_ &copy)
+      : m_data{allocate(copy.size())}, m_row{copy.m_row}, m_col{copy.m_col} {
+    std::copy_n(copy.m_data, size(), m_data);
+  }
+
+  /// @brief move constructor, steals the buffer
+  dynamic_matrix_(dynamic_matrix_ &&move) noexcept
+      : m_data{std::exchange(move.m_data, nullptr)},
+        m_row{std::exchange(move.m_row, 0UL)},
+        m_col{std::exchange(move.m_col, 0UL)} {}
+
+  /// @brief evaluates an expression (`a + b - c + 2`) in a single pass
+  template <kraken::expr::evaluable E>
+  dynamic_matrix_(const E &expr)
+      : dynamic_matrix_(expr.row(), expr.col()) {
+    kraken::expr::assign(*this, expr);
+  }
+
+  ~dynamic_matrix_() { deallocate(m_data); }
+
+  ///
+  [[nodiscard]] auto begin() const noexcept -> const_iterator {
+    return m_data;
+  }
+  [[nodiscard]] auto end() const noexcept -> const_iterator {
+    return m_data + size();
+  }
+  [[nodiscard]] auto rbegin() const noexcept -> const_reverse_iterator {
+    return const_reverse_iterator{end()};
+  }
+  [[nodiscard]] auto rend() const noexcept -> const_reverse_iterator {
+    return const_reverse_iterator{begin()};
+  }
+  ///
+  [[nodiscard]] auto begin() noexcept -> iterator { return m_data; }
+  [[nodiscard]] auto end() noexcept -> iterator { return m_data + size(); }
+  [[nodiscard]] auto rbegin() noexcept -> reverse_iterator {
+    return reverse_iterator{end()};
+  }
+  [[nodiscard]] auto rend() noexcept -> reverse_iterator {
+    return reverse_iterator{begin()};
+  }
+  /// @methods:
+
+  /// @get: pointer to the first element
+  [[nodiscard]] auto data() noexcept -> pointer { return m_data; }
+  [[nodiscard]] auto data() const noexcept -> const_pointer { return m_data; }
+
+  /// @get: column
+  [[nodiscard]] auto col() const noexcept -> size_type { return m_col; }
+
+  /// @get: leading dimension (row stride of the buffer), rows are packed
+  [[nodiscard]] auto ld() const noexcept -> size_type { return m_col; }
+
+  /// @get: row
+  [[nodiscard]] auto row() const noexcept -> size_type { return m_row; }
+
+  /// @get: row and column
+  [[nodiscard]] auto row_col() const noexcept -> struct row_col {
+    return {m_row, m_col};
+  }
+
+  [[nodiscard]] auto size() const noexcept -> size_type {
+    return m_row * m_col;
+  }
+
+  /// @return bool `true` if it holds no elements
+  [[nodiscard]] auto empty() const noexcept -> bool { return size() == 0UL; }
+
+  /// @brief get/modify element at given row-col
+  /// @param row row-number
+  /// @param col column-number
+  /// @return reference
+  [[nodiscard]] auto at(const size_type &row, const size_type &col)
+      -> reference {
+    assert(row < m_row && col < m_col);
+    return m_data[(row * m_col) + col];
+  }
+
+  /// @brief get element at given row-col
+  /// @param row row-number
+  /// @param col column-number
+  /// @return value_type
+  [[nodiscard]] auto at(const size_type &row, const size_type &col) const
+      -> value_type {
+    assert(row < m_row && col < m_col);
+    return m_data[(row * m_col) + col];
+  }
+
+  /// @brief swaps row in given matrix
+  /// @param start which row
+  /// @param with change with row
+  auto swap_rows(const size_type &start, const size_type &with) -> void {
+    assert(start < m_row && with < m_row);
+    std::swap_ranges(m_data + (start * m_col), m_data + ((start + 1) * m_col),
+                     m_data + (with * m_col));
+  }
+
+  /// @brief swaps column in given matrix
+  /// @param start which column
+  /// @param with change with column
+  auto swap_cols(const size_type &start, const size_type &with) -> void {
+    assert(start < m_col && with < m_col);
+    for (size_type i{0}; i < m_row; ++i) {
+      std::swap(at(i, start), at(i, with));
+    }
+  }
+
+  /// @brief sorts using insertion-sort if and only-if the size IS less than 256
+  /// else `kraken::blas::sort` (radix sort for integers and IEEE floats,
+  /// runs merged in parallel with `threads != 1`)
+  /// @param order bool value `true` for ascending and `false` for descending
+  /// @param threads `0` means every hardware thread
+  /// @return nothing
+  auto sort(const bool order = true, const size_type threads = 1UL) -> void {
+    if (size() < 256UL) { // insertion-sort
+      for (size_type i{0}; i < size(); ++i) {
+        size_type j{i};
+        while (j != 0 && (order ? m_data[j - 1] > m_data[j]
+                                : m_data[j - 1] < m_data[j])) {
+          std::swap(m_data[j - 1], m_data[j]);
+          --j;
+        }
+      }
+      return;
+    }
+    kraken::blas::sort(size(), m_data, order, threads);
+  }
+
+  /// @brief changes its rows into columns and its columns into rows
+  /// (only `squared` matrices), swaps whole blocks at a time
+  /// @return nothing
+  auto transpose_squared() -> void {
+    assert(m_row == m_col);
+    kraken::blas::transpose_square(m_row, m_data, m_col);
+  }
+
+  /// @brief changes its rows into columns and its columns into rows in place,
+  /// for any shape: the elements are permuted inside the same buffer (no
+  /// extra memory) and `row, col` are swapped
+  /// @return nothing
+  auto transpose() -> void {
+    kraken::blas::transpose_inplace(m_row, m_col, m_data);
+    std::swap(m_row, m_col);
+  }
+
+  /// @brief changes its rows into columns and its columns into rows
+  /// @return a `col x row` matrix
+  [[nodiscard]] auto transpose_triangular() const -> dynamic_matrix_ {
+    dynamic_matrix_ temp(m_col, m_row);
+    kraken::blas::transpose(m_row, m_col, m_data, m_col, temp.m_data, m_row);
+    return temp;
+  }
+
+  /// @brief fills the container with a certain value
+  /// @return nothing
+  auto fill(const value_type value) -> void {
+    std::fill_n(m_data, size(), value);
+  }
+
+  /// @operators: on matrices
+  /// @brief assigns two matrices
+  /// @return matrix
+  auto operator=(const dynamic_matrix_ &other) -> dynamic_matrix_ & {
+    if (this == &other) {
+      return *this;
+    }
+    if (size() != other.size()) {
+      // allocate first, `*this` is left untouched if it throws
+      pointer data{allocate(other.size())};
+      deallocate(m_data);
+      m_data = data;
+    }
+    m_row = other.m_row;
+    m_col = other.m_col;
+    std::copy_n(other.m_data, size(), m_data);
+    return *this;
+  }
+
+  auto operator=(dynamic_matrix_ &&other) noexcept -> dynamic_matrix_ & {
+    if (this == &other) {
+      return *this;
+    }
+    deallocate(m_data);
+    m_data = std::exchange(other.m_data, nullptr);
+    m_row = std::exchange(other.m_row, 0UL);
+    m_col = std::exchange(other.m_col, 0UL);
+    return *this;
+  }
+
+  /// @brief evaluates an expression into this matrix in a single pass, the
+  /// buffer is reused when the sizes match. otherwise the expression is
+  /// evaluated into a new buffer before the old one is freed, it may be a
+  /// view of this very matrix (`m = block_view(m, 1, 1, 2, 2)`)
+  template <kraken::expr::evaluable E>
+  auto operator=(const E &expr) -> dynamic_matrix_ & {
+    if (m_row != expr.row() || m_col != expr.col()) {
+      *this = dynamic_matrix_(expr);
+      return *this;
+    }
+    kraken::expr::assign(*this, expr);
+    return *this;
+  }
+
+  template <kraken::expr::evaluable E>
+  auto operator+=(const E &expr) -> dynamic_matrix_ & {
+    kraken::expr::compound_assign<std::plus<>>(*this, expr);
+    return *this;
+  }
+
+  template <kraken::expr::evaluable E>
+  auto operator-=(const E &expr) -> dynamic_matrix_ & {
+    kraken::expr::compound_assign<std::minus<>>(*this, expr);
+    return *this;
+  }
+
+  auto operator+=(const dynamic_matrix_ &rhs) noexcept -> dynamic_matrix_ & {
+    assert(m_row == rhs.m_row && m_col == rhs.m_col);
+    for (size_type i{}; i < size(); ++i) {
+      m_data[i] += rhs.m_data[i];
+    }
+    return *this;
+  }
+
+  auto operator+=(const value_type scalar) noexcept -> dynamic_matrix_ & {
+    for (auto &&i : *this) {
+      i += scalar;
+    }
+    return *this;
+  }
+
+  auto operator-=(const dynamic_matrix_ &rhs) noexcept -> dynamic_matrix_ & {
+    assert(m_row == rhs.m_row && m_col == rhs.m_col);
+    for (size_type i{}; i < size(); ++i) {
+      m_data[i] -= rhs.m_data[i];
+    }
+    return *this;
+  }
+
+  auto operator-=(const value_type scalar) noexcept -> dynamic_matrix_ & {
+    for (auto &&i : *this) {
+      i -= scalar;
+    }
+    return *this;
+  }
+
+  auto operator*=(const value_type scalar) noexcept -> dynamic_matrix_ & {
+    kraken::blas::scal(size(), scalar, m_data, 1UL);
+    return *this;
+  }
+
+  /// @brief multiplies a matrix container with a `scalar`
+  /// @return matrix
+  friend auto operator*(dynamic_matrix_ lhs, const value_type scalar)
+      -> dynamic_matrix_ {
+    lhs *= scalar;
+    return lhs;
+  }
+
+  /// @brief hadamard (elementwise) product of two matrix containers
+  /// @return matrix
+  [[nodiscard]] auto hadamard(const dynamic_matrix_ &rhs) const
+      -> dynamic_matrix_ {
+    assert(m_row == rhs.m_row && m_col == rhs.m_col);
+    dynamic_matrix_ temp{*this};
+    kraken::blas::hadamard(size(), rhs.m_data, 1UL, temp.m_data, 1UL);
+    return temp;
+  }
+
+  /// @brief multiplies two matrix containers, `col` of a must be equal to
+  /// `row` b, a matrix times a column (or a row times a matrix) goes through
+  /// `kraken::blas::gemv`, anything else through the packed
+  /// `kraken::blas::gemm`
+  /// @return a `row x rhs.col()` matrix
+  [[nodiscard]] auto operator*(const dynamic_matrix_ &rhs) const
+      -> dynamic_matrix_ {
+    return multiply(rhs, 1UL);
+  }
+
+  /// @brief multiplies two matrix containers, splitting the result into
+  /// tiles that are computed on up to `threads` threads
+  /// @param threads `0` means every hardware thread
+  /// @return a `row x rhs.col()` matrix
+  [[nodiscard]] auto multiply(const dynamic_matrix_ &rhs,
+                              const size_type threads = 0UL) const
+      -> dynamic_matrix_ {
+    assert(m_col == rhs.m_row);
+    dynamic_matrix_ temp(m_row, rhs.m_col);
+    if (rhs.m_col == 1UL) {
+      kraken::blas::gemv(kraken::blas::op::none, m_row, m_col, value_type{1},
+                         m_data, m_col, rhs.m_data, 1UL, value_type{},
+                         temp.m_data, 1UL, threads);
+      return temp;
+    }
+    if (m_row == 1UL) { // `row * B` is `(B^T * row^T)^T`
+      kraken::blas::gemv(kraken::blas::op::trans, rhs.m_row, rhs.m_col,
+                         value_type{1}, rhs.m_data, rhs.m_col, m_data, 1UL,
+                         value_type{}, temp.m_data, 1UL, threads);
+      return temp;
+    }
+    kraken::blas::gemm(m_row, rhs.m_col, m_col, value_type{1}, m_data, m_col,
+                       rhs.m_data, rhs.m_col, value_type{}, temp.m_data,
+                       rhs.m_col, threads);
+    return temp;
+  }
+
+  /// @brief multiplies two matrix containers with Strassen-Winograd, faster
+  /// than `multiply` for large products but only accurate normwise (see
+  /// `common/strassen.hpp`)
+  /// @param cutoff products with a dimension `<= cutoff` use the blocked gemm
+  /// @param threads threads of the blocked gemm, `0` means all of them
+  /// @return a `row x rhs.col()` matrix
+  [[nodiscard]] auto
+  strassen(const dynamic_matrix_ &rhs,
+           const size_type cutoff = kraken::blas::strassen_cutoff,
+           const size_type threads = 0UL) const -> dynamic_matrix_ {
+    assert(m_col == rhs.m_row);
+    dynamic_matrix_ temp(m_row, rhs.m_col);
+    kraken::blas::strassen(m_row, rhs.m_col, m_col, value_type{1}, m_data,
+                           m_col, rhs.m_data, rhs.m_col, value_type{},
+                           temp.m_data, rhs.m_col, cutoff, threads);
+    return temp;
+  }
+
+  /// @brief get/modify an element in a given index
+  /// @param i index of the element for which data should be accessed.
+  /// @return value_type&
+  auto operator[](const size_type i) noexcept -> reference {
+    return m_data[i];
+  }
+
+  /// @brief get an element in a given index
+  /// @param i index of the element for which data should be accessed.
+  /// @return value_type
+  auto operator[](const size_type i) const noexcept -> value_type {
+    return m_data[i];
+  }
+
+  auto operator==(const dynamic_matrix_ &rhs) const noexcept -> bool {
+    return m_row == rhs.m_row && m_col == rhs.m_col &&
+           std::equal(begin(), end(), rhs.begin());
+  }
+  auto operator!=(const dynamic_matrix_ &rhs) const noexcept -> bool {
+    return !(*this == rhs);
+  }
+
+  /// @brief prints data in matrix form
+  friend auto operator<<(std::ostream &os, const dynamic_matrix_ &mat)
+      -> std::ostream & {
+    for (size_type i{}; i < mat.m_row; ++i) {
+      os << '\n';
+      for (size_type j{}; j < mat.m_col; ++j) {
+        if constexpr (std::is_floating_point_v<value_type>) {
+          os << std::setw(12);
+        }
+        os << mat.at(i, j) << ' ';
+      }
+    }
+    return os;
+  }
+}; // end of class dynamic_matrix_
+
+namespace kraken::expr {
+template <class Ty> struct is_matrix<dynamic_matrix_<Ty>> : std::true_type {};
+} // namespace kraken::expr
+
+#endif // DYNAMIC_MATRIX_HPP
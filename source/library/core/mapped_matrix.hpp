@@ -0,0 +1,273 @@
+#ifndef MAPPED_MATRIX_HPP
+#define MAPPED_MATRIX_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "blas.hpp"                // kraken::blas::viewable
+#include "common/mapped_file.hpp"  // kraken::detail::mapped_file, extent_bytes
+#include "dynamic_matrix.hpp"      // dynamic_matrix_<>
+#include "matrix_view.hpp"         // matrix_view_<>, make_view
+#include <algorithm>               // std::max
+#include <cassert>                 // assert
+#include <cstddef>                 // std::size_t
+#include <cstdint>                 // std::uint64_t
+#include <ostream>                 // std::ostream
+#include <type_traits>             // std::is_class_v
+#include <utility>                 // std::move, std::exchange
+
+//
+
+/// @brief a `row x col` matrix whose elements live in a file, stored row by
+/// row (`ld` elements apart) starting `offset` bytes into it. opening costs
+/// the same for any size, pages are read from disk on first touch and a
+/// `read_only` matrix shares the page cache with every other process that
+/// maps the same file, so it is never duplicated in memory. it has no
+/// arithmetic of its own: `view()` hands it to the kernels, views and
+/// expressions like any other matrix
+template <class Ty> requires(!std::is_class_v<Ty>) class mapped_matrix_ {
+public:
+  using value_type = Ty;
+  using size_type = std::size_t;
+  using reference = value_type &;
+  using pointer = value_type *;
+  using const_pointer = const value_type *;
+  /// @brief what an expression over the matrix materializes into
+  using result_type = dynamic_matrix_<value_type>;
+
+private:
+  kraken::detail::mapped_file m_file{};
+  pointer m_data{nullptr};
+  size_type m_row{};
+  size_type m_col{};
+  size_type m_ld{};
+
+public:
+  mapped_matrix_() noexcept = default;
+
+  /// @brief adopts a mapping, the matrix stays closed (`!is_open()`) if the
+  /// file is too small for it (or the shape too large to count in bytes) or
+  /// `offset` breaks the alignment of `Ty`
+  /// @param offset bytes before the first element (a header)
+  /// @param ld distance (in elements) between two rows, `0` means `col`
+  mapped_matrix_(kraken::detail::mapped_file file, const size_type row,
+                 const size_type col, const size_type offset = 0UL,
+                 const size_type ld = 0UL) noexcept
+      : m_row{row}, m_col{col}, m_ld{ld == 0UL ? col : ld} {
+    assert(m_ld >= m_col);
+    std::uint64_t bytes{};
+    if (kraken::detail::extent_bytes(row, col, m_ld, sizeof(value_type),
+                                     bytes) &&
+        file.is_open() && offset % alignof(value_type) == 0UL &&
+        offset <= file.size() && bytes <= file.size() - offset) {
+      m_data = reinterpret_cast<pointer>(file.data() + offset);
+      m_file = std::move(file);
+    } else {
+      m_row = m_col = m_ld = 0UL;
+    }
+  }
+
+  /// @brief maps the matrix stored in `path`
+  mapped_matrix_(const char *path, const size_type row, const size_type col,
+                 const kraken::mapping mode = kraken::mapping::read_only,
+                 const size_type offset = 0UL, const size_type ld = 0UL)
+      : mapped_matrix_(kraken::detail::mapped_file{path, mode}, row, col,
+                       offset, ld) {}
+
+  mapped_matrix_(const mapped_matrix_ &) = delete;
+  auto operator=(const mapped_matrix_ &) -> mapped_matrix_ & = delete;
+
+  /// @brief move constructor, takes the mapping and leaves `move` closed
+  mapped_matrix_(mapped_matrix_ &&move) noexcept
+      : m_file{std::move(move.m_file)},
+        m_data{std::exchange(move.m_data, nullptr)},
+        m_row{std::exchange(move.m_row, 0UL)},
+        m_col{std::exchange(move.m_col, 0UL)},
+        m_ld{std::exchange(move.m_ld, 0UL)} {}
+
+  auto operator=(mapped_matrix_ &&other) noexcept -> mapped_matrix_ & {
+    if (this == &other) {
+      return *this;
+    }
+    m_file = std::move(other.m_file);
+    m_data = std::exchange(other.m_data, nullptr);
+    m_row = std::exchange(other.m_row, 0UL);
+    m_col = std::exchange(other.m_col, 0UL);
+    m_ld = std::exchange(other.m_ld, 0UL);
+    return *this;
+  }
+
+  ~mapped_matrix_() = default;
+
+  /// @brief creates (or truncates) `path` holding a `row x col` matrix of
+  /// zeros and maps it `read_write`
+  [[nodiscard]] static auto create(const char *path, const size_type row,
+                                   const size_type col) -> mapped_matrix_ {
+    return {kraken::detail::mapped_file::create(
+                path, std::max(1UL, row * col) * sizeof(value_type)),
+            row, col};
+  }
+
+  /// @brief creates `path` holding a copy of a matrix or view, the file can
+  /// be mapped again later with the same shape
+  template <kraken::blas::viewable M>
+  [[nodiscard]] static auto create(const char *path, const M &from)
+      -> mapped_matrix_ {
+    const auto source{make_view(from)};
+    auto mapped{create(path, source.row(), source.col())};
+    if (mapped.is_open()) {
+      mapped.mutable_view() = source;
+    }
+    return mapped;
+  }
+
+  /// @get:
+  [[nodiscard]] auto is_open() const noexcept -> bool {
+    return m_data != nullptr;
+  }
+  [[nodiscard]] auto writable() const noexcept -> bool {
+    return m_file.writable();
+  }
+  [[nodiscard]] auto row() const noexcept -> size_type { return m_row; }
+  [[nodiscard]] auto col() const noexcept -> size_type { return m_col; }
+  [[nodiscard]] auto ld() const noexcept -> size_type { return m_ld; }
+  [[nodiscard]] auto size() const noexcept -> size_type {
+    return m_row * m_col;
+  }
+  [[nodiscard]] auto empty() const noexcept -> bool { return size() == 0UL; }
+  [[nodiscard]] auto data() const noexcept -> const_pointer { return m_data; }
+  /// @brief the elements for writing, only for a writable mapping
+  [[nodiscard]] auto mutable_data() noexcept -> pointer {
+    assert(writable());
+    return m_data;
+  }
+  [[nodiscard]] auto file() const noexcept
+      -> const kraken::detail::mapped_file & {
+    return m_file;
+  }
+
+  /// @brief element (row, col), read-only
+  [[nodiscard]] auto at(const size_type row, const size_type col) const
+      -> value_type {
+    assert(row < m_row && col < m_col);
+    return m_data[(row * m_ld) + col];
+  }
+
+  /// @brief element (row, col) for writing, only for a writable mapping
+  [[nodiscard]] auto at(const size_type row, const size_type col)
+      -> reference {
+    assert(writable() && row < m_row && col < m_col);
+    return m_data[(row * m_ld) + col];
+  }
+
+  /// @brief the whole matrix as a read-only view, the way into the kernels
+  [[nodiscard]] auto view() const noexcept -> matrix_view_<const value_type> {
+    return {m_data, m_row, m_col, m_ld};
+  }
+
+  /// @brief the whole matrix as a view that writes through to the mapping,
+  /// only for a writable mapping
+  [[nodiscard]] auto mutable_view() noexcept -> matrix_view_<value_type> {
+    assert(writable());
+    return {m_data, m_row, m_col, m_ld};
+  }
+
+  /// @brief copies the matrix into memory
+  [[nodiscard]] auto to_dense() const -> dynamic_matrix_<value_type> {
+    return dynamic_matrix_<value_type>(view());
+  }
+
+  /// @brief tells the kernel how the matrix is going to be read
+  auto advise(const kraken::access pattern) const noexcept -> void {
+    m_file.advise(pattern);
+  }
+
+  /// @brief starts reading rows `[first, first + count)` from disk in the
+  /// background
+  auto prefetch_rows(const size_type first, const size_type count) const
+      noexcept -> void {
+    m_file.prefetch(row_offset(first), count * m_ld * sizeof(value_type));
+  }
+
+  /// @brief starts reading the `rows x cols` block at (`row`, `col`) from disk
+  /// in the background, only the pages the block touches
+  auto prefetch_block(const size_type row, const size_type col,
+                      const size_type rows, const size_type cols) const
+      noexcept -> void {
+    assert(row + rows <= m_row && col + cols <= m_col);
+    if (cols == m_col) {
+      prefetch_rows(row, rows);
+      return;
+    }
+    for (size_type i{}; i < rows; ++i) {
+      m_file.prefetch(row_offset(row + i) + (col * sizeof(value_type)),
+                      cols * sizeof(value_type));
+    }
+  }
+
+  /// @brief drops rows `[first, first + count)` from this process' memory,
+  /// they are read again from the file when needed (a `copy_on_write` matrix
+  /// keeps them, evicting would lose its private writes)
+  auto evict_rows(const size_type first, const size_type count) const noexcept
+      -> void {
+    m_file.evict(row_offset(first), count * m_ld * sizeof(value_type));
+  }
+
+  /// @brief starts writing rows `[first, first + count)` of a `read_write`
+  /// matrix back to the file without waiting for the disk, `flush()` waits
+  auto write_back_rows(const size_type first, const size_type count) const
+      noexcept -> void {
+    m_file.write_back(row_offset(first), count * m_ld * sizeof(value_type));
+  }
+
+  /// @brief writes a `read_write` matrix back to its file
+  /// @return false if the write failed
+  auto flush() const noexcept -> bool { return m_file.flush(); }
+
+  /// @brief prints data in matrix form
+  friend auto operator<<(std::ostream &os, const mapped_matrix_ &mat)
+      -> std::ostream & {
+    return os << mat.view();
+  }
+
+private:
+  /// @brief bytes from the start of the file to row `row`
+  [[nodiscard]] auto row_offset(const size_type row) const noexcept
+      -> size_type {
+    return static_cast<size_type>(
+               reinterpret_cast<const std::byte *>(m_data) - m_file.data()) +
+           (row * m_ld * sizeof(value_type));
+  }
+}; // end of class mapped_matrix_
+
+/// @brief the matrix as a read-only view
+template <class Ty>
+[[nodiscard]] auto make_view(const mapped_matrix_<Ty> &matrix) noexcept
+    -> matrix_view_<const Ty> {
+  return matrix.view();
+}
+
+#endif // MAPPED_MATRIX_HPP
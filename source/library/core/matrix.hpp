@@ -27,7 +27,17 @@ SOFTWARE.
 
 */
 
-#include <algorithm> // std::swap
+#include "common/expression.hpp" // lazy +, -
+#include "common/gemm.hpp"       // kraken::blas::gemm
+#include "common/layout.hpp"     // kraken::layout::packed, padded
+#include "common/level1.hpp"     // kraken::blas::scal, hadamard
+#include "common/level2.hpp"     // kraken::blas::gemv
+#include "common/permute.hpp"    // kraken::blas::permute_rows, permute_cols
+#include "common/reduce.hpp"     // kraken::blas::reduce_rows, reduce_cols
+#include "common/small.hpp"      // kraken::blas::small_gemm
+#include "common/sort.hpp"       // kraken::blas::sort, order_rows
+#include "common/transpose.hpp"  // kraken::blas::transpose
+#include <algorithm>         // std::swap
 #include <array>     // std::array
 #include <cassert>   // assert
 #include <initializer_list>
@@ -35,6 +45,7 @@ SOFTWARE.
 #include <iterator>
 #include <ostream> // std::ostream
 #include <type_traits>
+#include <vector> // std::vector
 
 //
 
@@ -43,23 +54,90 @@ struct row_col {
   std::size_t col{};
 };
 
-template <class Ty, std::size_t ROW, std::size_t COL>
+/// @tparam Layout storage policy, `kraken::layout::padded<>` aligns the
+/// buffer to 64 bytes and pads every row, `kraken::layout::col_major<>`
+/// stores the columns back to back (see `common/layout.hpp`)
+template <class Ty, std::size_t ROW, std::size_t COL,
+          class Layout = kraken::layout::packed>
 requires(!std::is_class_v<Ty>) class matrix_ {
 public:
   using value_type = Ty;
+  using layout_type = Layout;
   using pointer = value_type *;
   using const_pointer = const value_type *;
   using reference = value_type &;
   using const_reference = const value_type &;
-  using iterator = value_type *;
-  using const_iterator = const value_type *;
   using size_type = std::size_t;
+  /// @brief true when the columns, not the rows, are stored back to back
+  static constexpr bool col_major{kraken::layout::is_col_major<Layout>::value};
+  /// @brief leading dimension: elements between the starts of two rows (of
+  /// two columns for a column-major layout)
+  static constexpr size_type LD{
+      Layout::template ld<Ty, col_major ? ROW : COL>};
+  /// @brief elements between (i, j) and (i + 1, j), and (i, j) and (i, j + 1)
+  static constexpr size_type RS{col_major ? 1UL : LD};
+  static constexpr size_type CS{col_major ? LD : 1UL};
+  /// @brief alignment of the buffer in bytes
+  static constexpr size_type alignment{Layout::template alignment<Ty>};
+  /// @brief the matrix holding the transpose in the same buffer, see
+  /// `transposed()`
+  using transpose_type =
+      matrix_<value_type, COL, ROW, kraken::layout::transposed_t<Layout>>;
+
+private:
+  /// @brief stored rows (columns when column-major) and their length
+  static constexpr size_type lines{col_major ? COL : ROW};
+  static constexpr size_type line{col_major ? ROW : COL};
+  /// @brief the elements are the buffer, in the order they are iterated
+  static constexpr bool contiguous{!col_major && LD == COL};
+
+public:
+  using iterator = std::conditional_t<
+      contiguous, pointer,
+      kraken::detail::strided_iterator<value_type, COL, RS, CS>>;
+  using const_iterator = std::conditional_t<
+      contiguous, const_pointer,
+      kraken::detail::strided_iterator<const value_type, COL, RS, CS>>;
   using reverse_iterator = std::reverse_iterator<iterator>;
   using const_reverse_iterator = std::reverse_iterator<const_iterator>;
   static_assert(ROW > 0UL && COL > 0UL, "ROW-COL must be greater than `0`");
+  static_assert(LD >= line, "the leading dimension is too small");
 
 private:
-  std::array<value_type, (ROW * COL)> m_data{};
+  alignas(alignment) std::array<value_type, (lines * LD)> m_data{};
+
+  /// @brief position in `m_data` of the i-th element (row by row)
+  [[nodiscard]] static constexpr auto offset(const size_type i) noexcept
+      -> size_type {
+    if constexpr (contiguous) {
+      return i;
+    } else {
+      return ((i / COL) * RS) + ((i % COL) * CS);
+    }
+  }
+
+  /// @brief position in `m_data` of element (row, col)
+  [[nodiscard]] static constexpr auto position(const size_type row,
+                                               const size_type col) noexcept
+      -> size_type {
+    return (row * RS) + (col * CS);
+  }
+
+  /// @brief `c = a * b` with the packed `gemm`, column-major buffers hold the
+  /// transposes so they compute `C^T = B^T * A^T` and stay row-major for it
+  template <class A, class B, class C>
+  static auto product(const A &a, const B &b, C &c, const size_type threads)
+      -> void {
+    if constexpr (col_major) {
+      kraken::blas::gemm(c.col(), c.row(), a.col(), value_type{1}, b.data(),
+                         b.ld(), a.data(), a.ld(), value_type{}, c.data(),
+                         c.ld(), threads);
+    } else {
+      kraken::blas::gemm(c.row(), c.col(), a.col(), value_type{1}, a.data(),
+                         a.ld(), b.data(), b.ld(), value_type{}, c.data(),
+                         c.ld(), threads);
+    }
+  }
 
 public:
   constexpr matrix_() noexcept = default;
@@ -77,7 +155,7 @@ public:
   /// @brief init-list constructor
   constexpr matrix_(const std::initializer_list<value_type> &init) noexcept {
     for (size_type j{0}; const auto &i : init) {
-      m_data.at(j) = std::move(i);
+      m_data.at(offset(j)) = std::move(i);
       ++i;
     }
   }
@@ -85,7 +163,7 @@ public:
   /// @brief init-list constructor
   constexpr matrix_(std::initializer_list<value_type> &&init) noexcept {
     for (size_type j{0}; auto &&i : init) {
-      m_data.at(j) = i;
+      m_data.at(offset(j)) = i;
       ++j;
     }
   }
@@ -94,40 +172,93 @@ public:
   template <class... T> explicit consteval matrix_(const T... args) {
     if constexpr (sizeof...(T) == 1) {
       fill(std::forward<value_type>(args)...);
-    } else {
+    } else if constexpr (contiguous) {
       m_data = {std::move(args)...};
+    } else {
+      size_type j{};
+      ((m_data[offset(j++)] = std::move(args)), ...);
     }
   }
 
+  /// @brief evaluates an expression (`a + b - c + 2`) in a single pass
+  template <kraken::expr::evaluable E>
+  constexpr matrix_(const E &expr) {
+    kraken::expr::assign(*this, expr);
+  }
+
   constexpr ~matrix_() = default;
 
   ///
+  /// padded and column-major layouts walk the elements row by row, see
+  /// `kraken::detail::strided_iterator`
   [[nodiscard]] constexpr const_iterator begin() const noexcept {
-    return m_data.begin();
+    if constexpr (contiguous) {
+      return m_data.begin();
+    } else {
+      return {m_data.data(), 0};
+    }
   }
   [[nodiscard]] constexpr const_iterator end() const noexcept {
-    return m_data.end();
+    if constexpr (contiguous) {
+      return m_data.end();
+    } else {
+      return {m_data.data(), static_cast<std::ptrdiff_t>(ROW * COL)};
+    }
   }
   [[nodiscard]] constexpr const_reverse_iterator rbegin() const noexcept {
-    return m_data.rbegin();
+    return const_reverse_iterator(end());
   }
   [[nodiscard]] constexpr const_reverse_iterator rend() const noexcept {
-    return m_data.rend();
+    return const_reverse_iterator(begin());
   }
   ///
-  [[nodiscard]] constexpr iterator begin() noexcept { return m_data.begin(); }
-  [[nodiscard]] constexpr iterator end() noexcept { return m_data.end(); }
+  [[nodiscard]] constexpr iterator begin() noexcept {
+    if constexpr (contiguous) {
+      return m_data.begin();
+    } else {
+      return {m_data.data(), 0};
+    }
+  }
+  [[nodiscard]] constexpr iterator end() noexcept {
+    if constexpr (contiguous) {
+      return m_data.end();
+    } else {
+      return {m_data.data(), static_cast<std::ptrdiff_t>(ROW * COL)};
+    }
+  }
   [[nodiscard]] constexpr reverse_iterator rbegin() noexcept {
-    return m_data.rbegin();
+    return reverse_iterator(end());
   }
   [[nodiscard]] constexpr reverse_iterator rend() noexcept {
-    return m_data.rend();
+    return reverse_iterator(begin());
   }
   /// @methods:
 
+  /// @get: pointer to the first element
+  [[nodiscard]] constexpr auto data() noexcept -> pointer {
+    return m_data.data();
+  }
+  [[nodiscard]] constexpr auto data() const noexcept -> const_pointer {
+    return m_data.data();
+  }
+
   /// @get: column
   [[nodiscard]] constexpr auto col() const -> size_type { return COL; }
 
+  /// @get: leading dimension (row stride of the buffer, column stride when
+  /// column-major)
+  [[nodiscard]] constexpr auto ld() const noexcept -> size_type { return LD; }
+
+  /// @get: distance in elements between two rows
+  [[nodiscard]] constexpr auto row_stride() const noexcept -> size_type {
+    return RS;
+  }
+
+  /// @get: distance in elements between two columns
+  [[nodiscard]] constexpr auto col_stride() const noexcept -> size_type {
+    return CS;
+  }
+
   /// @get: row
   [[nodiscard]] constexpr auto row() const -> size_type { return ROW; }
 
@@ -149,7 +280,7 @@ public:
   template <const size_type row, size_type col>
   [[nodiscard]] constexpr auto at() -> reference {
     static_assert((row >= 0 && col >= 0) && (row < ROW && col < COL));
-    return m_data[(row * COL) + col];
+    return m_data[position(row, col)];
   }
 
   /// @brief get element at given row-col
@@ -159,7 +290,7 @@ public:
   template <const size_type row, size_type col>
   [[nodiscard]] constexpr auto at() const -> value_type {
     static_assert((row >= 0 && col >= 0) && (row < ROW && col < COL));
-    return m_data[(row * COL) + col];
+    return m_data[position(row, col)];
   }
 
   /// @brief get/modify element at given row-col
@@ -168,7 +299,7 @@ public:
   /// @return reference
   [[nodiscard]] constexpr auto at(const size_type &row, const size_type &col)
       -> reference {
-    return m_data[(row * COL) + col];
+    return m_data[position(row, col)];
   }
 
   /// @brief get element at given row-col
@@ -177,7 +308,7 @@ public:
   /// @return value_type
   [[nodiscard]] constexpr auto at(const size_type &row,
                                   const size_type &col) const -> value_type {
-    return m_data[(row * COL) + col];
+    return m_data[position(row, col)];
   }
 
   /// @brief swaps row in given matrix
@@ -185,7 +316,7 @@ public:
   /// @param with change with row
   constexpr auto swap_rows(const size_type &start, const size_type &with)
       -> void {
-    for (size_type i{0}; i < ROW; ++i) {
+    for (size_type i{0}; i < COL; ++i) {
       std::swap(at(start, i), at(with, i));
     }
   }
@@ -195,22 +326,110 @@ public:
   /// @param with change with column
   constexpr auto swap_cols(const size_type &start, const size_type &with)
       -> void {
-    for (size_type i{0}; i < COL; ++i) {
+    for (size_type i{0}; i < ROW; ++i) {
       std::swap(at(i, start), at(i, with));
     }
   }
 
+  /// @brief reorders the rows, row `i` becomes the old row `perm[i]`
+  /// at run time the cycles of `perm` are followed and every row moves once
+  /// as a whole (`kraken::blas::permute_rows`)
+  /// @param perm a permutation of `[0, ROW)`
+  /// @return nothing
+  constexpr auto permute_rows(const std::array<size_type, ROW> &perm)
+      -> void {
+    if (std::is_constant_evaluated()) {
+      *this = permuted_rows(perm);
+      return;
+    }
+    if constexpr (col_major) { // the rows are the columns of the buffer
+      kraken::blas::permute_cols(lines, line, perm.data(), data(), LD);
+    } else {
+      kraken::blas::permute_rows(lines, line, perm.data(), data(), LD);
+    }
+  }
+
+  /// @brief reorders the columns, column `j` becomes the old column `perm[j]`
+  /// at run time each row is gathered through a one-row buffer
+  /// (`kraken::blas::permute_cols`)
+  /// @param perm a permutation of `[0, COL)`
+  /// @return nothing
+  constexpr auto permute_cols(const std::array<size_type, COL> &perm)
+      -> void {
+    if (std::is_constant_evaluated()) {
+      *this = permuted_cols(perm);
+      return;
+    }
+    if constexpr (col_major) { // the columns are the rows of the buffer
+      kraken::blas::permute_rows(lines, line, perm.data(), data(), LD);
+    } else {
+      kraken::blas::permute_cols(lines, line, perm.data(), data(), LD);
+    }
+  }
+
+  /// @brief `P * this`, row `i` is row `perm[i]` of this matrix
+  /// @param perm a permutation of `[0, ROW)`
+  /// @return matrix
+  [[nodiscard]] constexpr auto
+  permuted_rows(const std::array<size_type, ROW> &perm) const -> matrix_ {
+    matrix_ temp{};
+    if (!std::is_constant_evaluated()) {
+      if constexpr (col_major) {
+        kraken::blas::permute_cols(lines, line, perm.data(), data(), LD,
+                                   temp.data(), LD);
+      } else {
+        kraken::blas::permute_rows(lines, line, perm.data(), data(), LD,
+                                   temp.data(), LD);
+      }
+      return temp;
+    }
+    for (size_type i{}; i < ROW; ++i) {
+      for (size_type j{}; j < COL; ++j) {
+        temp.at(i, j) = at(perm[i], j);
+      }
+    }
+    return temp;
+  }
+
+  /// @brief `this * P^T`, column `j` is column `perm[j]` of this matrix
+  /// @param perm a permutation of `[0, COL)`
+  /// @return matrix
+  [[nodiscard]] constexpr auto
+  permuted_cols(const std::array<size_type, COL> &perm) const -> matrix_ {
+    matrix_ temp{};
+    if (!std::is_constant_evaluated()) {
+      if constexpr (col_major) {
+        kraken::blas::permute_rows(lines, line, perm.data(), data(), LD,
+                                   temp.data(), LD);
+      } else {
+        kraken::blas::permute_cols(lines, line, perm.data(), data(), LD,
+                                   temp.data(), LD);
+      }
+      return temp;
+    }
+    for (size_type i{}; i < ROW; ++i) {
+      for (size_type j{}; j < COL; ++j) {
+        temp.at(i, j) = at(i, perm[j]);
+      }
+    }
+    return temp;
+  }
+
   /// @brief sorts using insertion-sort if and only-if the size IS less than 256
-  /// else it will sort using std::sort
+  /// else at run time `kraken::blas::sort`: LSD radix sort for integers and
+  /// IEEE floats (`std::sort` for anything else), with `threads != 1` the
+  /// runs of each thread are sorted then merged in parallel
   /// @param order bool value `true` for ascending and `false` for descending
+  /// @param threads `0` means every hardware thread
   /// @return nothing
-  constexpr auto sort(const bool order = true) -> void {
+  constexpr auto sort(const bool order = true, const size_type threads = 1UL)
+      -> void {
     if (size() < 256UL) { // insertion-sort
       if (order) {
         for (size_type i{0}; i < size(); ++i) {
           size_type j{i};
-          while (j != 0 && m_data[j - 1] > m_data[j]) {
-            std::swap(m_data[j - 1], m_data[j]);
+          while (j != 0 && (*this)[j - 1] > (*this)[j]) {
+            std::swap((*this)[j - 1], (*this)[j]);
             --j;
           }
         }
@@ -218,13 +437,23 @@ public:
       }
       for (size_type i{0}; i < size(); ++i) {
         size_type j{i};
-        while (j != 0 && m_data[j - 1] < m_data[j]) {
-          std::swap(m_data[j - 1], m_data[j]);
+        while (j != 0 && (*this)[j - 1] < (*this)[j]) {
+          std::swap((*this)[j - 1], (*this)[j]);
           --j;
         }
       }
       return;
     }
+    if (!std::is_constant_evaluated()) {
+      if constexpr (contiguous) {
+        kraken::blas::sort(size(), data(), order, threads);
+      } else { // the elements are sorted in row order
+        std::vector<value_type> temp(begin(), end());
+        kraken::blas::sort(temp.size(), temp.data(), order, threads);
+        std::copy(temp.begin(), temp.end(), begin());
+      }
+      return;
+    }
     if (order) {
       std::sort(begin(), end());
       return;
@@ -232,9 +461,34 @@ public:
     std::sort(begin(), end(), std::greater<value_type>{});
   }
 
+  /// @brief sorts the rows by the key columns: `keys` first column first,
+  /// ties broken by the next ones, rows with equal keys keep their order.
+  /// the order is found on the key columns alone (radix passes for integers
+  /// and IEEE floats) then every row moves once as a whole
+  /// @param keys column indices, the most significant first
+  /// @param order bool value `true` for ascending and `false` for descending
+  /// @return nothing
+  auto sort_rows(const std::initializer_list<size_type> keys,
+                 const bool order = true) -> void {
+    assert(std::all_of(keys.begin(), keys.end(),
+                       [](const size_type key) { return key < COL; }) &&
+           "- key column out of range");
+    std::array<size_type, ROW> perm{};
+    kraken::blas::order_rows(ROW, data(), RS, CS, keys.begin(), keys.size(),
+                             perm.data(), order);
+    permute_rows(perm);
+  }
+
   /// @brief changes its rows into columns and its columns into rows
+  /// at run time it swaps whole blocks through `kraken::blas::transpose_square`
   /// @return nothing
   constexpr auto transpose_squared() -> void {
+    if constexpr (ROW == COL) {
+      if (!std::is_constant_evaluated()) {
+        kraken::blas::transpose_square(ROW, data(), LD);
+        return;
+      }
+    }
     for (size_type i{0}; i < ROW - 1; ++i) {
       for (size_type j{i + 1}; j < COL; ++j) {
         std::swap(at(i, j), at(j, i));
@@ -243,21 +497,38 @@ public:
   }
 
   /// @brief changes its rows into columns and its columns into rows
-  /// @return a tmatrix
+  /// at run time it goes through the blocked `kraken::blas::transpose`
+  /// @return a `COL x ROW` matrix_ of layout `reshaped_t<Layout>` (an
+  /// explicit `padded<LD>` is sized for this shape, not the transposed one)
   [[nodiscard]] constexpr auto transpose_triangular() const {
-    matrix_<value_type, COL, ROW> temp{};
+    matrix_<value_type, COL, ROW, kraken::layout::reshaped_t<Layout>> temp{};
+    if (!std::is_constant_evaluated()) {
+      // the buffer is a row-major `lines x line` matrix whatever the layout
+      kraken::blas::transpose(lines, line, data(), LD, temp.data(), temp.ld());
+      return temp;
+    }
     for (size_type i{}; i < ROW; ++i) {
       for (size_type j{}; j < COL; ++j) {
-        temp[(ROW * j) + i] = std::move(m_data[(COL * i) + j]);
+        temp.at(j, i) = at(i, j);
       }
     }
     return temp;
   }
 
+  /// @brief the transpose in the other layout (row-major <-> column-major):
+  /// the buffer is copied as it is, no element changes place, so it costs a
+  /// `memcpy` where `transpose_triangular()` shuffles every element
+  /// @return a `COL x ROW` matrix_ of layout `transposed_t<Layout>`
+  [[nodiscard]] constexpr auto transposed() const noexcept -> transpose_type {
+    transpose_type temp{};
+    std::copy_n(m_data.data(), m_data.size(), temp.data());
+    return temp;
+  }
+
   /// @brief fills the container with a certain value
   /// @return nothing
   constexpr auto fill(value_type &&value) -> void {
-    for (auto &i : m_data) {
+    for (auto &&i : *this) {
       i = std::move(value);
     }
   }
@@ -341,21 +612,33 @@ public:
     return *this;
   }
 
+  /// @brief evaluates an expression into this matrix in a single pass
+  template <kraken::expr::evaluable E>
+  constexpr matrix_ &operator=(const E &expr) {
+    kraken::expr::assign(*this, expr);
+    return *this;
+  }
+
+  template <kraken::expr::evaluable E>
+  constexpr matrix_ &operator+=(const E &expr) {
+    kraken::expr::compound_assign<std::plus<>>(*this, expr);
+    return *this;
+  }
+
+  template <kraken::expr::evaluable E>
+  constexpr matrix_ &operator-=(const E &expr) {
+    kraken::expr::compound_assign<std::minus<>>(*this, expr);
+    return *this;
+  }
+
   constexpr matrix_ &operator+=(const matrix_ &rhs) noexcept {
     for (size_type j{}; const auto &i : rhs) {
-      m_data[j] += i;
+      m_data[offset(j)] += i;
       ++j;
     }
     return *this;
   }
 
-  /// @brief adds two matrix containers
-  /// @return matrix
-  constexpr friend matrix_ operator+(matrix_ lhs, const matrix_ &rhs) noexcept {
-    lhs += rhs;
-    return lhs;
-  }
-
   constexpr matrix_ &operator+=(const value_type scalar) noexcept {
     for (auto &&i : *this) {
       i += scalar;
@@ -363,77 +646,191 @@ public:
     return *this;
   }
 
-  /// @brief adds a matrix containers with a scalar
-  /// @return matrix
-  constexpr friend matrix_ operator+(matrix_ lhs,
-                                     const value_type scalar) noexcept {
-    lhs += scalar;
-    return lhs;
-  }
-
   /// @brief multiplies a matrix containers with a `scalar`
   /// @return matrix
   [[nodiscard]] constexpr matrix_ &operator*(value_type val) noexcept {
+    if (!std::is_constant_evaluated()) {
+      if constexpr (LD == line) {
+        kraken::blas::scal(size(), val, data(), 1UL);
+      } else { // row by row (column by column), the padding stays `0`
+        for (size_type i{}; i < lines; ++i) {
+          kraken::blas::scal(line, val, data() + (i * LD), 1UL);
+        }
+      }
+      return *this;
+    }
     for (auto &&i : *this) {
       i *= val;
     }
     return *this;
   }
 
+  /// @brief hadamard (elementwise) product of two matrix containers, at run
+  /// time it goes through the vectorized `kraken::blas::hadamard`
+  /// @return matrix
+  [[nodiscard]] constexpr auto hadamard(const matrix_ &rhs) const noexcept
+      -> matrix_ {
+    matrix_ temp{*this};
+    if (!std::is_constant_evaluated()) {
+      if constexpr (LD == line) {
+        kraken::blas::hadamard(size(), rhs.data(), 1UL, temp.data(), 1UL);
+      } else {
+        for (size_type i{}; i < lines; ++i) {
+          kraken::blas::hadamard(line, rhs.data() + (i * LD), 1UL,
+                                 temp.data() + (i * LD), 1UL);
+        }
+      }
+      return temp;
+    }
+    for (size_type i{}; i < ROW; ++i) {
+      for (size_type j{}; j < COL; ++j) {
+        temp.at(i, j) *= rhs.at(i, j);
+      }
+    }
+    return temp;
+  }
+
   /// @brief multiplies two matrix containers
-  /// `col` of a must be equal to `row` b
+  /// `col` of a must be equal to `row` b, up to `4 x 4` the product is fully
+  /// unrolled (`kraken::blas::small_gemm`), above that it goes through the
+  /// packed `kraken::blas::gemm` at run time
+  /// a `1 x COL` times a `1 x COL` is not a matrix product, for backward
+  /// compatibility it is the elementwise product, prefer `hadamard`
   /// @return matrix
   [[nodiscard]] constexpr matrix_ operator*(const matrix_ &rhs) noexcept {
     if constexpr (ROW == 1UL) {
-      for (size_type j{}; const auto &i : rhs) {
-        m_data[j] *= i;
-        ++j;
+      return hadamard(rhs);
+    }
+    matrix_ temp{};
+    if constexpr (ROW <= kraken::blas::small_max &&
+                  COL <= kraken::blas::small_max) {
+      if constexpr (col_major) { // the buffers hold `C^T = B^T * A^T`
+        kraken::blas::small_gemm<COL, ROW, ROW>(rhs.data(), LD, data(), LD,
+                                                temp.data(), LD);
+      } else {
+        kraken::blas::small_gemm<ROW, COL, ROW>(data(), LD, rhs.data(), LD,
+                                                temp.data(), LD);
       }
-      return *this;
+      return temp;
     }
-    matrix_<value_type, ROW, COL> temp{};
-    for (size_type i{0}; i < ROW; ++i) {
-      for (size_type k{0}; k < rhs.row(); ++k) {
-        for (size_type j{0}; j < COL; ++j) {
-          temp.at(i, j) += (at(i, k) * rhs.at(k, j));
+    if (std::is_constant_evaluated()) {
+      for (size_type i{0}; i < ROW; ++i) {
+        for (size_type k{0}; k < rhs.row(); ++k) {
+          for (size_type j{0}; j < COL; ++j) {
+            temp.at(i, j) += (at(i, k) * rhs.at(k, j));
+          }
         }
       }
+      return temp;
     }
+    product(*this, rhs, temp, 1UL);
     return temp;
   }
 
   /// @brief multiplies two matrix containers
-  /// `col` of a must be equal to `row` b
+  /// `col` of a must be equal to `row` b, up to `4 x 4` the product is fully
+  /// unrolled, above that a matrix times a column (or a row times a matrix)
+  /// goes through `kraken::blas::gemv` and anything else through the packed
+  /// `kraken::blas::gemm` at run time
   /// @return matrix
   template <const size_type L>
-  [[nodiscard]] constexpr matrix_<value_type, ROW, L>
-  operator*(const matrix_<value_type, COL, L> &rhs) const noexcept {
-    matrix_<value_type, ROW, L> temp{};
-    for (size_type i{0}; i < ROW; ++i) {
-      for (size_type k{0}; k < rhs.row(); ++k) {
-        for (size_type j{0}; j < L; ++j) {
-          temp.at(i, j) += (at(i, k) * rhs.at(k, j));
+  [[nodiscard]] constexpr matrix_<value_type, ROW, L, Layout>
+  operator*(const matrix_<value_type, COL, L, Layout> &rhs) const noexcept {
+    matrix_<value_type, ROW, L, Layout> temp{};
+    if constexpr (ROW <= kraken::blas::small_max &&
+                  COL <= kraken::blas::small_max &&
+                  L <= kraken::blas::small_max) {
+      if constexpr (col_major) { // the buffers hold `C^T = B^T * A^T`
+        kraken::blas::small_gemm<L, ROW, COL>(rhs.data(), rhs.ld(), data(),
+                                              LD, temp.data(), temp.ld());
+      } else {
+        kraken::blas::small_gemm<ROW, L, COL>(data(), LD, rhs.data(),
+                                              rhs.ld(), temp.data(),
+                                              temp.ld());
+      }
+      return temp;
+    } else if constexpr (L == 1UL) {
+      // a column-major buffer holds `A^T`
+      if (!std::is_constant_evaluated()) {
+        kraken::blas::gemv(col_major ? kraken::blas::op::trans
+                                     : kraken::blas::op::none,
+                           lines, line, value_type{1}, data(), LD, rhs.data(),
+                           rhs.row_stride(), value_type{}, temp.data(),
+                           temp.row_stride());
+        return temp;
+      }
+    } else if constexpr (ROW == 1UL) {
+      // `row * B` is `(B^T * row^T)^T`
+      if (!std::is_constant_evaluated()) {
+        kraken::blas::gemv(col_major ? kraken::blas::op::none
+                                     : kraken::blas::op::trans,
+                           col_major ? L : COL, col_major ? COL : L,
+                           value_type{1}, rhs.data(), rhs.ld(), data(), CS,
+                           value_type{}, temp.data(), temp.col_stride());
+        return temp;
+      }
+    }
+    if (std::is_constant_evaluated()) {
+      for (size_type i{0}; i < ROW; ++i) {
+        for (size_type k{0}; k < rhs.row(); ++k) {
+          for (size_type j{0}; j < L; ++j) {
+            temp.at(i, j) += (at(i, k) * rhs.at(k, j));
+          }
         }
       }
+      return temp;
     }
+    product(*this, rhs, temp, 1UL);
+    return temp;
+  }
+
+  /// @brief multiplies two matrix containers, splitting the result into
+  /// tiles that are computed on up to `threads` threads
+  /// @param threads `0` means every hardware thread
+  /// @return matrix
+  template <const size_type L>
+  [[nodiscard]] auto multiply(const matrix_<value_type, COL, L, Layout> &rhs,
+                              const size_type threads = 0UL) const
+      -> matrix_<value_type, ROW, L, Layout> {
+    matrix_<value_type, ROW, L, Layout> temp{};
+    product(*this, rhs, temp, threads);
+    return temp;
+  }
+
+  /// @brief the sum, min, max or mean of every row, vectorized along the rows
+  /// (a column-major matrix streams its columns into the row accumulators)
+  /// @param threads `0` means every hardware thread
+  /// @return a `ROW x 1` matrix
+  [[nodiscard]] auto reduce_rows(const kraken::blas::reduction op,
+                                 const size_type threads = 1UL) const
+      -> matrix_<value_type, ROW, 1UL, Layout> {
+    matrix_<value_type, ROW, 1UL, Layout> temp{};
+    kraken::blas::reduce_rows(op, ROW, COL, data(), RS, CS, temp.data(),
+                              temp.row_stride(), threads);
+    return temp;
+  }
+
+  /// @brief the sum, min, max or mean of every column, the rows are read in
+  /// memory order into a band of column accumulators that stays in L1
+  /// @param threads `0` means every hardware thread
+  /// @return a `1 x COL` matrix
+  [[nodiscard]] auto reduce_cols(const kraken::blas::reduction op,
+                                 const size_type threads = 1UL) const
+      -> matrix_<value_type, 1UL, COL, Layout> {
+    matrix_<value_type, 1UL, COL, Layout> temp{};
+    kraken::blas::reduce_cols(op, ROW, COL, data(), RS, CS, temp.data(),
+                              temp.col_stride(), threads);
     return temp;
   }
 
   constexpr matrix_ &operator-=(const matrix_ &rhs) noexcept {
     for (size_type j{}; const auto &i : rhs) {
-      m_data[j] -= i;
+      m_data[offset(j)] -= i;
       ++j;
     }
     return *this;
   }
 
-  /// @brief subtructs two matrix containers
-  /// @return matrix
-  constexpr friend matrix_ operator-(matrix_ lhs, const matrix_ &rhs) noexcept {
-    lhs -= rhs;
-    return lhs;
-  }
-
   constexpr matrix_ &operator-=(const value_type scalar) noexcept {
     for (auto &&i : *this) {
       i -= scalar;
@@ -441,20 +838,12 @@ public:
     return *this;
   }
 
-  /// @brief adds a matrix containers with a scalar
-  /// @return matrix
-  constexpr friend matrix_ operator-(matrix_ lhs,
-                                     const value_type scalar) noexcept {
-    lhs -= scalar;
-    return lhs;
-  }
-
   /// @brief get/modify an element in a given index
   /// @brief Subscript access to the data contained in the %matrix
   /// @param i index of the element for which data should be accessed.
   /// @return value_type&
   constexpr value_type &operator[](const size_type i) noexcept {
-    return m_data[i];
+    return m_data[offset(i)];
   }
 
   /// @brief get an element in a given index
@@ -462,7 +851,7 @@ public:
   /// @param i index of the element for which data should be accessed.
   /// @return value_type
   constexpr value_type operator[](const size_type i) const noexcept {
-    return m_data[i];
+    return m_data[offset(i)];
   }
 
   constexpr bool operator!=(const matrix_ &rhs) const noexcept {
@@ -482,13 +871,24 @@ public:
       }
       if constexpr (std::is_floating_point_v<value_type>) {
         os << std::setw(7);
-      } else {
-        os << i << ' ';
       }
+      os << i << ' ';
       ++count;
     }
     return os;
   }
 }; // end of class matrix_
 
+/// @brief `+, -` between matrices (and scalars) build lazy expressions, see
+/// `common/expression.hpp`
+namespace kraken::expr {
+template <class Ty, std::size_t ROW, std::size_t COL, class Layout>
+struct is_matrix<matrix_<Ty, ROW, COL, Layout>> : std::true_type {};
+template <class Ty, std::size_t ROW, std::size_t COL, class Layout>
+struct fixed_shape<matrix_<Ty, ROW, COL, Layout>> : std::true_type {
+  static constexpr std::size_t row{ROW};
+  static constexpr std::size_t col{COL};
+};
+} // namespace kraken::expr
+
 #endif // MATRIX_HPP
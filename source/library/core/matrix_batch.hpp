@@ -0,0 +1,318 @@
+#ifndef MATRIX_BATCH_HPP
+#define MATRIX_BATCH_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "common/aligned_buffer.hpp"
+#include "common/gemm.hpp"  // kraken::blas::simd_bytes
+#include "common/small.hpp" // kraken::blas::small_gemm, small_adjugate
+#include "dynamic_matrix.hpp"
+#include "matrix.hpp"  // matrix_<>
+#include <algorithm>   // std::copy_n, std::fill_n
+#include <cassert>     // assert
+#include <cstddef>     // std::size_t
+#include <cstring>     // std::memcpy
+#include <span>        // std::span
+#include <type_traits> // std::is_floating_point_v
+#include <utility>     // std::index_sequence, std::exchange, std::move
+
+//
+
+namespace kraken::detail {
+
+/// @brief the vector register a batch works on, one lane per matrix
+template <class Ty> struct batch_lanes {
+#if defined(__GNUC__)
+  static constexpr std::size_t lanes{kraken::blas::simd_bytes / sizeof(Ty)};
+  using type [[gnu::vector_size(kraken::blas::simd_bytes)]] = Ty;
+#else
+  static constexpr std::size_t lanes{1UL};
+  using type = Ty;
+#endif
+};
+} // namespace kraken::detail
+
+/// @brief many small `ROW x COL` matrices stored as a structure of arrays:
+/// element (i, j) of every matrix is one contiguous, aligned "plane", so a
+/// single vector instruction works on the same element of 8 (AVX) or 16
+/// (AVX-512) float matrices at once. the kernels are the closed forms of
+/// `common/small.hpp` run on whole vectors instead of scalars
+template <class Ty, std::size_t ROW, std::size_t COL>
+requires(std::is_floating_point_v<Ty>) class matrix_batch_ {
+public:
+  using value_type = Ty;
+  using pointer = value_type *;
+  using const_pointer = const value_type *;
+  using reference = value_type &;
+  using size_type = std::size_t;
+  using matrix_type = matrix_<value_type, ROW, COL>;
+  using vector_type = typename kraken::detail::batch_lanes<value_type>::type;
+  /// @brief matrices handled by one vector instruction
+  static constexpr size_type lanes{
+      kraken::detail::batch_lanes<value_type>::lanes};
+  static_assert(ROW <= kraken::blas::small_max &&
+                    COL <= kraken::blas::small_max,
+                "- batches are for matrices of at most 4 x 4");
+
+private:
+  kraken::detail::aligned_buffer<value_type> m_data;
+  size_type m_count{};
+  /// elements in a plane, `count` rounded up to whole vectors
+  size_type m_stride{};
+
+  [[nodiscard]] static constexpr auto round_up(const size_type count) noexcept
+      -> size_type {
+    return ((count + lanes - 1UL) / lanes) * lanes;
+  }
+
+  [[nodiscard]] auto load(const size_type i, const size_type j,
+                          const size_type n) const noexcept -> vector_type {
+    vector_type v;
+    std::memcpy(&v, plane(i, j) + n, sizeof(vector_type));
+    return v;
+  }
+
+  auto store(const size_type i, const size_type j, const size_type n,
+             const vector_type &v) noexcept -> void {
+    std::memcpy(plane(i, j) + n, &v, sizeof(vector_type));
+  }
+
+  /// @brief the `n`-th group of `lanes` matrices, one vector per element
+  /// unrolled, so that the whole group can stay in registers
+  auto gather(const size_type n, vector_type *out) const noexcept -> void {
+    [&]<std::size_t... k>(std::index_sequence<k...>) {
+      ((out[k] = load(k / COL, k % COL, n)), ...);
+    }
+    (std::make_index_sequence<ROW * COL>{});
+  }
+
+  auto scatter(const size_type n, const vector_type *in) noexcept -> void {
+    [&]<std::size_t... k>(std::index_sequence<k...>) {
+      (store(k / COL, k % COL, n, in[k]), ...);
+    }
+    (std::make_index_sequence<ROW * COL>{});
+  }
+
+  template <class T, std::size_t R, std::size_t C>
+  requires(std::is_floating_point_v<T>) friend class matrix_batch_;
+
+  /// the kernels write every lane, padding included, nothing to zero
+  struct uninitialized {};
+  matrix_batch_(const size_type count, uninitialized)
+      : m_data{ROW * COL * round_up(count)}, m_count{count},
+        m_stride{round_up(count)} {}
+
+public:
+  matrix_batch_() noexcept = default;
+
+  /// @brief `count` matrices, all elements are `0`
+  explicit matrix_batch_(const size_type count)
+      : m_data{ROW * COL * round_up(count)}, m_count{count},
+        m_stride{round_up(count)} {
+    std::fill_n(m_data.data(), m_data.size(), value_type{});
+  }
+
+  /// @brief copies every matrix of `matrices` into the batch
+  explicit matrix_batch_(const std::span<const matrix_type> matrices)
+      : matrix_batch_(matrices.size()) {
+    for (size_type n{}; n < m_count; ++n) {
+      set(n, matrices[n]);
+    }
+  }
+
+  matrix_batch_(const matrix_batch_ &copy)
+      : m_data{copy.m_data.size()}, m_count{copy.m_count},
+        m_stride{copy.m_stride} {
+    std::copy_n(copy.m_data.data(), m_data.size(), m_data.data());
+  }
+
+  /// @brief move constructor, steals the buffer and leaves `move` empty
+  matrix_batch_(matrix_batch_ &&move) noexcept
+      : m_data{std::move(move.m_data)},
+        m_count{std::exchange(move.m_count, 0UL)},
+        m_stride{std::exchange(move.m_stride, 0UL)} {}
+
+  auto operator=(const matrix_batch_ &copy) -> matrix_batch_ & {
+    if (this != &copy) {
+      *this = matrix_batch_(copy);
+    }
+    return *this;
+  }
+
+  auto operator=(matrix_batch_ &&other) noexcept -> matrix_batch_ & {
+    if (this == &other) {
+      return *this;
+    }
+    m_data = std::move(other.m_data);
+    m_count = std::exchange(other.m_count, 0UL);
+    m_stride = std::exchange(other.m_stride, 0UL);
+    return *this;
+  }
+
+  ~matrix_batch_() = default;
+
+  /// @get: number of matrices
+  [[nodiscard]] auto count() const noexcept -> size_type { return m_count; }
+  [[nodiscard]] auto empty() const noexcept -> bool { return m_count == 0UL; }
+  [[nodiscard]] constexpr auto row() const noexcept -> size_type { return ROW; }
+  [[nodiscard]] constexpr auto col() const noexcept -> size_type { return COL; }
+  /// @get: distance in elements between two planes
+  [[nodiscard]] auto stride() const noexcept -> size_type { return m_stride; }
+
+  /// @brief element (i, j) of every matrix, one after the other
+  [[nodiscard]] auto plane(const size_type i, const size_type j) noexcept
+      -> pointer {
+    return m_data.data() + (((i * COL) + j) * m_stride);
+  }
+  [[nodiscard]] auto plane(const size_type i, const size_type j) const noexcept
+      -> const_pointer {
+    return m_data.data() + (((i * COL) + j) * m_stride);
+  }
+
+  /// @brief element (i, j) of the `n`-th matrix
+  [[nodiscard]] auto at(const size_type n, const size_type i,
+                        const size_type j) noexcept -> reference {
+    assert(n < m_count && i < ROW && j < COL);
+    return plane(i, j)[n];
+  }
+  [[nodiscard]] auto at(const size_type n, const size_type i,
+                        const size_type j) const noexcept -> value_type {
+    assert(n < m_count && i < ROW && j < COL);
+    return plane(i, j)[n];
+  }
+
+  /// @brief copies the `n`-th matrix out of the batch
+  [[nodiscard]] auto get(const size_type n) const noexcept -> matrix_type {
+    matrix_type temp{};
+    for (size_type i{}; i < ROW; ++i) {
+      for (size_type j{}; j < COL; ++j) {
+        temp.at(i, j) = at(n, i, j);
+      }
+    }
+    return temp;
+  }
+
+  /// @brief overwrites the `n`-th matrix of the batch
+  auto set(const size_type n, const matrix_type &matrix) noexcept -> void {
+    for (size_type i{}; i < ROW; ++i) {
+      for (size_type j{}; j < COL; ++j) {
+        at(n, i, j) = matrix.at(i, j);
+      }
+    }
+  }
+
+  /// @brief multiplies the `n`-th matrix of `this` with the `n`-th of `rhs`,
+  /// for every `n`, into the already sized `out` (no allocation)
+  /// @param rhs: a batch of `COL x L` matrices
+  /// @param out: a batch of `ROW x L` matrices, may not alias `this` or `rhs`
+  template <std::size_t L>
+  [[gnu::flatten]] auto multiply(const matrix_batch_<value_type, COL, L> &rhs,
+                matrix_batch_<value_type, ROW, L> &out) const noexcept -> void {
+    assert(m_count == rhs.count() && m_count == out.count());
+    vector_type a[ROW * COL];
+    vector_type b[COL * L];
+    vector_type c[ROW * L];
+    for (size_type n{}; n < m_stride; n += lanes) {
+      gather(n, a);
+      rhs.gather(n, b);
+      kraken::blas::small_gemm<ROW, L, COL>(a, COL, b, L, c, L);
+      out.scatter(n, c);
+    }
+  }
+
+  /// @brief multiplies the `n`-th matrix of `this` with the `n`-th of `rhs`,
+  /// for every `n`
+  /// @return a batch of `ROW x L` matrices
+  template <std::size_t L>
+  [[nodiscard]] auto
+  operator*(const matrix_batch_<value_type, COL, L> &rhs) const
+      -> matrix_batch_<value_type, ROW, L> {
+    matrix_batch_<value_type, ROW, L> temp(m_count, {});
+    multiply(rhs, temp);
+    return temp;
+  }
+
+  /// @brief transposes every matrix, only whole planes are copied
+  /// @return a batch of `COL x ROW` matrices
+  [[nodiscard]] auto transpose() const -> matrix_batch_<value_type, COL, ROW> {
+    matrix_batch_<value_type, COL, ROW> temp(m_count, {});
+    for (size_type i{}; i < ROW; ++i) {
+      for (size_type j{}; j < COL; ++j) {
+        std::copy_n(plane(i, j), m_stride, temp.plane(j, i));
+      }
+    }
+    return temp;
+  }
+
+  /// @brief determinant of every matrix (closed form)
+  /// @return a `1 x count` matrix
+  [[nodiscard, gnu::flatten]] auto determinant() const
+      -> dynamic_matrix_<value_type> {
+    static_assert(ROW == COL, "- Matrix must be squared");
+    dynamic_matrix_<value_type> result(1UL, m_count);
+    vector_type a[ROW * COL];
+    for (size_type n{}; n < m_stride; n += lanes) {
+      gather(n, a);
+      const vector_type det{kraken::blas::small_det<ROW>(a, COL)};
+      value_type lane[lanes];
+      std::memcpy(lane, &det, sizeof(vector_type));
+      for (size_type k{}; k < lanes && n + k < m_count; ++k) {
+        result.at(0UL, n + k) = lane[k];
+      }
+    }
+    return result;
+  }
+
+  /// @brief inverse of every matrix (closed form, no branch) into the already
+  /// sized `out`, a singular matrix comes out as `inf` / `nan`
+  /// @param out: may not alias `this`
+  [[gnu::flatten]] auto inverse(matrix_batch_ &out) const noexcept -> void {
+    static_assert(ROW == COL, "- Matrix must be squared");
+    assert(m_count == out.count());
+    vector_type a[ROW * COL];
+    vector_type adj[ROW * COL];
+    for (size_type n{}; n < m_stride; n += lanes) {
+      gather(n, a);
+      const vector_type det{
+          kraken::blas::small_adjugate<ROW>(a, COL, adj, COL)};
+      const vector_type inv{value_type{1} / det};
+      for (auto &&i : adj) {
+        i *= inv;
+      }
+      out.scatter(n, adj);
+    }
+  }
+
+  /// @brief inverse of every matrix, see `inverse(out)`
+  [[nodiscard]] auto inverse() const -> matrix_batch_ {
+    matrix_batch_ temp(m_count, {});
+    inverse(temp);
+    return temp;
+  }
+}; // end of class matrix_batch_
+
+#endif // MATRIX_BATCH_HPP
@@ -0,0 +1,485 @@
+#ifndef MATRIX_IO_HPP
+#define MATRIX_IO_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "blas.hpp"               // kraken::blas::viewable
+#include "common/aligned_buffer.hpp" // kraken::detail::cache_line
+#include "common/crc32c.hpp"      // kraken::io::crc32c
+#include "common/mapped_file.hpp" // kraken::detail::mapped_file, extent_bytes
+#include "dynamic_matrix.hpp"     // dynamic_matrix_<>
+#include "mapped_matrix.hpp"      // mapped_matrix_<>
+#include "matrix_view.hpp"        // matrix_view_<>, make_view
+#include <array>                  // std::array
+#include <cassert>                // assert
+#include <concepts>               // std::same_as
+#include <cstddef>                // std::size_t, std::byte
+#include <cstdint>                // std::uint8_t, std::uint32_t, std::uint64_t
+#include <cstring>                // std::memcpy
+#include <fstream>                // std::ofstream, std::ifstream
+#include <istream>                // std::istream
+#include <ostream>                // std::ostream
+#include <span>                   // std::span
+#include <type_traits>            // std::is_floating_point_v, std::is_signed_v
+#include <utility>                // std::move
+#include <vector>                 // std::vector
+
+//
+
+/// @brief a compact binary file format for matrices: a 64-byte `header`
+/// (element type, shape, storage order, alignment, CRC-32C checksums) followed
+/// by the elements, row by row, starting on an `alignment` boundary. the
+/// elements are stored exactly as they sit in memory (native byte order), so
+/// a file can be mapped and used in place
+namespace kraken::io {
+
+/// @brief element type stored in a file
+enum class dtype : std::uint8_t {
+  i8 = 1,
+  u8,
+  i16,
+  u16,
+  i32,
+  u32,
+  i64,
+  u64,
+  f32,
+  f64
+};
+
+/// @brief how the elements of a file are ordered
+enum class order : std::uint8_t { row_major };
+
+/// @brief what a reader or writer ran into, `ok` when nothing
+enum class status : std::uint8_t {
+  ok,
+  io_error,     // the file or stream could not be read or written
+  bad_header,   // not a matrix file, a foreign byte order or a newer version
+  wrong_type,   // the elements are not of the requested type
+  wrong_shape,  // a fixed-size matrix of another shape
+  truncated,    // fewer elements than the header promises
+  bad_checksum, // the elements were corrupted
+  misaligned    // an in-memory buffer too misaligned to be used in place
+};
+
+/// @brief the `dtype` of `Ty`
+template <class Ty>
+requires(std::is_arithmetic_v<Ty> && !std::same_as<Ty, bool>)
+[[nodiscard]] consteval auto dtype_of() noexcept -> dtype {
+  if constexpr (std::is_floating_point_v<Ty>) {
+    static_assert(sizeof(Ty) == 4UL || sizeof(Ty) == 8UL,
+                  "- only `float` and `double` can be stored");
+    return sizeof(Ty) == 4UL ? dtype::f32 : dtype::f64;
+  } else {
+    constexpr bool is_signed{std::is_signed_v<Ty>};
+    switch (sizeof(Ty)) {
+    case 1UL:
+      return is_signed ? dtype::i8 : dtype::u8;
+    case 2UL:
+      return is_signed ? dtype::i16 : dtype::u16;
+    case 4UL:
+      return is_signed ? dtype::i32 : dtype::u32;
+    default:
+      return is_signed ? dtype::i64 : dtype::u64;
+    }
+  }
+}
+
+/// @brief bytes of one element of `type`, `0` for an unknown type
+[[nodiscard]] constexpr auto size_of(const dtype type) noexcept -> std::size_t {
+  switch (type) {
+  case dtype::i8:
+  case dtype::u8:
+    return 1UL;
+  case dtype::i16:
+  case dtype::u16:
+    return 2UL;
+  case dtype::i32:
+  case dtype::u32:
+  case dtype::f32:
+    return 4UL;
+  case dtype::i64:
+  case dtype::u64:
+  case dtype::f64:
+    return 8UL;
+  }
+  return 0UL;
+}
+
+inline constexpr std::array<char, 8> magic{'K', 'R', 'A', 'K',
+                                           'E', 'N', 'M', 'X'};
+inline constexpr std::uint16_t version{1U};
+/// @brief written as-is, reads back as another number on a foreign byte order
+inline constexpr std::uint32_t byte_order{0x01020304U};
+
+/// @brief the first 64 bytes of a matrix file
+struct header {
+  std::array<char, 8> tag{magic};
+  std::uint16_t format{version};
+  dtype type{};
+  order storage{order::row_major};
+  std::uint32_t endian{byte_order};
+  std::uint64_t rows{};
+  std::uint64_t cols{};
+  /// elements between the starts of two rows, `>= cols`
+  std::uint64_t ld{};
+  /// bytes from the start of the header to the first element
+  std::uint64_t offset{};
+  /// the first element sits on a multiple of this (a power of two)
+  std::uint64_t alignment{};
+  /// CRC-32C of the `payload()` bytes of elements
+  std::uint32_t checksum{};
+  /// CRC-32C of this header with `header_checksum == 0`
+  std::uint32_t header_checksum{};
+
+  /// @brief bytes of elements that follow `offset`, the last row is `cols`
+  /// long. a shape too large to count in 64 bits claims every byte there is
+  [[nodiscard]] auto payload() const noexcept -> std::uint64_t {
+    std::uint64_t bytes{};
+    return kraken::detail::extent_bytes(rows, cols, ld, size_of(type), bytes)
+               ? bytes
+               : ~std::uint64_t{};
+  }
+
+  /// @brief the checksum of the header itself
+  [[nodiscard]] auto own_checksum() const noexcept -> std::uint32_t {
+    header copy{*this};
+    copy.header_checksum = 0U;
+    return crc32c(0U, &copy, sizeof(copy));
+  }
+
+  /// @brief everything a reader checks before it trusts the header
+  [[nodiscard]] auto check() const noexcept -> status {
+    const bool valid{
+        tag == magic && format == version && endian == byte_order &&
+        storage == order::row_major && size_of(type) != 0UL && ld >= cols &&
+        payload() != ~std::uint64_t{} && alignment != 0U &&
+        (alignment & (alignment - 1U)) == 0U &&
+        offset >= sizeof(header) && offset % alignment == 0U &&
+        header_checksum == own_checksum()};
+    return valid ? status::ok : status::bad_header;
+  }
+};
+static_assert(sizeof(header) == 64UL && std::is_trivially_copyable_v<header>,
+              "- the header is written byte for byte");
+
+/// @brief streams a `rows x cols` matrix into a seekable stream without
+/// holding it in memory: the elements go out row by row as they are passed
+/// in and the header (with the checksum) is written last. until `finish()`
+/// the stream holds a header that no reader accepts, so an interrupted write
+/// is never mistaken for a matrix
+template <class Ty> class writer {
+public:
+  using size_type = std::size_t;
+
+private:
+  std::ostream *m_os{nullptr};
+  header m_header{};
+  std::ostream::pos_type m_start{};
+  std::uint64_t m_written{};
+  std::uint32_t m_crc{};
+  bool m_done{false};
+
+public:
+  /// @param alignment of the first element relative to the start of the
+  /// header, a power of two (`4096` makes a mapped file page-aligned)
+  writer(std::ostream &os, const size_type rows, const size_type cols,
+         const size_type alignment = kraken::detail::cache_line)
+      : m_os{&os}, m_start{os.tellp()} {
+    assert(alignment != 0UL && (alignment & (alignment - 1UL)) == 0UL &&
+           alignment >= alignof(Ty));
+    m_header.type = dtype_of<Ty>();
+    m_header.rows = rows;
+    m_header.cols = cols;
+    m_header.ld = cols;
+    m_header.alignment = alignment;
+    m_header.offset = ((sizeof(header) + alignment - 1UL) / alignment) *
+                      alignment;
+    // a zeroed placeholder, then zeros up to the first element
+    const std::array<char, 64> zeros{};
+    for (std::uint64_t left{m_header.offset}; left > 0U;) {
+      const std::uint64_t chunk{left < zeros.size() ? left : zeros.size()};
+      os.write(zeros.data(), static_cast<std::streamsize>(chunk));
+      left -= chunk;
+    }
+  }
+
+  writer(const writer &) = delete;
+  auto operator=(const writer &) -> writer & = delete;
+
+  /// @brief finishes the file if `finish()` was never called
+  ~writer() {
+    if (!m_done) {
+      (void)finish();
+    }
+  }
+
+  /// @brief appends `count` elements, in row order
+  auto write(const Ty *data, const size_type count) -> writer & {
+    assert(!m_done && m_written + count <= m_header.rows * m_header.cols);
+    const auto bytes{count * sizeof(Ty)};
+    m_os->write(reinterpret_cast<const char *>(data),
+                static_cast<std::streamsize>(bytes));
+    m_crc = crc32c(m_crc, data, bytes);
+    m_written += count;
+    return *this;
+  }
+
+  /// @brief appends whole rows from a matrix or view with `cols` columns
+  template <kraken::blas::viewable M> auto write_rows(const M &rows) -> writer & {
+    const auto source{make_view(rows)};
+    assert(source.col() == m_header.cols);
+    std::vector<Ty> row(source.col_stride() == 1UL ? 0UL : source.col());
+    for (size_type i{}; i < source.row(); ++i) {
+      const Ty *first{source.data() + (i * source.row_stride())};
+      if (source.col_stride() != 1UL) {
+        for (size_type j{}; j < source.col(); ++j) {
+          row[j] = first[j * source.col_stride()];
+        }
+        first = row.data();
+      }
+      write(first, source.col());
+    }
+    return *this;
+  }
+
+  /// @return elements written so far
+  [[nodiscard]] auto written() const noexcept -> std::uint64_t {
+    return m_written;
+  }
+
+  /// @brief writes the header, the stream is left at the end of the matrix
+  /// @return `truncated` if fewer than `rows * cols` elements were written
+  /// (the header stays unreadable), `io_error` if the stream failed
+  auto finish() -> status {
+    if (m_done) {
+      return status::io_error;
+    }
+    m_done = true;
+    if (m_written != m_header.rows * m_header.cols) {
+      return status::truncated;
+    }
+    m_header.checksum = m_crc;
+    m_header.header_checksum = m_header.own_checksum();
+    const auto end{m_os->tellp()};
+    m_os->seekp(m_start);
+    m_os->write(reinterpret_cast<const char *>(&m_header), sizeof(header));
+    m_os->seekp(end);
+    return m_os->good() ? status::ok : status::io_error;
+  }
+}; // end of class writer
+
+/// @brief writes a matrix or view to a seekable stream
+template <kraken::blas::viewable M>
+auto save(std::ostream &os, const M &matrix,
+          const std::size_t alignment = kraken::detail::cache_line)
+    -> status {
+  using value_type = std::remove_const_t<kraken::expr::value_t<M>>;
+  const auto source{make_view(matrix)};
+  writer<value_type> out(os, source.row(), source.col(), alignment);
+  out.write_rows(source);
+  return out.finish();
+}
+
+/// @brief writes a matrix or view to the file `path`
+template <kraken::blas::viewable M>
+auto save(const char *path, const M &matrix,
+          const std::size_t alignment = kraken::detail::cache_line)
+    -> status {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    return status::io_error;
+  }
+  const status result{save(file, matrix, alignment)};
+  file.close();
+  return result == status::ok && !file ? status::io_error : result;
+}
+
+namespace detail {
+/// @brief reads and checks a header against the element type `Ty`
+template <class Ty>
+auto read_header(const std::byte *bytes, header &out) noexcept -> status {
+  std::memcpy(&out, bytes, sizeof(header));
+  if (const status result{out.check()}; result != status::ok) {
+    return result;
+  }
+  return out.type == dtype_of<Ty>() ? status::ok : status::wrong_type;
+}
+
+/// @brief checks a whole matrix file held in `bytes` against `Ty`
+template <class Ty>
+auto inspect(const std::span<const std::byte> bytes, header &head,
+             const bool verify) noexcept -> status {
+  if (bytes.size() < sizeof(header)) {
+    return status::bad_header;
+  }
+  if (const status result{read_header<Ty>(bytes.data(), head)};
+      result != status::ok) {
+    return result;
+  }
+  if (head.offset > bytes.size() ||
+      head.payload() > bytes.size() - head.offset) {
+    return status::truncated;
+  }
+  if (verify && crc32c(0U, bytes.data() + head.offset, head.payload()) !=
+                    head.checksum) {
+    return status::bad_checksum;
+  }
+  return status::ok;
+}
+
+template <class M> struct resizable : std::false_type {};
+template <class Ty>
+struct resizable<dynamic_matrix_<Ty>> : std::true_type {};
+} // namespace detail
+
+/// @brief reads a matrix from a stream into `out`, a `dynamic_matrix_<>` takes
+/// the shape of the file, a `matrix_<>` must already have it. the checksum is
+/// always verified, on failure `out` is left as it was. a seekable stream
+/// shorter than the header claims is `truncated` before anything is allocated
+template <kraken::expr::matrix_type M>
+auto load(std::istream &is, M &out) -> status {
+  using value_type = kraken::expr::value_t<M>;
+  std::array<std::byte, sizeof(header)> raw{};
+  header head{};
+  if (!is.read(reinterpret_cast<char *>(raw.data()), sizeof(header))) {
+    return status::io_error;
+  }
+  if (const status result{detail::read_header<value_type>(raw.data(), head)};
+      result != status::ok) {
+    return result;
+  }
+  const std::size_t rows{head.rows};
+  const std::size_t cols{head.cols};
+  if constexpr (!detail::resizable<M>::value) {
+    if (out.row() != rows || out.col() != cols) {
+      return status::wrong_shape;
+    }
+  }
+  // the header is trusted only as far as the stream reaches
+  if (const auto here{is.tellg()}; here != std::istream::pos_type(-1)) {
+    is.seekg(0, std::ios::end);
+    const auto left{static_cast<std::uint64_t>(is.tellg() - here)};
+    is.seekg(here);
+    const std::uint64_t skip{head.offset - sizeof(header)};
+    if (!is || skip > left || head.payload() > left - skip) {
+      return status::truncated;
+    }
+  }
+  is.ignore(static_cast<std::streamsize>(head.offset - sizeof(header)));
+  // one row of the file at a time, `ld` elements apart. no elements means
+  // nothing to read, however many empty rows the header counts
+  const std::size_t lines{head.payload() == 0U ? 0UL : rows};
+  dynamic_matrix_<value_type> temp(rows, cols);
+  std::vector<value_type> gap(lines > 1UL ? head.ld - cols : 0UL);
+  std::uint32_t crc{};
+  for (std::size_t i{}; i < lines; ++i) {
+    auto *row{temp.data() + (i * cols)};
+    is.read(reinterpret_cast<char *>(row),
+            static_cast<std::streamsize>(cols * sizeof(value_type)));
+    crc = crc32c(crc, row, cols * sizeof(value_type));
+    if (i + 1UL < lines && !gap.empty()) {
+      is.read(reinterpret_cast<char *>(gap.data()),
+              static_cast<std::streamsize>(gap.size() * sizeof(value_type)));
+      crc = crc32c(crc, gap.data(), gap.size() * sizeof(value_type));
+    }
+    if (!is) {
+      return status::truncated;
+    }
+  }
+  if (crc != head.checksum) {
+    return status::bad_checksum;
+  }
+  if constexpr (detail::resizable<M>::value) {
+    out = std::move(temp);
+  } else {
+    make_view(out) = make_view(temp);
+  }
+  return status::ok;
+}
+
+/// @brief reads the matrix file `path` into `out`
+template <kraken::expr::matrix_type M>
+auto load(const char *path, M &out) -> status {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return status::io_error;
+  }
+  return load(file, out);
+}
+
+/// @brief zero-copy load: maps the matrix file `path` and adopts the mapped
+/// pages, nothing is read until it is touched
+/// @param result set to what went wrong, the matrix is closed unless `ok`
+/// @param verify also check the checksum, which reads the whole file
+template <class Ty>
+[[nodiscard]] auto map(const char *path, status *result = nullptr,
+                       const kraken::mapping mode = kraken::mapping::read_only,
+                       const bool verify = false) -> mapped_matrix_<Ty> {
+  kraken::detail::mapped_file file{path, mode};
+  header head{};
+  const status outcome{
+      file.is_open()
+          ? detail::inspect<Ty>({file.data(), file.size()}, head, verify)
+          : status::io_error};
+  if (result != nullptr) {
+    *result = outcome;
+  }
+  if (outcome != status::ok) {
+    return {};
+  }
+  return {std::move(file), head.rows, head.cols, head.offset, head.ld};
+}
+
+/// @brief zero-copy load from memory: views the elements of a matrix file
+/// that is already in `bytes` (read by hand, received, embedded), the buffer
+/// must outlive the view
+/// @param result set to what went wrong, the view is empty unless `ok`
+/// @param verify also check the checksum
+template <class Ty>
+[[nodiscard]] auto view(const std::span<const std::byte> bytes,
+                        status *result = nullptr, const bool verify = true)
+    -> matrix_view_<const Ty> {
+  header head{};
+  status outcome{detail::inspect<Ty>(bytes, head, verify)};
+  const std::byte *first{bytes.data() + (outcome == status::ok ? head.offset
+                                                               : 0U)};
+  if (outcome == status::ok &&
+      reinterpret_cast<std::uintptr_t>(first) % alignof(Ty) != 0U) {
+    outcome = status::misaligned;
+  }
+  if (result != nullptr) {
+    *result = outcome;
+  }
+  if (outcome != status::ok) {
+    return {};
+  }
+  return {reinterpret_cast<const Ty *>(first), head.rows, head.cols, head.ld};
+}
+} // namespace kraken::io
+
+#endif // MATRIX_IO_HPP
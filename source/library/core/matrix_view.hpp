@@ -0,0 +1,321 @@
+#ifndef MATRIX_VIEW_HPP
+#define MATRIX_VIEW_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "common/expression.hpp" // lazy +, -
+#include "common/gemm.hpp"
+#include "common/level1.hpp"
+#include "dynamic_matrix.hpp" // dynamic_matrix_<>
+#include "matrix.hpp"         // matrix_<>
+#include <cassert>            // assert
+#include <cstddef>            // std::size_t, std::ptrdiff_t
+#include <iterator>           // std::forward_iterator_tag
+#include <ostream>            // std::ostream
+#include <type_traits>        // std::remove_const_t
+
+//
+
+/// @brief a non-owning window over the elements of a matrix, element (i, j)
+/// lives at `data()[i * row_stride() + j * col_stride()]` so a row, a column,
+/// a block or the transpose of a matrix are all views of the same buffer and
+/// none of them copies anything. `Ty` may be const for a read-only view.
+/// copying a view is shallow, assigning to a view writes through it
+template <class Ty>
+requires(!std::is_class_v<std::remove_const_t<Ty>>) class matrix_view_ {
+public:
+  using value_type = std::remove_const_t<Ty>;
+  using pointer = Ty *;
+  using reference = Ty &;
+  using size_type = std::size_t;
+  /// @brief what a view (or an expression over it) materializes into
+  using result_type = dynamic_matrix_<value_type>;
+
+private:
+  pointer m_data{nullptr};
+  size_type m_row{};
+  size_type m_col{};
+  size_type m_row_stride{};
+  size_type m_col_stride{1UL};
+
+public:
+  /// @brief walks the view row by row
+  class iterator {
+  private:
+    const matrix_view_ *m_view{nullptr};
+    size_type m_index{};
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = matrix_view_::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = matrix_view_::pointer;
+    using reference = matrix_view_::reference;
+
+    constexpr iterator() noexcept = default;
+    constexpr iterator(const matrix_view_ *view, const size_type index) noexcept
+        : m_view{view}, m_index{index} {}
+
+    [[nodiscard]] constexpr auto operator*() const -> reference {
+      return m_view->at(m_index / m_view->col(), m_index % m_view->col());
+    }
+    constexpr auto operator++() noexcept -> iterator & {
+      ++m_index;
+      return *this;
+    }
+    constexpr auto operator++(int) noexcept -> iterator {
+      auto temp{*this};
+      ++m_index;
+      return temp;
+    }
+    [[nodiscard]] constexpr auto operator==(const iterator &rhs) const noexcept
+        -> bool {
+      return m_index == rhs.m_index;
+    }
+  };
+
+  constexpr matrix_view_() noexcept = default;
+
+  /// @param data first element of the view
+  /// @param row number of rows
+  /// @param col number of columns
+  /// @param row_stride distance in elements between two rows
+  /// @param col_stride distance in elements between two columns
+  constexpr matrix_view_(pointer data, const size_type row, const size_type col,
+                         const size_type row_stride,
+                         const size_type col_stride = 1UL) noexcept
+      : m_data{data}, m_row{row}, m_col{col}, m_row_stride{row_stride},
+        m_col_stride{col_stride} {}
+
+  /// @brief a mutable view converts to a read-only one
+  template <class U>
+  requires(std::is_same_v<Ty, const U>) constexpr matrix_view_(
+      const matrix_view_<U> &other) noexcept
+      : m_data{other.data()}, m_row{other.row()}, m_col{other.col()},
+        m_row_stride{other.row_stride()}, m_col_stride{other.col_stride()} {}
+
+  constexpr matrix_view_(const matrix_view_ &) noexcept = default;
+
+  /// @brief copies the elements of `rhs` into the viewed matrix
+  constexpr auto operator=(const matrix_view_ &rhs) -> matrix_view_ & {
+    kraken::expr::assign(*this, rhs);
+    return *this;
+  }
+
+  /// @brief writes a matrix, a view or an expression through the view
+  template <kraken::expr::operand E>
+  constexpr auto operator=(const E &expr) -> matrix_view_ & {
+    kraken::expr::assign(*this, expr);
+    return *this;
+  }
+
+  template <kraken::expr::operand E>
+  constexpr auto operator+=(const E &expr) -> matrix_view_ & {
+    kraken::expr::compound_assign<std::plus<>>(*this, expr);
+    return *this;
+  }
+
+  template <kraken::expr::operand E>
+  constexpr auto operator-=(const E &expr) -> matrix_view_ & {
+    kraken::expr::compound_assign<std::minus<>>(*this, expr);
+    return *this;
+  }
+
+  auto operator*=(const value_type value) -> matrix_view_ & {
+    for (size_type i{}; i < m_row; ++i) {
+      kraken::blas::scal(m_col, value, m_data + (i * m_row_stride),
+                         m_col_stride);
+    }
+    return *this;
+  }
+
+  /// @brief element at (row, col), const-ness follows `Ty` not the view
+  [[nodiscard]] constexpr auto at(const size_type row,
+                                  const size_type col) const -> reference {
+    assert(row < m_row && col < m_col);
+    return m_data[row * m_row_stride + col * m_col_stride];
+  }
+
+  [[nodiscard]] constexpr auto data() const noexcept -> pointer {
+    return m_data;
+  }
+  [[nodiscard]] constexpr auto row() const noexcept -> size_type {
+    return m_row;
+  }
+  [[nodiscard]] constexpr auto col() const noexcept -> size_type {
+    return m_col;
+  }
+  [[nodiscard]] constexpr auto row_col() const noexcept -> row_col {
+    return {m_row, m_col};
+  }
+  [[nodiscard]] constexpr auto size() const noexcept -> size_type {
+    return m_row * m_col;
+  }
+  [[nodiscard]] constexpr auto empty() const noexcept -> bool {
+    return size() == 0UL;
+  }
+  [[nodiscard]] constexpr auto row_stride() const noexcept -> size_type {
+    return m_row_stride;
+  }
+  [[nodiscard]] constexpr auto col_stride() const noexcept -> size_type {
+    return m_col_stride;
+  }
+
+  [[nodiscard]] constexpr auto begin() const noexcept -> iterator {
+    return {this, 0UL};
+  }
+  [[nodiscard]] constexpr auto end() const noexcept -> iterator {
+    return {this, size()};
+  }
+
+  /// @brief the `rows` x `cols` block whose top-left element is (row, col)
+  [[nodiscard]] constexpr auto block(const size_type row, const size_type col,
+                                     const size_type rows,
+                                     const size_type cols) const
+      -> matrix_view_ {
+    assert(row + rows <= m_row && col + cols <= m_col);
+    return {m_data + row * m_row_stride + col * m_col_stride, rows, cols,
+            m_row_stride, m_col_stride};
+  }
+
+  /// @brief row `row` as a 1 x col view
+  [[nodiscard]] constexpr auto row_view(const size_type row) const
+      -> matrix_view_ {
+    return block(row, 0UL, 1UL, m_col);
+  }
+
+  /// @brief column `col` as a row x 1 view
+  [[nodiscard]] constexpr auto col_view(const size_type col) const
+      -> matrix_view_ {
+    return block(0UL, col, m_row, 1UL);
+  }
+
+  /// @brief the transpose, only the strides are swapped
+  [[nodiscard]] constexpr auto transposed() const noexcept -> matrix_view_ {
+    return {m_data, m_col, m_row, m_col_stride, m_row_stride};
+  }
+
+  template <class U>
+  [[nodiscard]] constexpr auto operator==(const matrix_view_<U> &rhs) const
+      -> bool {
+    if (m_row != rhs.row() || m_col != rhs.col()) {
+      return false;
+    }
+    for (size_type i{}; i < m_row; ++i) {
+      for (size_type j{}; j < m_col; ++j) {
+        if (at(i, j) != rhs.at(i, j)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  friend auto operator<<(std::ostream &os, const matrix_view_ &view)
+      -> std::ostream & {
+    return os << dynamic_matrix_<value_type>(view);
+  }
+}; // end of class matrix_view_
+
+namespace kraken::expr {
+template <class Ty> struct is_view<matrix_view_<Ty>> : std::true_type {};
+} // namespace kraken::expr
+
+/// @factories: views over matrix_, dynamic_matrix_ and other views
+
+/// @brief the whole matrix as a view, mutable for a mutable matrix
+template <kraken::expr::matrix_type M>
+[[nodiscard]] constexpr auto make_view(M &matrix) noexcept {
+  using view_t = matrix_view_<std::remove_pointer_t<decltype(matrix.data())>>;
+  if constexpr (requires { matrix.col_stride(); }) { // any layout
+    return view_t{matrix.data(), matrix.row(), matrix.col(),
+                  matrix.row_stride(), matrix.col_stride()};
+  } else {
+    return view_t{matrix.data(), matrix.row(), matrix.col(), matrix.ld()};
+  }
+}
+
+template <class Ty>
+[[nodiscard]] constexpr auto make_view(const matrix_view_<Ty> &view) noexcept
+    -> matrix_view_<Ty> {
+  return view;
+}
+
+/// @brief row `row` of a matrix as a 1 x col view
+template <class M>
+[[nodiscard]] constexpr auto row_view(M &matrix, const std::size_t row) {
+  return make_view(matrix).row_view(row);
+}
+
+/// @brief column `col` of a matrix as a row x 1 view
+template <class M>
+[[nodiscard]] constexpr auto col_view(M &matrix, const std::size_t col) {
+  return make_view(matrix).col_view(col);
+}
+
+/// @brief the `rows` x `cols` block of a matrix starting at (row, col)
+template <class M>
+[[nodiscard]] constexpr auto block_view(M &matrix, const std::size_t row,
+                                        const std::size_t col,
+                                        const std::size_t rows,
+                                        const std::size_t cols) {
+  return make_view(matrix).block(row, col, rows, cols);
+}
+
+/// @brief the transpose of a matrix without moving a single element
+template <class M> [[nodiscard]] constexpr auto transposed_view(M &matrix) {
+  return make_view(matrix).transposed();
+}
+
+/// @brief a product with a view on either side goes straight to the strided
+/// gemm, the operands are never copied into contiguous matrices first
+template <kraken::expr::operand L, kraken::expr::operand R>
+requires((kraken::expr::view<L> || kraken::expr::view<R>) &&
+         !kraken::expr::node<L> && !kraken::expr::node<R>)
+[[nodiscard]] auto operator*(const L &lhs, const R &rhs) {
+  using value_type = kraken::expr::value_t<L>;
+  static_assert(std::is_same_v<value_type, kraken::expr::value_t<R>>,
+                "- operands must have the same value_type");
+  const matrix_view_<const value_type> a{make_view(lhs)};
+  const matrix_view_<const value_type> b{make_view(rhs)};
+  assert(a.col() == b.row());
+  dynamic_matrix_<value_type> temp(a.row(), b.col());
+  kraken::blas::gemm(a.row(), b.col(), a.col(), value_type{1}, a.data(),
+                     a.row_stride(), a.col_stride(), b.data(), b.row_stride(),
+                     b.col_stride(), value_type{}, temp.data(), temp.col(),
+                     1UL);
+  return temp;
+}
+
+/// @brief scaling a view from the right stays lazy
+template <kraken::expr::view E>
+[[nodiscard]] constexpr auto operator*(const E &expr,
+                                       const kraken::expr::value_t<E> value) noexcept {
+  return kraken::expr::scalar<std::multiplies<>, E>{expr, value};
+}
+
+#endif // MATRIX_VIEW_HPP
@@ -29,18 +29,20 @@ SOFTWARE.
 
 #include "common/comp_decimal_point_nums.hpp" // comparing numbers with decimal point
 #include "common/newton.hpp"
+#include "banded_matrix.hpp"
 #include "matrix.hpp"
+#include "matrix_view.hpp"
 #include "numeric.hpp"
 
 namespace kraken::num_methods {
 
 /// @brief Perform's gauss-elimination
 /// @return a gauss-eliminated matrix if it was normal
-template <class Ty, std::size_t ROW, std::size_t COL>
+template <class Ty, std::size_t ROW, std::size_t COL, class Layout>
 requires(std::is_floating_point_v<Ty>)
     [[nodiscard]] constexpr auto gauss_elimination(
-        const matrix_<Ty, ROW, COL> &matrix) {
-  matrix_<Ty, ROW, COL> arr = std::move(matrix);
+        const matrix_<Ty, ROW, COL, Layout> &matrix) {
+  matrix_<Ty, ROW, COL, Layout> arr = std::move(matrix);
   Ty P{};
   for (std::size_t k{}; k < ROW; ++k) {
     if (arr.at(k, k) == 0) {
@@ -58,16 +60,108 @@ requires(std::is_floating_point_v<Ty>)
   return arr;
 }
 
+/// @brief Perform's gauss-elimination in place on the viewed elements
+/// @param view a block (or the whole) of a matrix
+template <class Ty>
+requires(std::is_floating_point_v<Ty>) constexpr auto gauss_elimination(
+    const matrix_view_<Ty> view) -> void {
+  for (std::size_t k{}; k < view.row(); ++k) {
+    if (view.at(k, k) == 0) {
+      continue;
+    }
+    for (std::size_t i{k + 1}; i < view.row(); ++i) {
+      const Ty P{view.at(i, k) / view.at(k, k)};
+      for (std::size_t j{}; j < view.col(); ++j) {
+        view.at(i, j) -= (P * view.at(k, j));
+      }
+    }
+  }
+}
+
 /// @brief Gives the determined matrix, matrix must be squared
+/// , up to `4 x 4` it is the closed form (no elimination, no branch)
 /// @return Ty
-template <class Ty, std::size_t ROW, std::size_t COL>
-[[nodiscard]] constexpr auto determined(const matrix_<Ty, ROW, COL> &matrix)
-    -> Ty {
+template <class Ty, std::size_t ROW, std::size_t COL, class Layout>
+[[nodiscard]] constexpr auto
+determined(const matrix_<Ty, ROW, COL, Layout> &matrix) -> Ty {
   static_assert(ROW == COL, "- Matrix must be squared");
-  const auto temp{gauss_elimination(matrix)};
+  if constexpr (ROW <= kraken::blas::small_max) {
+    // a column-major buffer holds the transpose, same determinant
+    return kraken::blas::small_det<ROW>(matrix.data(), matrix.ld());
+  } else {
+    const auto temp{gauss_elimination(matrix)};
+
+    Ty deter{1};
+    for (std::size_t i{0}; i < COL; ++i) {
+      deter *= temp.at(i, i);
+    }
 
-  Ty deter{1};
-  for (std::size_t i{0}; i < COL; ++i) {
+    return deter;
+  }
+}
+
+/// @brief Gives the inverse of a squared matrix
+/// , up to `4 x 4` it is the closed form (adjugate / determined), above that
+/// gauss-jordan with partial pivoting. matrix must not be singular
+/// @return matrix_<Ty, ROW, COL, Layout>
+template <class Ty, std::size_t ROW, std::size_t COL, class Layout>
+requires(std::is_floating_point_v<Ty>) [[nodiscard]] constexpr auto inverse(
+    const matrix_<Ty, ROW, COL, Layout> &matrix)
+    -> matrix_<Ty, ROW, COL, Layout> {
+  static_assert(ROW == COL, "- Matrix must be squared");
+  matrix_<Ty, ROW, COL, Layout> result{};
+  if constexpr (ROW <= kraken::blas::small_max) {
+    // the inverse of the transpose is the transpose of the inverse, so a
+    // column-major buffer is inverted as it is
+    [[maybe_unused]] const Ty deter{kraken::blas::small_inverse<ROW>(
+        matrix.data(), matrix.ld(), result.data(), result.ld())};
+    assert(deter != 0 && "- Matrix is singular");
+  } else {
+    matrix_<Ty, ROW, COL, Layout> arr{matrix};
+    for (std::size_t i{}; i < ROW; ++i) {
+      result.at(i, i) = 1;
+    }
+    const auto abs{[](const Ty val) { return val < 0 ? -val : val; }};
+    for (std::size_t k{}; k < ROW; ++k) {
+      std::size_t pivot{k};
+      for (std::size_t i{k + 1}; i < ROW; ++i) {
+        pivot = abs(arr.at(i, k)) > abs(arr.at(pivot, k)) ? i : pivot;
+      }
+      assert(arr.at(pivot, k) != 0 && "- Matrix is singular");
+      arr.swap_rows(k, pivot);
+      result.swap_rows(k, pivot);
+      const Ty inv{Ty{1} / arr.at(k, k)};
+      for (std::size_t j{}; j < COL; ++j) {
+        arr.at(k, j) *= inv;
+        result.at(k, j) *= inv;
+      }
+      for (std::size_t i{}; i < ROW; ++i) {
+        if (i == k) {
+          continue;
+        }
+        const Ty P{arr.at(i, k)};
+        for (std::size_t j{}; j < COL; ++j) {
+          arr.at(i, j) -= P * arr.at(k, j);
+          result.at(i, j) -= P * result.at(k, j);
+        }
+      }
+    }
+  }
+  return result;
+}
+
+/// @brief Gives the determined of a viewed matrix, view must be squared
+/// , the viewed elements are left untouched
+/// @return Ty
+template <class Ty>
+[[nodiscard]] auto determined(const matrix_view_<Ty> view)
+    -> std::remove_const_t<Ty> {
+  assert(view.row() == view.col() && "- Matrix must be squared");
+  dynamic_matrix_<std::remove_const_t<Ty>> temp(view);
+  gauss_elimination(make_view(temp));
+
+  std::remove_const_t<Ty> deter{1};
+  for (std::size_t i{0}; i < temp.col(); ++i) {
     deter *= temp.at(i, i);
   }
 
@@ -79,17 +173,15 @@ template <class Ty, std::size_t ROW, std::size_t COL>
 /// @param yi yi container
 /// @param x the x value in (y = a+(b*X))
 /// @return Ty
-template <class Ty, const std::size_t COL>
-[[nodiscard]] constexpr auto least_squares(matrix_<Ty, 1UL, COL> xi,
-                                           matrix_<Ty, 1UL, COL> yi, Ty x = 1)
-    -> Ty {
+template <class Ty, const std::size_t COL, class Layout>
+[[nodiscard]] constexpr auto least_squares(matrix_<Ty, 1UL, COL, Layout> xi,
+                                           matrix_<Ty, 1UL, COL, Layout> yi,
+                                           Ty x = 1) -> Ty {
   const auto sum_xi{cal::acc(static_cast<Ty>(0), xi)};
   const auto sum_yi{cal::acc(static_cast<Ty>(0), yi)};
   //
-  matrix_<Ty, 1UL, COL> xi_temp{xi};
-  const Ty sum_xi_pow2{cal::acc(static_cast<Ty>(0), std::move(xi * xi))};
-  op::restore(xi, xi_temp);
-  const Ty sum_product_xi_yi{cal::acc(static_cast<Ty>(0), std::move(xi * yi))};
+  const Ty sum_xi_pow2{cal::acc(static_cast<Ty>(0), xi.hadamard(xi))};
+  const Ty sum_product_xi_yi{cal::acc(static_cast<Ty>(0), xi.hadamard(yi))};
   //
   const Ty m{static_cast<Ty>(xi.col())};
   const Ty b{(m * sum_product_xi_yi - sum_yi * sum_xi) /
@@ -106,8 +198,10 @@ template <class Ty, const std::size_t COL>
  * @param R linear collection of right_side
  * @return nothing
  */
-template <class Ty, std::size_t ROW, std::size_t COL>
-auto change_with_R(matrix_<Ty, ROW, COL> &from, matrix_<Ty, 1, COL> R) -> void {
+template <class Ty, std::size_t ROW, std::size_t COL, class Layout,
+          class RLayout>
+auto change_with_R(matrix_<Ty, ROW, COL, Layout> &from,
+                   matrix_<Ty, 1, COL, RLayout> R) -> void {
   static std::size_t changed{};
   for (std::size_t i{}; i < COL; ++i) {
     from.at(i, changed) = R.at(0, i);
@@ -120,11 +214,12 @@ auto change_with_R(matrix_<Ty, ROW, COL> &from, matrix_<Ty, 1, COL> R) -> void {
 /// @param arr the gavin matrix
 /// @param right_side the values after =
 /// @return matrix_<Ty, 1, COL>
-template <class Ty, const size_t ROW, const size_t COL>
-auto cramer(matrix_<Ty, ROW, COL> arr, const matrix_<Ty, 1, COL> &right_side)
-    -> auto {
+template <class Ty, const size_t ROW, const size_t COL, class Layout,
+          class RLayout>
+auto cramer(matrix_<Ty, ROW, COL, Layout> arr,
+            const matrix_<Ty, 1, COL, RLayout> &right_side) -> auto {
   static_assert(ROW == COL, "- matrix must be squared");
-  const matrix_<Ty, ROW, COL> copy{arr};
+  const matrix_<Ty, ROW, COL, Layout> copy{arr};
   const Ty deter_a{determined(arr)};
   //
   matrix_<Ty, 1, COL> D;
@@ -172,19 +267,61 @@ requires(std::is_floating_point_v<A> &&std::is_floating_point_v<B>)
 /// , must call gauss_elimination
 /// @param col number of columns in matrix
 /// @return matrix<Ty, 1, COL>
-template <class Ty, std::size_t ROW, std::size_t COL>
-[[nodiscard]] constexpr auto back_substitution(const matrix_<Ty, ROW, COL> &arr)
-    -> auto {
+template <class Ty, std::size_t ROW, std::size_t COL, class Layout>
+[[nodiscard]] constexpr auto
+back_substitution(const matrix_<Ty, ROW, COL, Layout> &arr) -> auto {
   static_assert(ROW < COL, "--`col` must always be greater than `row`...");
   matrix_<Ty, 1, COL - 1> x;
   //
   for (auto i{static_cast<int64_t>(ROW - 1)}; i >= 0; --i) {
-    x.at(0, i) = {arr.at(i, COL - 1)};
-    for (auto j{static_cast<std::size_t>(i)}; j < COL - 1; ++j) {
-      x.at(0, i) -= arr.at(i, j) * x.at(0, j);
+    const auto r{static_cast<std::size_t>(i)};
+    x.at(0, r) = {arr.at(r, COL - 1)};
+    for (auto j{r + 1}; j < COL - 1; ++j) {
+      x.at(0, r) -= arr.at(r, j) * x.at(0, j);
     }
 
-    x.at(0, i) /= arr.at(i, i);
+    x.at(0, r) /= arr.at(r, r);
+  }
+  return x;
+}
+
+/// @brief back-substitution of a gauss eliminated view
+/// @return dynamic_matrix_<Ty> of 1 x (col - 1)
+template <class Ty>
+[[nodiscard]] auto back_substitution(const matrix_view_<Ty> arr) {
+  assert(arr.row() < arr.col() && "--`col` must always be greater than `row`...");
+  const auto last{arr.col() - 1};
+  dynamic_matrix_<std::remove_const_t<Ty>> x(1, last);
+  //
+  for (auto i{static_cast<int64_t>(arr.row() - 1)}; i >= 0; --i) {
+    const auto r{static_cast<std::size_t>(i)};
+    x.at(0, r) = {arr.at(r, last)};
+    for (auto j{r + 1}; j < last; ++j) {
+      x.at(0, r) -= arr.at(r, j) * x.at(0, j);
+    }
+
+    x.at(0, r) /= arr.at(r, r);
+  }
+  return x;
+}
+
+/// @brief Thomas algorithm, solves the tridiagonal `a * x = b` in `O(n)` per
+/// column of `b`, no pivoting so `a` should be diagonally dominant (use
+/// `banded_lu_` otherwise)
+/// @param a a `banded_matrix_<>` with one diagonal below and one above
+/// @param b an `n x k` matrix or view, a vector is `n x 1`
+/// @return dynamic_matrix_<Ty> of n x k
+template <class Ty, kraken::blas::viewable M>
+requires(std::is_floating_point_v<Ty>) [[nodiscard]] auto thomas(
+    const banded_matrix_<Ty> &a, const M &b) -> dynamic_matrix_<Ty> {
+  assert(a.lower() == 1 && a.upper() == 1 && b.row() == a.row());
+  dynamic_matrix_<Ty> x(make_view(b));
+  std::vector<Ty> work(a.row());
+  // a(i + 1, i), a(i, i) and a(i, i + 1) are `ld()` apart
+  const Ty *const ab{a.data()};
+  for (std::size_t j{}; j < x.col(); ++j) {
+    kraken::blas::gtsv(a.row(), ab + a.ld(), ab + 1, ab + 2, a.ld(),
+                       x.data() + j, x.col(), work.data());
   }
   return x;
 }
@@ -0,0 +1,275 @@
+#ifndef OUT_OF_CORE_HPP
+#define OUT_OF_CORE_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "common/aligned_buffer.hpp" // kraken::detail::aligned_buffer
+#include "common/gemm.hpp"           // kraken::blas::gemm
+#include "mapped_matrix.hpp"         // mapped_matrix_<>
+#include <algorithm>                 // std::min, std::max
+#include <array>                     // std::array
+#include <cassert>                   // assert
+#include <cmath>                     // std::sqrt
+#include <cstddef>                   // std::size_t
+#include <cstring>                   // std::memcpy
+#include <future>                    // std::async, std::future
+
+//
+
+namespace kraken::blas {
+
+/// @brief tile sizes of an out-of-core product: `mt x kt` tiles of `A`,
+/// `kt x nt` tiles of `B` (two of each, one in use and one loading) and one
+/// `mt x nt` tile of `C` are all it keeps in memory
+struct ooc_tiles {
+  std::size_t mt{};
+  std::size_t nt{};
+  std::size_t kt{};
+
+  /// @brief elements held in memory at once
+  [[nodiscard]] constexpr auto elements() const noexcept -> std::size_t {
+    return (2UL * ((mt * kt) + (kt * nt))) + (mt * nt);
+  }
+};
+
+/// @brief the tiles of a `m x k` by `k x n` product that fit `budget` bytes:
+/// `A` is read `n / nt` times and `B` `m / mt` times, so `kt` stays near the
+/// packing depth of `gemm` and the rest of the budget goes to `mt` and `nt`
+template <class Ty>
+[[nodiscard]] auto ooc_tiling(const std::size_t m, const std::size_t n,
+                              const std::size_t k, const std::size_t budget)
+    -> ooc_tiles {
+  const std::size_t room{std::max(budget / sizeof(Ty), 5UL)};
+  const auto root = [](const double x) {
+    return static_cast<std::size_t>(std::sqrt(x));
+  };
+  const std::size_t kt{std::max(
+      1UL, std::min({k, 2UL * gemm_blocking<Ty>::KC,
+                     root(static_cast<double>(room) / 5.)}))};
+  // the largest square `C` tile: 4 * s * kt + s * s <= room
+  const auto side{std::max(
+      1UL, root(static_cast<double>(4UL * kt * kt + room)) - 2UL * kt)};
+  std::size_t mt{std::max(1UL, std::min(m, side))};
+  std::size_t nt{std::max(1UL, std::min(n, side))};
+  // a thin operand leaves room to widen the other one
+  if (mt < side) {
+    nt = std::min(n, (room - 2UL * mt * kt) / (2UL * kt + mt));
+  } else if (nt < side) {
+    mt = std::min(m, (room - 2UL * nt * kt) / (2UL * kt + nt));
+  }
+  return {std::max(1UL, mt), std::max(1UL, nt), kt};
+}
+
+/// @brief out-of-core matrix-matrix product `C = alpha * A * B + beta * C`
+/// over file-backed matrices of any size: tiles of `A` and `B` are copied
+/// out of the mappings into at most `budget` bytes of buffers, the next pair
+/// loads on a background thread while `gemm` runs on the current one and the
+/// pair after that is already being read ahead by the kernel. every finished
+/// block of `C` rows starts going to disk at once and is dropped, like every
+/// tile of `A` and `B` after its last use, so the memory used stays near
+/// `budget` whatever the size of the files
+/// @param budget bytes of tile buffers, `ooc_tiling` tells how they are cut
+/// @param threads upper bound on the threads `gemm` uses, `0` means all
+/// @return false if writing `C` back to its file failed
+template <class Ty>
+auto out_of_core_gemm(const Ty alpha, const mapped_matrix_<Ty> &a,
+                      const mapped_matrix_<Ty> &b, const Ty beta,
+                      mapped_matrix_<Ty> &c, const std::size_t budget,
+                      const std::size_t threads = 1UL) -> bool {
+  using size_type = std::size_t;
+  assert(a.col() == b.row() && c.row() == a.row() && c.col() == b.col());
+  assert(c.writable());
+  const size_type m{a.row()};
+  const size_type n{b.col()};
+  const size_type k{a.col()};
+  if (m == 0UL || n == 0UL) {
+    return c.flush();
+  }
+  const auto [mt, nt, kt] = ooc_tiling<Ty>(m, n, k, budget);
+  const size_type tiles_m{(m + mt - 1UL) / mt};
+  const size_type tiles_n{(n + nt - 1UL) / nt};
+  // `k == 0` still takes one (empty) step per tile to apply `beta`
+  const size_type tiles_k{std::max(1UL, (k + kt - 1UL) / kt)};
+  const size_type steps{tiles_m * tiles_n * tiles_k};
+
+  // step `s` multiplies tile (i, p) of `A` by tile (p, j) of `B` into tile
+  // (i, j) of `C`, `p` runs fastest so a tile of `C` is finished in one go
+  struct step {
+    size_type i, j, p;
+    size_type rows, cols, depth;
+  };
+  const auto at = [&](const size_type s) -> step {
+    const size_type i{s / (tiles_n * tiles_k)};
+    const size_type j{(s / tiles_k) % tiles_n};
+    const size_type p{s % tiles_k};
+    return {i,
+            j,
+            p,
+            std::min(mt, m - (i * mt)),
+            std::min(nt, n - (j * nt)),
+            k == 0UL ? 0UL : std::min(kt, k - (p * kt))};
+  };
+
+  // every operand flips between two buffers, only when its tile changes: an
+  // `A` tile is reused across `j` when `k` fits one step
+  struct stream {
+    std::array<kraken::detail::aligned_buffer<Ty>, 2> buffer;
+    size_type key{~0UL};
+    size_type slot{1UL};
+  };
+  stream in_a{{kraken::detail::aligned_buffer<Ty>{mt * kt},
+               kraken::detail::aligned_buffer<Ty>{mt * kt}}};
+  stream in_b{{kraken::detail::aligned_buffer<Ty>{kt * nt},
+               kraken::detail::aligned_buffer<Ty>{kt * nt}}};
+  kraken::detail::aligned_buffer<Ty> tile_c{mt * nt};
+
+  struct plan {
+    step at;
+    size_type slot_a, slot_b;
+    bool load_a, load_b;
+  };
+  // decides (in step order) which buffers a step reads and fills
+  const auto schedule = [&](const size_type s) -> plan {
+    const step t{at(s)};
+    const size_type key_a{(t.i * tiles_k) + t.p};
+    const size_type key_b{(t.p * tiles_n) + t.j};
+    const bool load_a{key_a != in_a.key};
+    const bool load_b{key_b != in_b.key};
+    if (load_a) {
+      in_a.key = key_a;
+      in_a.slot ^= 1UL;
+    }
+    if (load_b) {
+      in_b.key = key_b;
+      in_b.slot ^= 1UL;
+    }
+    return {t, in_a.slot, in_b.slot, load_a, load_b};
+  };
+  // copies the tiles of a step out of the mappings
+  const auto fetch = [&](const plan &work) {
+    const step &t{work.at};
+    // first row of the `A` tile, its first column (the first row of the `B`
+    // tile) and the first column of the `B` tile
+    const size_type first_m{t.i * mt};
+    const size_type first_k{t.p * kt};
+    const size_type first_n{t.j * nt};
+    if (work.load_a) {
+      Ty *out{in_a.buffer[work.slot_a].data()};
+      for (size_type r{}; r < t.rows; ++r) {
+        std::memcpy(out + (r * t.depth),
+                    a.data() + ((first_m + r) * a.ld()) + first_k,
+                    t.depth * sizeof(Ty));
+      }
+    }
+    if (work.load_b) {
+      Ty *out{in_b.buffer[work.slot_b].data()};
+      for (size_type r{}; r < t.depth; ++r) {
+        std::memcpy(out + (r * t.cols),
+                    b.data() + ((first_k + r) * b.ld()) + first_n,
+                    t.cols * sizeof(Ty));
+      }
+    }
+  };
+  // asks the kernel to start reading the tiles of a step from disk
+  const auto read_ahead = [&](const step &t) {
+    if (t.depth != 0UL) {
+      a.prefetch_block(t.i * mt, t.p * kt, t.rows, t.depth);
+      b.prefetch_block(t.p * kt, t.j * nt, t.depth, t.cols);
+    }
+  };
+
+  plan current{schedule(0UL)};
+  fetch(current);
+  for (size_type s{}; s < steps; ++s) {
+    std::future<void> loading{};
+    plan next{};
+    if (s + 1UL < steps) {
+      next = schedule(s + 1UL);
+      if (s + 2UL < steps) {
+        read_ahead(at(s + 2UL));
+      }
+      loading = std::async(std::launch::async, [&fetch, &next] {
+        fetch(next);
+      });
+    }
+    const step &t{current.at};
+    const size_type row_c{t.i * mt};
+    const size_type col_c{t.j * nt};
+    Ty *out{tile_c.data()};
+    if (t.p == 0UL && beta != Ty{}) {
+      for (size_type r{}; r < t.rows; ++r) {
+        std::memcpy(out + (r * t.cols),
+                    c.data() + ((row_c + r) * c.ld()) + col_c,
+                    t.cols * sizeof(Ty));
+      }
+    }
+    gemm(t.rows, t.cols, t.depth, alpha, in_a.buffer[current.slot_a].data(),
+         t.depth, in_b.buffer[current.slot_b].data(), t.cols,
+         t.p == 0UL ? beta : Ty{1}, out, t.cols, threads);
+    if (t.p + 1UL == tiles_k) {
+      Ty *to{c.mutable_data()};
+      for (size_type r{}; r < t.rows; ++r) {
+        std::memcpy(to + ((row_c + r) * c.ld()) + col_c, out + (r * t.cols),
+                    t.cols * sizeof(Ty));
+      }
+      if (t.j + 1UL == tiles_n) {
+        c.write_back_rows(row_c, t.rows);
+        c.evict_rows(row_c, t.rows);
+        a.evict_rows(row_c, t.rows);
+      }
+    }
+    if (t.i + 1UL == tiles_m && t.j + 1UL == tiles_n) {
+      b.evict_rows(t.p * kt, t.depth);
+    }
+    if (loading.valid()) {
+      loading.get();
+    }
+    current = next;
+  }
+  return c.flush();
+}
+
+/// @brief `A * B` into a new file `path`, computed out of core
+/// @return the product mapped `read_write`, closed if the file could not be
+/// created or written
+template <class Ty>
+[[nodiscard]] auto out_of_core_gemm(const char *path,
+                                    const mapped_matrix_<Ty> &a,
+                                    const mapped_matrix_<Ty> &b,
+                                    const std::size_t budget,
+                                    const std::size_t threads = 1UL)
+    -> mapped_matrix_<Ty> {
+  auto c{mapped_matrix_<Ty>::create(path, a.row(), b.col())};
+  if (c.is_open() &&
+      !out_of_core_gemm(Ty{1}, a, b, Ty{}, c, budget, threads)) {
+    return {};
+  }
+  return c;
+}
+} // namespace kraken::blas
+
+#endif // OUT_OF_CORE_HPP
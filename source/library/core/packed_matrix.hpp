@@ -0,0 +1,290 @@
+#ifndef PACKED_MATRIX_HPP
+#define PACKED_MATRIX_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "blas.hpp" // kraken::blas::viewable
+#include "common/aligned_buffer.hpp"
+#include "common/packed.hpp"  // kraken::packed, tpmv, tpsv, spmv
+#include "dynamic_matrix.hpp" // dynamic_matrix_<>
+#include "matrix.hpp"         // matrix_<>
+#include "matrix_view.hpp"    // make_view
+#include <algorithm>          // std::copy_n, std::fill_n, std::equal
+#include <cassert>            // assert
+#include <cstddef>            // std::size_t
+#include <initializer_list>
+#include <ostream>     // std::ostream
+#include <type_traits> // std::is_same_v, std::conditional_t
+#include <utility>     // std::swap, std::exchange, std::move
+
+//
+
+/// @brief an `n x n` triangular or symmetric matrix that keeps only one
+/// triangle, `n * (n + 1) / 2` elements packed row after row (see
+/// `kraken::packed`), so it needs half the memory and half the bandwidth of a
+/// dense one
+template <class Ty, kraken::packed::shape Shape>
+requires(!std::is_class_v<Ty>) class packed_matrix_ {
+public:
+  using value_type = Ty;
+  using size_type = std::size_t;
+  using reference = value_type &;
+  using pointer = value_type *;
+  using const_pointer = const value_type *;
+  using shape_type = Shape;
+  static constexpr bool symmetric{
+      std::is_same_v<Shape, kraken::packed::symmetric>};
+  static constexpr bool upper{!std::is_same_v<Shape, kraken::packed::lower>};
+  /// @brief the triangle holding the transpose
+  using transpose_type = packed_matrix_<
+      value_type,
+      std::conditional_t<symmetric, Shape,
+                         std::conditional_t<upper, kraken::packed::lower,
+                                            kraken::packed::upper>>>;
+
+private:
+  kraken::detail::aligned_buffer<value_type> m_data;
+  size_type m_n{};
+
+  /// @brief true when `(i, j)` is inside the kept triangle
+  [[nodiscard]] static constexpr auto stored(const size_type i,
+                                             const size_type j) noexcept
+      -> bool {
+    return upper ? j >= i : j <= i;
+  }
+
+  /// @brief position of `(i, j)`, a symmetric matrix reads `(j, i)` from
+  /// the upper triangle
+  [[nodiscard]] auto offset(size_type i, size_type j) const noexcept
+      -> size_type {
+    if constexpr (symmetric) {
+      if (j < i) {
+        std::swap(i, j);
+      }
+    }
+    assert(stored(i, j));
+    return kraken::packed::offset<Shape>(m_n, i, j);
+  }
+
+  /// @brief `y = A * y` column by column, `y` is `n x k` and contiguous
+  auto apply(dynamic_matrix_<value_type> &y) const -> void {
+    if constexpr (symmetric) {
+      const dynamic_matrix_<value_type> x{y};
+      for (size_type j{}; j < y.col(); ++j) {
+        kraken::blas::spmv(m_n, value_type{1}, data(), x.data() + j, x.col(),
+                           value_type{}, y.data() + j, y.col());
+      }
+    } else {
+      for (size_type j{}; j < y.col(); ++j) {
+        kraken::blas::tpmv<Shape>(m_n, data(), y.data() + j, y.col());
+      }
+    }
+  }
+
+public:
+  packed_matrix_() noexcept = default;
+
+  /// @brief an `n x n` matrix, all elements are `0`
+  explicit packed_matrix_(const size_type n)
+      : m_data{kraken::packed::size(n)}, m_n{n} {
+    std::fill_n(m_data.data(), m_data.size(), value_type{});
+  }
+
+  /// @brief the kept triangle given row by row, `n * (n + 1) / 2` elements
+  packed_matrix_(const size_type n,
+                 const std::initializer_list<value_type> init)
+      : packed_matrix_(n) {
+    assert(init.size() == m_data.size());
+    std::copy_n(init.begin(), m_data.size(), m_data.data());
+  }
+
+  /// @brief keeps the triangle of a square `matrix_<>`, `dynamic_matrix_<>`
+  /// or view, a symmetric matrix keeps its upper triangle
+  template <kraken::blas::viewable M>
+  explicit packed_matrix_(const M &dense) : packed_matrix_(dense.row()) {
+    assert(dense.row() == dense.col());
+    const auto view{make_view(dense)};
+    for (size_type i{}; i < m_n; ++i) {
+      const size_type first{upper ? i : 0UL};
+      const size_type last{upper ? m_n : i + 1UL};
+      for (size_type j{first}; j < last; ++j) {
+        m_data.data()[kraken::packed::offset<Shape>(m_n, i, j)] = view.at(i, j);
+      }
+    }
+  }
+
+  packed_matrix_(const packed_matrix_ &copy) : packed_matrix_(copy.m_n) {
+    std::copy_n(copy.data(), m_data.size(), m_data.data());
+  }
+
+  /// @brief move constructor, steals the buffer and leaves `move` empty
+  packed_matrix_(packed_matrix_ &&move) noexcept
+      : m_data{std::move(move.m_data)}, m_n{std::exchange(move.m_n, 0UL)} {}
+
+  auto operator=(const packed_matrix_ &copy) -> packed_matrix_ & {
+    if (this != &copy) {
+      *this = packed_matrix_(copy);
+    }
+    return *this;
+  }
+
+  auto operator=(packed_matrix_ &&other) noexcept -> packed_matrix_ & {
+    if (this == &other) {
+      return *this;
+    }
+    m_data = std::move(other.m_data);
+    m_n = std::exchange(other.m_n, 0UL);
+    return *this;
+  }
+
+  ~packed_matrix_() = default;
+
+  /// @get: number of rows
+  [[nodiscard]] auto row() const noexcept -> size_type { return m_n; }
+  /// @get: number of columns
+  [[nodiscard]] auto col() const noexcept -> size_type { return m_n; }
+  /// @get: number of kept elements, `n * (n + 1) / 2`
+  [[nodiscard]] auto size() const noexcept -> size_type {
+    return m_data.size();
+  }
+  [[nodiscard]] auto empty() const noexcept -> bool { return m_n == 0UL; }
+  [[nodiscard]] auto data() noexcept -> pointer { return m_data.data(); }
+  [[nodiscard]] auto data() const noexcept -> const_pointer {
+    return m_data.data();
+  }
+
+  /// @brief get/modify an element of the kept triangle (either one for a
+  /// symmetric matrix)
+  [[nodiscard]] auto at(const size_type i, const size_type j) noexcept
+      -> reference {
+    assert(i < m_n && j < m_n);
+    return m_data.data()[offset(i, j)];
+  }
+
+  /// @brief get any element
+  /// @return value_type, `0` outside of a triangle
+  [[nodiscard]] auto at(const size_type i, const size_type j) const noexcept
+      -> value_type {
+    assert(i < m_n && j < m_n);
+    if (!symmetric && !stored(i, j)) {
+      return value_type{};
+    }
+    return m_data.data()[offset(i, j)];
+  }
+
+  /// @return the dense `dynamic_matrix_<>`
+  [[nodiscard]] auto to_dense() const -> dynamic_matrix_<value_type> {
+    dynamic_matrix_<value_type> temp(m_n, m_n);
+    for (size_type i{}; i < m_n; ++i) {
+      for (size_type j{}; j < m_n; ++j) {
+        temp.at(i, j) = at(i, j);
+      }
+    }
+    return temp;
+  }
+
+  /// @return the dense `matrix_<>`, its size must match
+  template <size_type N>
+  [[nodiscard]] auto to_matrix() const -> matrix_<value_type, N, N> {
+    assert(N == m_n);
+    matrix_<value_type, N, N> temp{};
+    for (size_type i{}; i < N; ++i) {
+      for (size_type j{}; j < N; ++j) {
+        temp.at(i, j) = at(i, j);
+      }
+    }
+    return temp;
+  }
+
+  /// @brief the transpose, `upper` becomes `lower` and the other way around
+  [[nodiscard]] auto transpose() const -> transpose_type {
+    if constexpr (symmetric) {
+      return *this;
+    } else {
+      transpose_type temp(m_n);
+      for (size_type i{}; i < m_n; ++i) {
+        for (size_type j{upper ? i : 0UL}; j < (upper ? m_n : i + 1UL); ++j) {
+          temp.at(j, i) = at(i, j);
+        }
+      }
+      return temp;
+    }
+  }
+
+  /// @brief `A * x` with the packed kernels, `x` is an `n x k` matrix or
+  /// view (a vector is `n x 1`)
+  /// @return an `n x k` matrix
+  template <kraken::blas::viewable M>
+  [[nodiscard]] auto operator*(const M &x) const
+      -> dynamic_matrix_<value_type> {
+    assert(x.row() == m_n);
+    dynamic_matrix_<value_type> temp(make_view(x));
+    apply(temp);
+    return temp;
+  }
+
+  /// @brief solves `A * X = B` by backward (`upper`) or forward (`lower`)
+  /// substitution, the diagonal must not hold a `0`
+  /// @param b an `n x k` matrix or view, a vector is `n x 1`
+  /// @return `X`, an `n x k` matrix
+  template <kraken::blas::viewable M>
+  [[nodiscard]] auto solve(const M &b) const -> dynamic_matrix_<value_type> {
+    static_assert(!symmetric, "- solve needs a triangular matrix");
+    assert(b.row() == m_n);
+    dynamic_matrix_<value_type> temp(make_view(b));
+    for (size_type j{}; j < temp.col(); ++j) {
+      kraken::blas::tpsv<Shape>(m_n, data(), temp.data() + j, temp.col());
+    }
+    return temp;
+  }
+
+  [[nodiscard]] auto operator==(const packed_matrix_ &rhs) const noexcept
+      -> bool {
+    return m_n == rhs.m_n && std::equal(data(), data() + size(), rhs.data());
+  }
+
+  /// @brief prints the dense matrix
+  friend auto operator<<(std::ostream &os, const packed_matrix_ &mat)
+      -> std::ostream & {
+    for (size_type i{}; i < mat.row(); ++i) {
+      for (size_type j{}; j < mat.col(); ++j) {
+        os << mat.at(i, j) << ' ';
+      }
+      os << '\n';
+    }
+    return os;
+  }
+}; // end of class packed_matrix_
+
+template <class Ty>
+using upper_matrix_ = packed_matrix_<Ty, kraken::packed::upper>;
+template <class Ty>
+using lower_matrix_ = packed_matrix_<Ty, kraken::packed::lower>;
+template <class Ty>
+using symmetric_matrix_ = packed_matrix_<Ty, kraken::packed::symmetric>;
+
+#endif // PACKED_MATRIX_HPP
@@ -0,0 +1,395 @@
+#ifndef SPARSE_MATRIX_HPP
+#define SPARSE_MATRIX_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "blas.hpp"              // kraken::blas::viewable
+#include "common/level1.hpp"     // kraken::blas::doti, axpyi, scal
+#include "common/thread_pool.hpp"
+#include "dynamic_matrix.hpp" // dynamic_matrix_<>
+#include "matrix.hpp"         // matrix_<>
+#include "matrix_view.hpp"    // make_view
+#include <algorithm>          // std::sort, std::lower_bound, std::fill_n
+#include <cassert>            // assert
+#include <cstddef>            // std::size_t, std::ptrdiff_t
+#include <ostream>            // std::ostream
+#include <span>               // std::span
+#include <type_traits>        // std::is_same_v, std::conditional_t
+#include <vector>
+
+//
+
+namespace kraken::sparse {
+
+/// @brief compressed sparse row: the nonzeros of each row are contiguous
+struct csr {};
+/// @brief compressed sparse column: the nonzeros of each column are contiguous
+struct csc {};
+
+/// @brief one nonzero, `(row, col, value)`
+template <class Ty> struct triplet {
+  std::size_t row{};
+  std::size_t col{};
+  Ty value{};
+};
+
+template <class Format>
+concept format = std::is_same_v<Format, csr> || std::is_same_v<Format, csc>;
+
+/// @brief below this many nonzeros the product stays on the calling thread
+inline constexpr std::size_t parallel_nonzeros{1UL << 15};
+} // namespace kraken::sparse
+
+/// @brief a matrix that only stores its nonzeros. with `csr` the "outer"
+/// dimension is the row and `indices()` holds columns, with `csc` it is the
+/// column and `indices()` holds rows. the nonzeros of outer `k` are
+/// `values()[offsets()[k] .. offsets()[k + 1])`, sorted by inner index
+template <class Ty, kraken::sparse::format Format = kraken::sparse::csr>
+requires(!std::is_class_v<Ty>) class sparse_matrix_ {
+public:
+  using value_type = Ty;
+  using size_type = std::size_t;
+  using format_type = Format;
+  static constexpr bool row_major{std::is_same_v<Format, kraken::sparse::csr>};
+  /// @brief the same matrix in the other format
+  using other_type = sparse_matrix_<
+      value_type,
+      std::conditional_t<row_major, kraken::sparse::csc, kraken::sparse::csr>>;
+
+private:
+  size_type m_row{};
+  size_type m_col{};
+  std::vector<size_type> m_offsets{0UL};
+  std::vector<size_type> m_indices{};
+  std::vector<value_type> m_values{};
+
+  [[nodiscard]] static constexpr auto outer_of(const size_type i,
+                                               const size_type j) noexcept
+      -> size_type {
+    return row_major ? i : j;
+  }
+  [[nodiscard]] static constexpr auto inner_of(const size_type i,
+                                               const size_type j) noexcept
+      -> size_type {
+    return row_major ? j : i;
+  }
+
+  /// @brief `y = alpha * A * x + beta * y` for `csr`, every row is one `doti`
+  /// so rows are independent and are split into chunks of similar nonzeros
+  auto spmv_rows(const value_type alpha, const value_type *x,
+                 const size_type incx, const value_type beta, value_type *y,
+                 const size_type incy, const size_type threads) const -> void {
+    const auto rows = [&](const size_type first, const size_type last) {
+      for (size_type i{first}; i < last; ++i) {
+        const size_type begin{m_offsets[i]};
+        const value_type sum{kraken::blas::doti(
+            m_offsets[i + 1] - begin, m_values.data() + begin,
+            m_indices.data() + begin, x, incx)};
+        // `beta == 0` overwrites `y`, even a `nan` in it
+        y[i * incy] = beta == value_type{}
+                          ? static_cast<value_type>(alpha * sum)
+                          : static_cast<value_type>((alpha * sum) +
+                                                    (beta * y[i * incy]));
+      }
+    };
+    auto &pool{kraken::detail::thread_pool::instance()};
+    const size_type workers{threads == 0UL ? pool.concurrency() : threads};
+    if (workers <= 1UL || nonzeros() < kraken::sparse::parallel_nonzeros) {
+      rows(0UL, m_row);
+      return;
+    }
+    // a few chunks per thread, cut where the running count of nonzeros
+    // crosses a multiple of `nonzeros() / chunks`
+    const size_type chunks{std::min(4UL * workers, m_row)};
+    pool.parallel_for(chunks, workers, [&](const size_type chunk) {
+      const auto cut = [&](const size_type c) -> size_type {
+        if (c == chunks) {
+          return m_row;
+        }
+        const auto it{std::lower_bound(m_offsets.begin(), m_offsets.end() - 1,
+                                       (nonzeros() / chunks) * c)};
+        return static_cast<size_type>(it - m_offsets.begin());
+      };
+      rows(cut(chunk), cut(chunk + 1UL));
+    });
+  }
+
+  /// @brief `y = alpha * A * x + beta * y` for `csc`, every column scatters
+  /// into `y` with `axpyi`, so it runs on the calling thread
+  auto spmv_cols(const value_type alpha, const value_type *x,
+                 const size_type incx, const value_type beta, value_type *y,
+                 const size_type incy) const -> void {
+    if (beta == value_type{}) {
+      for (size_type i{}; i < m_row; ++i) {
+        y[i * incy] = value_type{};
+      }
+    } else {
+      kraken::blas::scal(m_row, beta, y, incy);
+    }
+    for (size_type j{}; j < m_col; ++j) {
+      const size_type begin{m_offsets[j]};
+      kraken::blas::axpyi(m_offsets[j + 1] - begin,
+                          static_cast<value_type>(alpha * x[j * incx]),
+                          m_values.data() + begin, m_indices.data() + begin, y,
+                          incy);
+    }
+  }
+
+  template <class T, kraken::sparse::format F>
+  requires(!std::is_class_v<T>) friend class sparse_matrix_;
+
+public:
+  sparse_matrix_() noexcept = default;
+
+  /// @brief a `row x col` matrix without nonzeros
+  sparse_matrix_(const size_type row, const size_type col)
+      : m_row{row}, m_col{col}, m_offsets(outer_of(row, col) + 1UL, 0UL) {}
+
+  /// @brief builds the matrix from `(row, col, value)` triplets given in any
+  /// order, values of the same position are summed
+  sparse_matrix_(
+      const size_type row, const size_type col,
+      const std::span<const kraken::sparse::triplet<value_type>> triplets)
+      : sparse_matrix_(row, col) {
+    // counting sort on the outer index, then each outer is sorted by inner
+    std::vector<size_type> order(triplets.size());
+    std::vector<size_type> start(m_offsets.size() + 1UL, 0UL);
+    for (auto &&t : triplets) {
+      assert(t.row < m_row && t.col < m_col);
+      ++start[outer_of(t.row, t.col) + 2UL];
+    }
+    for (size_type k{2UL}; k < start.size(); ++k) {
+      start[k] += start[k - 1];
+    }
+    for (size_type n{}; n < triplets.size(); ++n) {
+      const auto &t{triplets[n]};
+      order[start[outer_of(t.row, t.col) + 1UL]++] = n;
+    }
+    m_indices.reserve(triplets.size());
+    m_values.reserve(triplets.size());
+    const auto inner = [&](const size_type n) {
+      return inner_of(triplets[n].row, triplets[n].col);
+    };
+    for (size_type k{}; k + 1UL < m_offsets.size(); ++k) {
+      const auto first{order.begin() + static_cast<std::ptrdiff_t>(start[k])};
+      const auto last{order.begin() +
+                      static_cast<std::ptrdiff_t>(start[k + 1])};
+      std::sort(first, last, [&](const size_type a, const size_type b) {
+        return inner(a) < inner(b);
+      });
+      for (auto it{first}; it != last; ++it) {
+        if (m_indices.size() > m_offsets[k] && m_indices.back() == inner(*it)) {
+          m_values.back() += triplets[*it].value;
+          continue;
+        }
+        m_indices.push_back(inner(*it));
+        m_values.push_back(triplets[*it].value);
+      }
+      m_offsets[k + 1] = m_indices.size();
+    }
+  }
+
+  /// @brief keeps the nonzeros of a dense `matrix_<>`, `dynamic_matrix_<>` or
+  /// view
+  template <kraken::blas::viewable M>
+  explicit sparse_matrix_(const M &dense)
+      : sparse_matrix_(dense.row(), dense.col()) {
+    const auto view{make_view(dense)};
+    const size_type outer{m_offsets.size() - 1UL};
+    const size_type inner{row_major ? m_col : m_row};
+    for (size_type k{}; k < outer; ++k) {
+      for (size_type n{}; n < inner; ++n) {
+        const value_type v{row_major ? view.at(k, n) : view.at(n, k)};
+        if (v != value_type{}) {
+          m_indices.push_back(n);
+          m_values.push_back(v);
+        }
+      }
+      m_offsets[k + 1] = m_indices.size();
+    }
+  }
+
+  /// @brief converts between `csr` and `csc`, a counting sort in
+  /// `O(nonzeros + row + col)`
+  template <kraken::sparse::format F>
+  requires(!std::is_same_v<F, Format>) explicit sparse_matrix_(
+      const sparse_matrix_<value_type, F> &other)
+      : sparse_matrix_(other.m_row, other.m_col) {
+    m_indices.resize(other.nonzeros());
+    m_values.resize(other.nonzeros());
+    for (auto &&i : other.m_indices) {
+      ++m_offsets[i + 1];
+    }
+    for (size_type k{1UL}; k < m_offsets.size(); ++k) {
+      m_offsets[k] += m_offsets[k - 1];
+    }
+    std::vector<size_type> next(m_offsets.begin(), m_offsets.end() - 1);
+    // walking `other` in outer order keeps every new outer sorted
+    for (size_type k{}; k + 1UL < other.m_offsets.size(); ++k) {
+      for (size_type n{other.m_offsets[k]}; n < other.m_offsets[k + 1]; ++n) {
+        const size_type dst{next[other.m_indices[n]]++};
+        m_indices[dst] = k;
+        m_values[dst] = other.m_values[n];
+      }
+    }
+  }
+
+  /// @get: number of rows
+  [[nodiscard]] auto row() const noexcept -> size_type { return m_row; }
+  /// @get: number of columns
+  [[nodiscard]] auto col() const noexcept -> size_type { return m_col; }
+  /// @get: number of stored elements
+  [[nodiscard]] auto nonzeros() const noexcept -> size_type {
+    return m_values.size();
+  }
+  [[nodiscard]] auto empty() const noexcept -> bool {
+    return m_row == 0UL || m_col == 0UL;
+  }
+  /// @get: `outer + 1` offsets into `indices()` and `values()`
+  [[nodiscard]] auto offsets() const noexcept -> std::span<const size_type> {
+    return m_offsets;
+  }
+  /// @get: inner index (column for `csr`, row for `csc`) of every nonzero
+  [[nodiscard]] auto indices() const noexcept -> std::span<const size_type> {
+    return m_indices;
+  }
+  [[nodiscard]] auto values() const noexcept -> std::span<const value_type> {
+    return m_values;
+  }
+  [[nodiscard]] auto values() noexcept -> std::span<value_type> {
+    return m_values;
+  }
+
+  /// @brief element `(row, col)`, a binary search in its row (or column)
+  /// @return value_type, `0` when nothing is stored there
+  [[nodiscard]] auto at(const size_type row, const size_type col) const noexcept
+      -> value_type {
+    assert(row < m_row && col < m_col);
+    const size_type k{outer_of(row, col)};
+    const auto first{m_indices.begin() +
+                     static_cast<std::ptrdiff_t>(m_offsets[k])};
+    const auto last{m_indices.begin() +
+                    static_cast<std::ptrdiff_t>(m_offsets[k + 1])};
+    const auto it{std::lower_bound(first, last, inner_of(row, col))};
+    return it != last && *it == inner_of(row, col)
+               ? m_values[static_cast<size_type>(it - m_indices.begin())]
+               : value_type{};
+  }
+
+  /// @brief the transpose, the arrays are reused as they are: the `csr` of
+  /// `A` is the `csc` of `A^T`
+  [[nodiscard]] auto transpose() const -> other_type {
+    other_type temp;
+    temp.m_row = m_col;
+    temp.m_col = m_row;
+    temp.m_offsets = m_offsets;
+    temp.m_indices = m_indices;
+    temp.m_values = m_values;
+    return temp;
+  }
+
+  /// @return the dense `dynamic_matrix_<>`
+  [[nodiscard]] auto to_dense() const -> dynamic_matrix_<value_type> {
+    dynamic_matrix_<value_type> temp(m_row, m_col);
+    for (size_type k{}; k + 1UL < m_offsets.size(); ++k) {
+      for (size_type n{m_offsets[k]}; n < m_offsets[k + 1]; ++n) {
+        (row_major ? temp.at(k, m_indices[n]) : temp.at(m_indices[n], k)) =
+            m_values[n];
+      }
+    }
+    return temp;
+  }
+
+  /// @return the dense `matrix_<>`, its size must match
+  template <size_type ROW, size_type COL>
+  [[nodiscard]] auto to_matrix() const -> matrix_<value_type, ROW, COL> {
+    assert(ROW == m_row && COL == m_col);
+    matrix_<value_type, ROW, COL> temp{};
+    for (size_type k{}; k + 1UL < m_offsets.size(); ++k) {
+      for (size_type n{m_offsets[k]}; n < m_offsets[k + 1]; ++n) {
+        (row_major ? temp.at(k, m_indices[n]) : temp.at(m_indices[n], k)) =
+            m_values[n];
+      }
+    }
+    return temp;
+  }
+
+  /// @brief sparse matrix-vector product `y = alpha * A * x + beta * y`
+  /// `csr` splits its rows between up to `threads` threads and gathers `x`
+  /// into vector registers, `csc` scatters into `y` on the calling thread
+  /// @param x `col()` elements, `incx` apart
+  /// @param y `row()` elements, `incy` apart, may not overlap `x`
+  /// @param threads `0` means every hardware thread
+  auto spmv(const value_type alpha, const value_type *x, const size_type incx,
+            const value_type beta, value_type *y, const size_type incy,
+            const size_type threads = 1UL) const -> void {
+    if constexpr (row_major) {
+      spmv_rows(alpha, x, incx, beta, y, incy, threads);
+    } else {
+      spmv_cols(alpha, x, incx, beta, y, incy);
+    }
+  }
+
+  /// @brief `A * x` with `x` a row or column vector of `col()` elements
+  /// @param threads `0` means every hardware thread
+  /// @return a `row() x 1` matrix
+  template <kraken::blas::viewable V>
+  [[nodiscard]] auto multiply(const V &x, const size_type threads = 0UL) const
+      -> dynamic_matrix_<value_type> {
+    const auto vx{make_view(x)};
+    assert(kraken::blas::detail::is_vector(vx) && vx.size() == m_col);
+    dynamic_matrix_<value_type> temp(m_row, 1UL);
+    spmv(value_type{1}, vx.data(), kraken::blas::detail::vector_inc(vx),
+         value_type{}, temp.data(), 1UL, threads);
+    return temp;
+  }
+
+  /// @brief `A * x` on the calling thread, see `multiply`
+  template <kraken::blas::viewable V>
+  [[nodiscard]] auto operator*(const V &x) const
+      -> dynamic_matrix_<value_type> {
+    return multiply(x, 1UL);
+  }
+
+  [[nodiscard]] auto operator==(const sparse_matrix_ &rhs) const noexcept
+      -> bool = default;
+
+  /// @brief prints the nonzeros as `(row, col) value`, one per line
+  friend auto operator<<(std::ostream &os, const sparse_matrix_ &mat)
+      -> std::ostream & {
+    for (size_type k{}; k + 1UL < mat.m_offsets.size(); ++k) {
+      for (size_type n{mat.m_offsets[k]}; n < mat.m_offsets[k + 1]; ++n) {
+        os << '(' << (row_major ? k : mat.m_indices[n]) << ", "
+           << (row_major ? mat.m_indices[n] : k) << ") " << mat.m_values[n]
+           << '\n';
+      }
+    }
+    return os;
+  }
+}; // end of class sparse_matrix_
+
+#endif // SPARSE_MATRIX_HPP
@@ -0,0 +1,327 @@
+#ifndef TILED_MATRIX_HPP
+#define TILED_MATRIX_HPP
+
+/*
+
+MIT License
+
+Copyright (c) 2021 yahya mohammed
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "blas.hpp"                    // kraken::blas::viewable
+#include "common/aligned_buffer.hpp"   // kraken::detail::aligned_buffer
+#include "common/thread_pool.hpp"      // kraken::detail::thread_pool
+#include "common/tiled.hpp"            // kraken::tiled, tile_gemm
+#include "common/transpose.hpp"        // kraken::blas::transpose
+#include "dynamic_matrix.hpp"          // dynamic_matrix_<>
+#include "matrix_view.hpp"             // matrix_view_<>, make_view
+#include <algorithm>                   // std::copy_n, std::fill_n, std::equal
+#include <cassert>                     // assert
+#include <cstddef>                     // std::size_t
+#include <ostream>                     // std::ostream
+#include <type_traits>                 // std::is_same_v
+#include <utility>                     // std::swap, std::exchange, std::move
+#include <vector>                      // std::vector
+
+//
+
+/// @brief a `row x col` matrix stored block-major (see `kraken::tiled`):
+/// `T x T` tiles, each one contiguous, following each other row by row of
+/// tiles or along a Z-order curve. element (i, j) and (i + 1, j) are `T`
+/// elements apart instead of `col`, so walking a column costs about the
+/// same as walking a row and a tile of both fits in L1. the edge tiles are
+/// padded with `0` to a full `T x T`, so every kernel works on whole tiles
+/// @tparam Order `kraken::tiled::morton` (the default) or `rows`
+/// @tparam T side of a tile
+template <class Ty, kraken::tiled::order Order = kraken::tiled::morton,
+          std::size_t T = kraken::tiled::side<Ty>>
+requires(!std::is_class_v<Ty> && T > 0UL) class tiled_matrix_ {
+public:
+  using value_type = Ty;
+  using size_type = std::size_t;
+  using reference = value_type &;
+  using pointer = value_type *;
+  using const_pointer = const value_type *;
+  using order_type = Order;
+  /// @get: side of a tile
+  static constexpr size_type tile_side{T};
+
+private:
+  kraken::detail::aligned_buffer<value_type> m_data;
+  /// index in the buffer of every tile, by position (morton only)
+  std::vector<size_type> m_offsets;
+  size_type m_row{};
+  size_type m_col{};
+  size_type m_tile_row{};
+  size_type m_tile_col{};
+
+  /// @brief first element of tile (`ti`, `tj`)
+  [[nodiscard]] auto tile_offset(const size_type ti,
+                                 const size_type tj) const noexcept
+      -> size_type {
+    const size_type position{(ti * m_tile_col) + tj};
+    if constexpr (std::is_same_v<Order, kraken::tiled::morton>) {
+      return m_offsets[position] * T * T;
+    } else {
+      return position * T * T;
+    }
+  }
+
+  /// @brief position of (i, j) in the buffer
+  [[nodiscard]] auto offset(const size_type i, const size_type j) const noexcept
+      -> size_type {
+    return tile_offset(i / T, j / T) + ((i % T) * T) + (j % T);
+  }
+
+public:
+  tiled_matrix_() noexcept = default;
+
+  /// @brief a `row x col` matrix, all elements are `0`
+  tiled_matrix_(const size_type row, const size_type col)
+      : m_row{row}, m_col{col}, m_tile_row{(row + T - 1UL) / T},
+        m_tile_col{(col + T - 1UL) / T} {
+    m_data = kraken::detail::aligned_buffer<value_type>{m_tile_row *
+                                                        m_tile_col * T * T};
+    std::fill_n(m_data.data(), m_data.size(), value_type{});
+    if constexpr (std::is_same_v<Order, kraken::tiled::morton>) {
+      m_offsets = kraken::tiled::tile_offsets<Order>(m_tile_row, m_tile_col);
+    }
+  }
+
+  /// @brief copies a `matrix_<>`, `dynamic_matrix_<>` or view, tile by tile
+  template <kraken::blas::viewable M>
+  explicit tiled_matrix_(const M &dense)
+      : tiled_matrix_(dense.row(), dense.col()) {
+    const auto view{make_view(dense)};
+    for (size_type ti{}; ti < m_tile_row; ++ti) {
+      for (size_type tj{}; tj < m_tile_col; ++tj) {
+        tile(ti, tj) = block_view(view, ti * T, tj * T, rows_of(ti),
+                                  cols_of(tj));
+      }
+    }
+  }
+
+  tiled_matrix_(const tiled_matrix_ &copy)
+      : m_data{copy.m_data.size()}, m_offsets{copy.m_offsets},
+        m_row{copy.m_row}, m_col{copy.m_col}, m_tile_row{copy.m_tile_row},
+        m_tile_col{copy.m_tile_col} {
+    std::copy_n(copy.data(), m_data.size(), m_data.data());
+  }
+
+  /// @brief move constructor, steals the buffer and leaves `move` empty
+  tiled_matrix_(tiled_matrix_ &&move) noexcept
+      : m_data{std::move(move.m_data)},
+        m_offsets{std::exchange(move.m_offsets, {})},
+        m_row{std::exchange(move.m_row, 0UL)},
+        m_col{std::exchange(move.m_col, 0UL)},
+        m_tile_row{std::exchange(move.m_tile_row, 0UL)},
+        m_tile_col{std::exchange(move.m_tile_col, 0UL)} {}
+
+  auto operator=(const tiled_matrix_ &copy) -> tiled_matrix_ & {
+    if (this != &copy) {
+      *this = tiled_matrix_(copy);
+    }
+    return *this;
+  }
+
+  auto operator=(tiled_matrix_ &&other) noexcept -> tiled_matrix_ & {
+    if (this == &other) {
+      return *this;
+    }
+    m_data = std::move(other.m_data);
+    m_offsets = std::exchange(other.m_offsets, {});
+    m_row = std::exchange(other.m_row, 0UL);
+    m_col = std::exchange(other.m_col, 0UL);
+    m_tile_row = std::exchange(other.m_tile_row, 0UL);
+    m_tile_col = std::exchange(other.m_tile_col, 0UL);
+    return *this;
+  }
+
+  ~tiled_matrix_() = default;
+
+  /// @get: number of rows
+  [[nodiscard]] auto row() const noexcept -> size_type { return m_row; }
+  /// @get: number of columns
+  [[nodiscard]] auto col() const noexcept -> size_type { return m_col; }
+  /// @get: number of rows of tiles
+  [[nodiscard]] auto tile_row() const noexcept -> size_type {
+    return m_tile_row;
+  }
+  /// @get: number of columns of tiles
+  [[nodiscard]] auto tile_col() const noexcept -> size_type {
+    return m_tile_col;
+  }
+  [[nodiscard]] auto size() const noexcept -> size_type {
+    return m_row * m_col;
+  }
+  [[nodiscard]] auto empty() const noexcept -> bool { return size() == 0UL; }
+  /// @get: the buffer, padding included (`tile_row() * tile_col()` tiles)
+  [[nodiscard]] auto data() noexcept -> pointer { return m_data.data(); }
+  [[nodiscard]] auto data() const noexcept -> const_pointer {
+    return m_data.data();
+  }
+
+  /// @get: rows of the tiles in row `ti` of tiles (less on the last one)
+  [[nodiscard]] auto rows_of(const size_type ti) const noexcept -> size_type {
+    return std::min(T, m_row - (ti * T));
+  }
+  /// @get: columns of the tiles in column `tj` of tiles
+  [[nodiscard]] auto cols_of(const size_type tj) const noexcept -> size_type {
+    return std::min(T, m_col - (tj * T));
+  }
+
+  /// @brief get/modify element (i, j)
+  [[nodiscard]] auto at(const size_type i, const size_type j) noexcept
+      -> reference {
+    assert(i < m_row && j < m_col);
+    return m_data.data()[offset(i, j)];
+  }
+  [[nodiscard]] auto at(const size_type i, const size_type j) const noexcept
+      -> value_type {
+    assert(i < m_row && j < m_col);
+    return m_data.data()[offset(i, j)];
+  }
+
+  /// @brief tile (`ti`, `tj`) as a dense view (`T` elements between rows),
+  /// the way into every kernel that takes a view; an edge tile is cut to the
+  /// elements of the matrix
+  [[nodiscard]] auto tile(const size_type ti, const size_type tj) noexcept
+      -> matrix_view_<value_type> {
+    assert(ti < m_tile_row && tj < m_tile_col);
+    return {m_data.data() + tile_offset(ti, tj), rows_of(ti), cols_of(tj), T};
+  }
+  [[nodiscard]] auto tile(const size_type ti, const size_type tj) const noexcept
+      -> matrix_view_<const value_type> {
+    assert(ti < m_tile_row && tj < m_tile_col);
+    return {m_data.data() + tile_offset(ti, tj), rows_of(ti), cols_of(tj), T};
+  }
+
+  /// @brief a row-major copy
+  [[nodiscard]] auto to_dense() const -> dynamic_matrix_<value_type> {
+    dynamic_matrix_<value_type> temp(m_row, m_col);
+    auto out{make_view(temp)};
+    for (size_type ti{}; ti < m_tile_row; ++ti) {
+      for (size_type tj{}; tj < m_tile_col; ++tj) {
+        block_view(out, ti * T, tj * T, rows_of(ti), cols_of(tj)) =
+            tile(ti, tj);
+      }
+    }
+    return temp;
+  }
+
+  auto fill(const value_type value) -> void {
+    for (size_type ti{}; ti < m_tile_row; ++ti) {
+      for (size_type tj{}; tj < m_tile_col; ++tj) {
+        for (auto &&i : tile(ti, tj)) {
+          i = value;
+        }
+      }
+    }
+  }
+
+  /// @brief swaps two rows, `T` contiguous elements per tile
+  auto swap_rows(const size_type first, const size_type second) noexcept
+      -> void {
+    assert(first < m_row && second < m_row);
+    for (size_type tj{}; tj < m_tile_col; ++tj) {
+      value_type *lhs{m_data.data() + offset(first, tj * T)};
+      value_type *rhs{m_data.data() + offset(second, tj * T)};
+      std::swap_ranges(lhs, lhs + cols_of(tj), rhs);
+    }
+  }
+
+  /// @brief swaps two columns, every tile of a column is `T * T` contiguous
+  /// elements instead of `T` rows of the matrix
+  auto swap_cols(const size_type first, const size_type second) noexcept
+      -> void {
+    assert(first < m_col && second < m_col);
+    for (size_type ti{}; ti < m_tile_row; ++ti) {
+      value_type *lhs{m_data.data() + offset(ti * T, first)};
+      value_type *rhs{m_data.data() + offset(ti * T, second)};
+      for (size_type r{}; r < rows_of(ti); ++r) {
+        std::swap(lhs[r * T], rhs[r * T]);
+      }
+    }
+  }
+
+  /// @brief the transpose: every tile is transposed in registers into the
+  /// mirrored tile, both stay in L1
+  [[nodiscard]] auto transpose() const -> tiled_matrix_ {
+    tiled_matrix_ temp(m_col, m_row);
+    for (size_type ti{}; ti < m_tile_row; ++ti) {
+      for (size_type tj{}; tj < m_tile_col; ++tj) {
+        kraken::blas::transpose(T, T, data() + tile_offset(ti, tj), T,
+                                temp.data() + temp.tile_offset(tj, ti), T);
+      }
+    }
+    return temp;
+  }
+
+  /// @brief `A * B`, tile by tile: every product of two tiles runs on
+  /// contiguous operands with no packing (`tile_gemm`)
+  /// @param threads upper bound on the threads used (one tile of the result
+  /// each), `0` means all of them
+  [[nodiscard]] auto multiply(const tiled_matrix_ &rhs,
+                              const size_type threads = 1UL) const
+      -> tiled_matrix_ {
+    assert(m_col == rhs.m_row);
+    tiled_matrix_ temp(m_row, rhs.m_col);
+    kraken::detail::thread_pool::instance().parallel_for(
+        temp.m_tile_row * temp.m_tile_col, threads,
+        [&](const size_type index) {
+          const size_type ti{index / temp.m_tile_col};
+          const size_type tj{index % temp.m_tile_col};
+          value_type *out{temp.data() + temp.tile_offset(ti, tj)};
+          for (size_type tk{}; tk < m_tile_col; ++tk) {
+            kraken::blas::tile_gemm<T>(data() + tile_offset(ti, tk),
+                                       rhs.data() + rhs.tile_offset(tk, tj),
+                                       out);
+          }
+        });
+    return temp;
+  }
+
+  [[nodiscard]] auto operator*(const tiled_matrix_ &rhs) const
+      -> tiled_matrix_ {
+    return multiply(rhs);
+  }
+
+  [[nodiscard]] auto operator==(const tiled_matrix_ &rhs) const noexcept
+      -> bool {
+    return m_row == rhs.m_row && m_col == rhs.m_col &&
+           std::equal(data(), data() + m_data.size(), rhs.data());
+  }
+
+  /// @brief prints the dense matrix
+  friend auto operator<<(std::ostream &os, const tiled_matrix_ &mat)
+      -> std::ostream & {
+    for (size_type i{}; i < mat.row(); ++i) {
+      for (size_type j{}; j < mat.col(); ++j) {
+        os << mat.at(i, j) << ' ';
+      }
+      os << '\n';
+    }
+    return os;
+  }
+}; // end of class tiled_matrix_
+
+#endif // TILED_MATRIX_HPP
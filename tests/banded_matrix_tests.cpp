@@ -0,0 +1,96 @@
+#include "../source/library/core/banded_matrix.hpp"
+#include "../Catch2/catch.hpp"
+#include "../source/library/core/numeric_methods.hpp"
+#include <utility>
+
+using Catch::Detail::Approx;
+
+namespace {
+/// @brief `n x n` band with `kl` diagonals below and `ku` above the main one
+auto make_band(const std::size_t n, const std::size_t kl, const std::size_t ku,
+               const double diagonal) -> banded_matrix_<double> {
+  banded_matrix_<double> band(n, kl, ku);
+  for (std::size_t i{}; i < n; ++i) {
+    for (std::size_t j{band.first(i)}; j < band.last(i); ++j) {
+      band.at(i, j) = static_cast<double>((i * 7 + j * 3) % 5) - 2.;
+    }
+    band.at(i, i) = diagonal;
+  }
+  return band;
+}
+
+auto same(const dynamic_matrix_<double> &a, const dynamic_matrix_<double> &b)
+    -> bool {
+  bool result{a.row() == b.row() && a.col() == b.col()};
+  for (std::size_t i{}; result && i < a.size(); ++i) {
+    result = a[i] == Approx(b[i]).margin(1e-9);
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("BANDED MATRIX STORAGE AND PRODUCT") {
+  const dynamic_matrix_<int> dense(4, 4, {1, 2, 0, 0, 3, 4, 5, 0, 0, 6, 7, 8,
+                                          0, 0, 9, 10});
+  banded_matrix_<int> tri(dense, 1, 1);
+  REQUIRE(tri.ld() == 3);
+  REQUIRE(tri.at(2, 1) == 6);
+  REQUIRE(std::as_const(tri).at(0, 3) == 0);
+  REQUIRE(!tri.in_band(3, 0));
+  REQUIRE(tri.to_dense() == dense);
+  tri.at(3, 2) = -9;
+  REQUIRE(tri.at(3, 2) == -9);
+
+  const auto band{make_band(50, 2, 3, 10.)};
+  dynamic_matrix_<double> x(50, 3);
+  for (std::size_t i{}; i < x.size(); ++i) {
+    x[i] = static_cast<double>(i % 9) - 4.;
+  }
+  REQUIRE(same(band * x, band.to_dense() * x));
+  REQUIRE(same(band * col_view(x, 1), band.to_dense() * col_view(x, 1)));
+
+  // a moved-from matrix is empty and still usable
+  auto moved{std::move(tri)};
+  REQUIRE(moved.at(3, 2) == -9);
+  REQUIRE(tri.row() == 0);
+  REQUIRE(tri.lower() == 0);
+  REQUIRE(tri.to_dense().empty());
+  tri = std::move(moved);
+  REQUIRE(tri.to_dense().at(2, 1) == 6);
+  REQUIRE(moved.ld() == 1);
+}
+
+TEST_CASE("BANDED SOLVERS") {
+  constexpr std::size_t n{200};
+  dynamic_matrix_<double> x(n, 2);
+  for (std::size_t i{}; i < x.size(); ++i) {
+    x[i] = static_cast<double>(i % 11) - 5.;
+  }
+
+  // 1D diffusion: -1, 2.5, -1
+  banded_matrix_<double> diffusion(n, 1, 1);
+  for (std::size_t i{}; i < n; ++i) {
+    diffusion.at(i, i) = 2.5;
+    if (i > 0) {
+      diffusion.at(i, i - 1) = -1.;
+      diffusion.at(i - 1, i) = -1.;
+    }
+  }
+  REQUIRE(same(kraken::num_methods::thomas(diffusion, diffusion * x), x));
+
+  // a small diagonal forces row swaps
+  const auto band{make_band(n, 3, 2, 0.5)};
+  const banded_lu_<double> lu(band);
+  REQUIRE(!lu.singular());
+  REQUIRE(lu.factors().upper() == 5);
+  bool swapped{false};
+  for (std::size_t i{}; i < n; ++i) {
+    swapped = swapped || lu.pivots()[i] != i;
+  }
+  REQUIRE(swapped);
+  REQUIRE(same(lu.solve(band * x), x));
+
+  banded_matrix_<double> singular(3, 1, 1);
+  singular.at(0, 0) = 1.;
+  REQUIRE(banded_lu_<double>(singular).singular());
+}
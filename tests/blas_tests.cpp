@@ -0,0 +1,603 @@
+#include "../source/library/core/blas.hpp"
+#include "../Catch2/catch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using Catch::Detail::Approx;
+
+namespace {
+/// @brief checks every kernel against a plain loop, lengths around the vector
+/// width catch the tail handling
+template <class Ty> auto check_level1(const std::size_t n, const std::size_t inc) {
+  std::vector<Ty> x(n * inc);
+  std::vector<Ty> y(n * inc);
+  for (std::size_t i{}; i < x.size(); ++i) {
+    x[i] = static_cast<Ty>((static_cast<int>(i * 7UL % 23UL) - 11)) / 4;
+    y[i] = static_cast<Ty>((static_cast<int>(i * 5UL % 17UL) - 8)) / 2;
+  }
+  Ty dot{};
+  Ty asum{};
+  Ty largest{-1};
+  std::size_t index{};
+  for (std::size_t i{}; i < n; ++i) {
+    dot += x[i * inc] * y[i * inc];
+    asum += std::abs(x[i * inc]);
+    if (std::abs(x[i * inc]) > largest) {
+      largest = std::abs(x[i * inc]);
+      index = i;
+    }
+  }
+  REQUIRE(kraken::blas::dot(n, x.data(), inc, y.data(), inc) == Approx(dot));
+  REQUIRE(kraken::blas::asum(n, x.data(), inc) == Approx(asum));
+  if constexpr (std::is_floating_point_v<Ty>) {
+    REQUIRE(kraken::blas::nrm2(n, x.data(), inc) ==
+            Approx(std::sqrt(kraken::blas::dot(n, x.data(), inc, x.data(), inc))));
+  }
+  if (n > 0UL) {
+    REQUIRE(kraken::blas::iamax(n, x.data(), inc) == index);
+  }
+
+  auto expected{y};
+  for (std::size_t i{}; i < n; ++i) {
+    expected[i * inc] += Ty{3} * x[i * inc];
+  }
+  kraken::blas::axpy(n, Ty{3}, x.data(), inc, y.data(), inc);
+  REQUIRE(y == expected);
+
+  for (std::size_t i{}; i < n; ++i) {
+    expected[i * inc] *= Ty{-2};
+  }
+  kraken::blas::scal(n, Ty{-2}, y.data(), inc);
+  REQUIRE(y == expected);
+
+  // sparse: every other element of `y`, in scrambled order
+  std::vector<std::size_t> indx(n / 2UL);
+  for (std::size_t i{}; i < indx.size(); ++i) {
+    indx[i] = ((i * 5UL) % indx.size()) * 2UL;
+  }
+  Ty doti{};
+  for (std::size_t i{}; i < indx.size(); ++i) {
+    doti += x[i] * y[indx[i] * inc];
+    expected[indx[i] * inc] += Ty{2} * x[i];
+  }
+  REQUIRE(kraken::blas::doti(indx.size(), x.data(), indx.data(), y.data(),
+                             inc) == Approx(doti));
+  kraken::blas::axpyi(indx.size(), Ty{2}, x.data(), indx.data(), y.data(), inc);
+  REQUIRE(y == expected);
+}
+} // namespace
+
+TEST_CASE("LEVEL-1 KERNELS AGAINST PLAIN LOOPS") {
+  for (const std::size_t n : {0UL, 1UL, 3UL, 7UL, 8UL, 15UL, 16UL, 17UL, 33UL,
+                              64UL, 100UL, 1000UL}) {
+    check_level1<float>(n, 1UL);
+    check_level1<double>(n, 1UL);
+    check_level1<double>(n, 3UL);
+    check_level1<int>(n, 1UL);
+  }
+}
+
+namespace {
+/// @brief every permutation kernel against a plain loop, `perm` mixes fixed
+/// points, a two-cycle and one long cycle
+template <class Ty>
+auto check_permute(const std::size_t rows, const std::size_t cols) {
+  const auto shuffle = [](const std::size_t n) {
+    std::vector<std::size_t> perm(n);
+    for (std::size_t i{}; i < n; ++i) {
+      perm[i] = i;
+    }
+    for (std::size_t i{2}; i + 1UL < n; i += 3UL) {
+      std::swap(perm[i], perm[(i * 7UL) % n]);
+    }
+    return perm;
+  };
+  const auto rp{shuffle(rows)};
+  const auto cp{shuffle(cols)};
+  REQUIRE(kraken::blas::is_permutation(rows, rp.data()));
+  const std::size_t ld{cols + 3UL};
+  std::vector<Ty> a(rows * ld);
+  for (std::size_t i{}; i < a.size(); ++i) {
+    a[i] = static_cast<Ty>(i % 1000UL);
+  }
+  std::vector<Ty> rows_of(rows * ld, Ty{-1});
+  std::vector<Ty> cols_of(rows * ld, Ty{-1});
+  kraken::blas::permute_rows(rows, cols, rp.data(), a.data(), ld,
+                             rows_of.data(), ld);
+  kraken::blas::permute_cols(rows, cols, cp.data(), a.data(), ld,
+                             cols_of.data(), ld);
+  auto in_place_rows{a};
+  auto in_place_cols{a};
+  kraken::blas::permute_rows(rows, cols, rp.data(), in_place_rows.data(), ld);
+  kraken::blas::permute_cols(rows, cols, cp.data(), in_place_cols.data(), ld);
+  bool same{true};
+  for (std::size_t i{}; i < rows; ++i) {
+    for (std::size_t j{}; j < cols; ++j) {
+      same = same && rows_of[(i * ld) + j] == a[(rp[i] * ld) + j] &&
+             cols_of[(i * ld) + j] == a[(i * ld) + cp[j]] &&
+             in_place_rows[(i * ld) + j] == rows_of[(i * ld) + j] &&
+             in_place_cols[(i * ld) + j] == cols_of[(i * ld) + j];
+    }
+    for (std::size_t j{cols}; j < ld; ++j) { // the padding is never touched
+      same = same && rows_of[(i * ld) + j] == Ty{-1} &&
+             in_place_rows[(i * ld) + j] == a[(i * ld) + j];
+    }
+  }
+  REQUIRE(same);
+}
+} // namespace
+
+TEST_CASE("ROW AND COLUMN PERMUTATIONS AGAINST PLAIN LOOPS") {
+  for (const std::size_t n : {1UL, 2UL, 7UL, 17UL, 64UL, 131UL}) {
+    check_permute<float>(n, n + 5UL);
+    check_permute<double>(n + 9UL, n);
+    check_permute<int>(n, n);
+  }
+  const std::vector<std::size_t> twice{0UL, 0UL, 2UL};
+  const std::vector<std::size_t> outside{0UL, 3UL, 1UL};
+  REQUIRE_FALSE(kraken::blas::is_permutation(3UL, twice.data()));
+  REQUIRE_FALSE(kraken::blas::is_permutation(3UL, outside.data()));
+}
+
+namespace {
+/// @brief the sort kernels against `std::sort` / `std::stable_sort`, on
+/// negative values, repeated values and (for floats) both zeros
+template <class Ty> auto check_sort(const std::size_t n) {
+  std::vector<Ty> values(n);
+  for (std::size_t i{}; i < n; ++i) {
+    const auto v{static_cast<long long>((i * 7919UL) % 1009UL) - 504LL};
+    values[i] = std::is_unsigned_v<Ty> ? static_cast<Ty>(v + 504LL)
+                                       : static_cast<Ty>(v);
+  }
+  if constexpr (std::is_floating_point_v<Ty>) {
+    for (std::size_t i{}; i < n; i += 7UL) {
+      values[i] = static_cast<Ty>(values[i] / 8);
+    }
+  }
+  auto expected{values};
+  std::sort(expected.begin(), expected.end());
+  // the runs of 2, 3 and 5 threads take every shape of merge round
+  bool same{true};
+  for (const std::size_t threads : {2UL, 3UL, 5UL}) {
+    auto sorted{values};
+    kraken::blas::sort(n, sorted.data(), true, threads);
+    same = same && sorted == expected;
+  }
+  REQUIRE(same);
+  auto threaded{values};
+  auto radix{values};
+  if constexpr (kraken::blas::radix_sortable<Ty>) {
+    kraken::blas::radix_sort(n, radix.data());
+    REQUIRE(radix == expected);
+  }
+  std::reverse(expected.begin(), expected.end());
+  kraken::blas::sort(n, threaded.data(), false, 3UL);
+  REQUIRE(threaded == expected);
+  if constexpr (kraken::blas::radix_sortable<Ty>) {
+    kraken::blas::radix_sort(n, radix.data(), false);
+    REQUIRE(radix == expected);
+  }
+}
+} // namespace
+
+TEST_CASE("RADIX AND THREADED SORTS AGAINST STD::SORT") {
+  for (const std::size_t n : {0UL, 1UL, 2UL, 100UL, 5000UL, 200000UL}) {
+    check_sort<std::int8_t>(n);
+    check_sort<std::uint16_t>(n);
+    check_sort<int>(n);
+    check_sort<std::uint64_t>(n);
+    check_sort<float>(n);
+    check_sort<double>(n);
+    check_sort<long double>(n); // no radix keys, std::sort runs
+  }
+  // `-0.` before `0.`, infinities at the ends
+  std::vector<double> special{0., -1., std::numeric_limits<double>::infinity(),
+                              -0., -std::numeric_limits<double>::infinity(),
+                              1e-300, -1e-300};
+  kraken::blas::radix_sort(special.size(), special.data());
+  REQUIRE(std::is_sorted(special.begin(), special.end()));
+  REQUIRE(std::signbit(special[3]));
+  REQUIRE(!std::signbit(special[4]));
+}
+
+TEST_CASE("SORT ROWS BY KEY COLUMNS") {
+  constexpr std::size_t rows{1000};
+  constexpr std::size_t cols{4};
+  constexpr std::size_t ld{6};
+  std::vector<int> a(rows * ld, -1);
+  std::vector<long double> b(rows * ld);
+  for (std::size_t i{}; i < rows; ++i) {
+    a[(i * ld) + 0] = static_cast<int>((i * 37UL) % 5UL) - 2; // key 1
+    a[(i * ld) + 1] = static_cast<int>(i);                     // the row
+    a[(i * ld) + 2] = static_cast<int>((i * 11UL) % 3UL);      // key 0
+    a[(i * ld) + 3] = static_cast<int>((i * 13UL) % 7UL);
+    for (std::size_t j{}; j < cols; ++j) {
+      b[(i * ld) + j] = static_cast<long double>(a[(i * ld) + j]);
+    }
+  }
+  const auto before{a};
+  const std::array<std::size_t, 2> keys{2, 0};
+  kraken::blas::sort_rows(rows, cols, a.data(), ld, keys.data(), keys.size());
+  kraken::blas::sort_rows(rows, cols, b.data(), ld, keys.data(), keys.size(),
+                          false);
+  bool same{true};
+  for (std::size_t i{}; i < rows; ++i) {
+    const int *row{a.data() + (i * ld)};
+    const int *was{before.data() + (static_cast<std::size_t>(row[1]) * ld)};
+    same = same && std::equal(row, row + ld, was); // padding included
+    if (i > 0UL) {
+      const int *prev{row - ld};
+      // ordered by key 0, then key 1, then (stable) by the original row
+      same = same && std::tuple(prev[2], prev[0], prev[1]) <
+                         std::tuple(row[2], row[0], row[1]);
+      const long double *r{b.data() + (i * ld)};
+      const long double *p{r - ld};
+      same = same &&
+             std::tuple(p[2], p[0], r[1]) > std::tuple(r[2], r[0], p[1]);
+    }
+  }
+  REQUIRE(same);
+}
+
+namespace {
+/// @brief every reduction on both axes against plain loops, through a
+/// row-major, a column-major and a strided (every other column) buffer
+template <class Ty>
+auto check_reduce(const std::size_t rows, const std::size_t cols,
+                  const std::size_t threads) {
+  using kraken::blas::reduction;
+  std::vector<Ty> a(rows * cols * 2UL);
+  for (std::size_t i{}; i < a.size(); ++i) {
+    a[i] = static_cast<Ty>(static_cast<int>((i * 7919UL) % 201UL) - 100);
+  }
+  struct strides {
+    std::size_t rs;
+    std::size_t cs;
+  };
+  bool same{true};
+  for (const auto &[rs, cs] : {strides{cols, 1UL}, strides{1UL, rows},
+                              strides{2UL * cols, 2UL}}) {
+    for (const auto op : {reduction::sum, reduction::min, reduction::max,
+                          reduction::mean}) {
+      const auto expected = [&](const std::size_t n, const std::size_t step,
+                                const Ty *x) {
+        Ty result{x[0]};
+        for (std::size_t k{1}; k < n; ++k) {
+          const Ty v{x[k * step]};
+          result = op == reduction::min   ? std::min(result, v)
+                   : op == reduction::max ? std::max(result, v)
+                                          : static_cast<Ty>(result + v);
+        }
+        return op == reduction::mean
+                   ? static_cast<Ty>(result / static_cast<Ty>(n))
+                   : result;
+      };
+      std::vector<Ty> by_row(rows * 2UL);
+      std::vector<Ty> by_col(cols);
+      kraken::blas::reduce_rows(op, rows, cols, a.data(), rs, cs,
+                                by_row.data(), 2UL, threads);
+      kraken::blas::reduce_cols(op, rows, cols, a.data(), rs, cs,
+                                by_col.data(), 1UL, threads);
+      for (std::size_t i{}; i < rows; ++i) {
+        same = same && by_row[i * 2UL] ==
+                           Approx(expected(cols, cs, a.data() + (i * rs)));
+      }
+      for (std::size_t j{}; j < cols; ++j) {
+        same = same &&
+               by_col[j] == Approx(expected(rows, rs, a.data() + (j * cs)));
+      }
+    }
+  }
+  REQUIRE(same);
+}
+} // namespace
+
+TEST_CASE("ROW AND COLUMN REDUCTIONS AGAINST PLAIN LOOPS") {
+  // short lines, lines around the vector width, more columns than a band of
+  // accumulators and tall matrices that are cut into blocks of rows
+  for (const auto &[rows, cols] :
+       {std::pair{1UL, 1UL}, std::pair{3UL, 7UL}, std::pair{17UL, 33UL},
+        std::pair{2UL, 5000UL}, std::pair{20000UL, 3UL},
+        std::pair{300UL, 129UL}}) {
+    for (const std::size_t threads : {1UL, 4UL}) {
+      check_reduce<float>(rows, cols, threads);
+      check_reduce<double>(rows, cols, threads);
+      check_reduce<int>(rows, cols, threads);
+    }
+  }
+}
+
+TEST_CASE("MEANS OF NARROW INTEGERS ARE EXACT") {
+  using kraken::blas::reduction;
+  // 256 columns do not fit in `std::uint8_t`, and neither do their sums
+  const std::vector<std::uint8_t> bytes(3UL * 256UL, 200U);
+  std::vector<std::uint8_t> by_row(3);
+  kraken::blas::reduce_rows(reduction::mean, 3UL, 256UL, bytes.data(), 256UL,
+                            1UL, by_row.data(), 1UL);
+  REQUIRE(by_row == std::vector<std::uint8_t>(3, 200U));
+  std::vector<std::uint8_t> by_col(3);
+  kraken::blas::reduce_cols(reduction::mean, 256UL, 3UL, bytes.data(), 3UL,
+                            1UL, by_col.data(), 1UL, 4UL);
+  REQUIRE(by_col == std::vector<std::uint8_t>(3, 200U));
+  // a plain sum wraps like the element type
+  kraken::blas::reduce_rows(reduction::sum, 3UL, 256UL, bytes.data(), 256UL,
+                            1UL, by_row.data(), 1UL);
+  REQUIRE(by_row == std::vector<std::uint8_t>(3, 0U));
+
+  std::vector<std::int8_t> small(200UL * 2UL, -100);
+  small[1] = 100;
+  std::vector<std::int8_t> means(2);
+  kraken::blas::reduce_cols(reduction::mean, 200UL, 2UL, small.data(), 2UL,
+                            1UL, means.data(), 1UL);
+  REQUIRE(means == std::vector<std::int8_t>{-100, -99});
+  kraken::blas::reduce_rows(reduction::mean, 2UL, 200UL, small.data(), 1UL,
+                            2UL, means.data(), 1UL);
+  REQUIRE(means == std::vector<std::int8_t>{-100, -99});
+}
+
+TEST_CASE("LEVEL-1 NRM2 DOES NOT OVERFLOW") {
+  const std::vector<float> big(40, 1e30f);
+  REQUIRE(kraken::blas::nrm2(big.size(), big.data(), 1UL) ==
+          Approx(1e30f * std::sqrt(40.f)));
+  const std::vector<double> tiny(40, 1e-200);
+  REQUIRE(kraken::blas::nrm2(tiny.size(), tiny.data(), 1UL) ==
+          Approx(1e-200 * std::sqrt(40.)));
+  const std::vector<double> zero(9, 0.);
+  REQUIRE(kraken::blas::nrm2(zero.size(), zero.data(), 1UL) == 0.);
+}
+
+TEST_CASE("REDUCTIONS ON MATRICES AND VIEWS") {
+  using kraken::blas::reduction;
+  dynamic_matrix_<double> mat(3, 4, {1., 2., 3., 4., 5., 6., 7., 8., 9., 10.,
+                                     11., 12.});
+  REQUIRE(kraken::blas::reduce_cols(reduction::sum, mat) ==
+          dynamic_matrix_<double>(1, 4, {15., 18., 21., 24.}));
+  REQUIRE(kraken::blas::reduce_rows(reduction::max, mat, 0UL) ==
+          dynamic_matrix_<double>(3, 1, {4., 8., 12.}));
+  REQUIRE(kraken::blas::reduce_rows(reduction::mean,
+                                    block_view(mat, 1, 2, 2, 2)) ==
+          dynamic_matrix_<double>(2, 1, {7.5, 11.5}));
+  REQUIRE(kraken::blas::reduce_rows(reduction::min, transposed_view(mat)) ==
+          dynamic_matrix_<double>(4, 1, {1., 2., 3., 4.}));
+  REQUIRE(kraken::blas::reduce_cols(reduction::sum, col_view(mat, 1)) ==
+          dynamic_matrix_<double>(1, 1, {18.}));
+  const matrix_<int, 2, 2> fixed(1, 2, 3, 4);
+  REQUIRE(kraken::blas::reduce_cols(reduction::max, fixed) ==
+          dynamic_matrix_<int>(1, 2, {3, 4}));
+}
+
+TEST_CASE("LEVEL-1 ON MATRICES AND VIEWS") {
+  matrix_<double, 3, 3> mat(1., -2., 3., 4., 5., -6., 7., 8., 9.);
+  REQUIRE(kraken::blas::dot(row_view(mat, 0), col_view(mat, 2)) == 42.);
+  REQUIRE(kraken::blas::dot(mat, mat) == 285.);
+  REQUIRE(kraken::blas::asum(mat) == 45.);
+  REQUIRE(kraken::blas::nrm2(mat) == Approx(std::sqrt(285.)));
+  REQUIRE(kraken::blas::nrm2(block_view(mat, 0, 1, 2, 2)) ==
+          Approx(std::sqrt(4. + 9. + 25. + 36.)));
+
+  const auto where{kraken::blas::iamax(block_view(mat, 0, 0, 2, 3))};
+  REQUIRE(where.row == 1);
+  REQUIRE(where.col == 2);
+  REQUIRE(kraken::blas::iamax(col_view(mat, 1)).row == 2);
+
+  kraken::blas::scal(2., row_view(mat, 1));
+  REQUIRE(mat == matrix_<double, 3, 3>(1., -2., 3., 8., 10., -12., 7., 8., 9.));
+  kraken::blas::axpy(-1., col_view(mat, 0), col_view(mat, 2));
+  REQUIRE(mat == matrix_<double, 3, 3>(1., -2., 2., 8., 10., -20., 7., 8., 2.));
+  // a column of the transpose is a row of the matrix
+  kraken::blas::axpy(1., transposed_view(mat).col_view(0), row_view(mat, 2));
+  REQUIRE(mat == matrix_<double, 3, 3>(1., -2., 2., 8., 10., -20., 8., 6., 4.));
+
+  dynamic_matrix_<float> dyn(40, 40, 1.f);
+  kraken::blas::scal(0.5f, dyn);
+  REQUIRE(kraken::blas::asum(dyn) == 800.f);
+  // scalar multiplication goes through `scal` too
+  REQUIRE((dyn * 4.f).at(39, 39) == 2.f);
+}
+
+namespace {
+/// @brief checks both orientations of the raw gemv against a plain loop
+template <class Ty>
+auto check_gemv(const std::size_t m, const std::size_t n,
+                const std::size_t threads) {
+  const std::size_t lda{n + 3UL};
+  std::vector<Ty> a(m * lda);
+  std::vector<Ty> x(std::max(m, n) * 2UL);
+  for (std::size_t i{}; i < a.size(); ++i) {
+    a[i] = static_cast<Ty>((static_cast<int>(i * 7UL % 23UL) - 11)) / 4;
+  }
+  for (std::size_t i{}; i < x.size(); ++i) {
+    x[i] = static_cast<Ty>((static_cast<int>(i * 5UL % 17UL) - 8)) / 2;
+  }
+  // y = 2 * A * x - y, x strided by 2
+  std::vector<Ty> y(m, Ty{1});
+  std::vector<Ty> expected(m);
+  for (std::size_t i{}; i < m; ++i) {
+    Ty sum{};
+    for (std::size_t j{}; j < n; ++j) {
+      sum += a[(i * lda) + j] * x[j * 2UL];
+    }
+    expected[i] = (Ty{2} * sum) - Ty{1};
+  }
+  kraken::blas::gemv(kraken::blas::op::none, m, n, Ty{2}, a.data(), lda,
+                     x.data(), 2UL, Ty{-1}, y.data(), 1UL, threads);
+  bool same{true};
+  for (std::size_t i{}; i < m; ++i) {
+    same = same && y[i] == Approx(expected[i]);
+  }
+  REQUIRE(same);
+  // y = A^T * x, `y` starts as garbage that `beta = 0` has to drop
+  std::vector<Ty> yt(n, std::numeric_limits<Ty>::quiet_NaN());
+  kraken::blas::gemv(kraken::blas::op::trans, m, n, Ty{1}, a.data(), lda,
+                     x.data(), 1UL, Ty{}, yt.data(), 1UL, threads);
+  for (std::size_t j{}; j < n; ++j) {
+    Ty sum{};
+    for (std::size_t i{}; i < m; ++i) {
+      sum += a[(i * lda) + j] * x[i];
+    }
+    same = same && yt[j] == Approx(sum);
+  }
+  REQUIRE(same);
+}
+} // namespace
+
+TEST_CASE("LEVEL-2 GEMV AGAINST PLAIN LOOPS") {
+  for (const std::size_t m : {1UL, 7UL, 33UL}) {
+    for (const std::size_t n : {1UL, 8UL, 17UL, 100UL}) {
+      check_gemv<float>(m, n, 1UL);
+      check_gemv<double>(m, n, 1UL);
+    }
+  }
+  // large enough to be split between threads, odd sizes leave a short chunk
+  check_gemv<double>(601UL, 509UL, 0UL);
+  check_gemv<float>(509UL, 601UL, 3UL);
+}
+
+TEST_CASE("LEVEL-2 ON MATRICES AND VIEWS") {
+  const matrix_<double, 3, 3> mat(1., -2., 3., 4., 5., -6., 7., 8., 9.);
+  const matrix_<double, 3, 1> x(1., 2., 3.);
+  matrix_<double, 3, 1> y(1., 1., 1.);
+  kraken::blas::gemv(kraken::blas::op::none, 1., mat, x, 2., y);
+  REQUIRE(y == matrix_<double, 3, 1>(8., -2., 52.));
+  // a transposed view flips the orientation, no copy involved
+  matrix_<double, 1, 3> row{};
+  kraken::blas::gemv(kraken::blas::op::none, 1., transposed_view(mat), x, 0.,
+                     row);
+  REQUIRE(row == matrix_<double, 1, 3>(30., 32., 18.));
+  kraken::blas::gemv(kraken::blas::op::trans, 1., mat, x, 0., row);
+  REQUIRE(row == matrix_<double, 1, 3>(30., 32., 18.));
+  // a view with neither stride `1` is copied first
+  std::vector<double> buffer(12);
+  for (std::size_t i{}; i < buffer.size(); ++i) {
+    buffer[i] = static_cast<double>(i + 1UL);
+  }
+  const matrix_view_<const double> every_other(buffer.data(), 2, 3, 6, 2);
+  const matrix_<double, 2, 1> ones(1., 1.);
+  matrix_<double, 1, 3> out{};
+  kraken::blas::gemv(kraken::blas::op::trans, 1., every_other, ones, 0., out);
+  REQUIRE(out == matrix_<double, 1, 3>(8., 12., 16.));
+
+  matrix_<double, 3, 3> had(mat);
+  kraken::blas::hadamard(mat, had);
+  REQUIRE(had == matrix_<double, 3, 3>(1., 4., 9., 16., 25., 36., 49., 64., 81.));
+  kraken::blas::hadamard(row_view(mat, 0), row_view(had, 2));
+  REQUIRE(row_view(had, 2).at(0, 2) == 243.);
+
+  std::vector<float> hx(37);
+  std::vector<float> hy(37);
+  for (std::size_t i{}; i < hx.size(); ++i) {
+    hx[i] = static_cast<float>(i);
+    hy[i] = 0.5f;
+  }
+  kraken::blas::hadamard(hx.size(), hx.data(), 1UL, hy.data(), 1UL);
+  bool same{true};
+  for (std::size_t i{}; i < hy.size(); ++i) {
+    same = same && hy[i] == static_cast<float>(i) * 0.5f;
+  }
+  REQUIRE(same);
+}
+
+namespace {
+/// @brief fills `count` elements with a walk over the whole range of `Ty`
+template <class Ty>
+auto quantized_values(const std::size_t count, const std::size_t seed) {
+  std::vector<Ty> values(count);
+  constexpr std::int64_t lo{std::numeric_limits<Ty>::min()};
+  constexpr std::int64_t span{std::int64_t{std::numeric_limits<Ty>::max()} -
+                              lo + 1};
+  for (std::size_t i{}; i < count; ++i) {
+    values[i] = static_cast<Ty>(
+        lo + static_cast<std::int64_t>(((i + seed) * 2654435761UL) %
+                                       static_cast<std::size_t>(span)));
+  }
+  values[0] = std::numeric_limits<Ty>::min(); // the extremes are the edges
+  values[count - 1UL] = std::numeric_limits<Ty>::max();
+  return values;
+}
+
+/// @brief checks the `int32` and the dequantized `qgemm` against `int64` sums
+template <class TA, class TB>
+auto check_qgemm(const std::size_t m, const std::size_t n, const std::size_t k,
+                 const std::size_t threads) {
+  const std::size_t lda{k + 5UL};
+  const std::size_t ldb{n + 3UL};
+  const auto a{quantized_values<TA>(m * lda, 1UL)};
+  const auto b{quantized_values<TB>(k * ldb, 7UL)};
+  std::vector<float> a_scale(m);
+  std::vector<float> b_scale(n);
+  for (std::size_t i{}; i < m; ++i) {
+    a_scale[i] = 0.01f * static_cast<float>(i % 7UL + 1UL);
+  }
+  for (std::size_t j{}; j < n; ++j) {
+    b_scale[j] = 0.002f * static_cast<float>(j % 5UL + 1UL);
+  }
+  constexpr std::int32_t a_zero{3};
+  constexpr std::int32_t b_zero{-2};
+  std::vector<std::int32_t> c(m * n);
+  std::vector<float> f(m * n);
+  kraken::blas::qgemm(m, n, k, a.data(), lda, b.data(), ldb, c.data(), n,
+                      threads);
+  kraken::blas::qgemm(m, n, k, a.data(), lda, a_zero, a_scale.data(),
+                      b.data(), ldb, b_zero, b_scale.data(), f.data(), n,
+                      threads);
+  bool same{true};
+  for (std::size_t i{}; i < m; ++i) {
+    for (std::size_t j{}; j < n; ++j) {
+      std::int64_t sum{};
+      std::int64_t centered{};
+      for (std::size_t p{}; p < k; ++p) {
+        const std::int64_t a_ip{a[(i * lda) + p]};
+        const std::int64_t b_pj{b[(p * ldb) + j]};
+        sum += a_ip * b_pj;
+        centered += (a_ip - a_zero) * (b_pj - b_zero);
+      }
+      same = same && c[(i * n) + j] == sum &&
+             f[(i * n) + j] ==
+                 Approx(static_cast<double>(a_scale[i] * b_scale[j]) *
+                        static_cast<double>(centered));
+    }
+  }
+  REQUIRE(same);
+}
+
+template <class TA, class TB> auto check_qgemm_sizes() {
+  check_qgemm<TA, TB>(3UL, 5UL, 7UL, 1UL); // below the packing threshold
+  // ragged against `MR`, `NR` and the 4-element groups of `k`
+  check_qgemm<TA, TB>(37UL, 70UL, 131UL, 1UL);
+  check_qgemm<TA, TB>(101UL, 45UL, 1UL, 1UL);
+  check_qgemm<TA, TB>(203UL, 97UL, 66UL, 0UL);
+}
+} // namespace
+
+TEST_CASE("QUANTIZED GEMM AGAINST INT64 SUMS") {
+  check_qgemm_sizes<std::int8_t, std::int8_t>();
+  check_qgemm_sizes<std::uint8_t, std::int8_t>();
+  check_qgemm_sizes<std::int8_t, std::uint8_t>();
+  check_qgemm_sizes<std::uint8_t, std::uint8_t>();
+  check_qgemm_sizes<std::int16_t, std::int8_t>();
+  // two full-range `int16` products can reach `2^31`, keep `k` tiny
+  check_qgemm<std::int16_t, std::int16_t>(40UL, 33UL, 1UL, 1UL);
+  // a panel of `B` much narrower than `n` exercises the tile order
+  check_qgemm<std::uint8_t, std::int8_t>(130UL, 300UL, 2000UL, 3UL);
+}
+
+TEST_CASE("QUANTIZED GEMM ON MATRICES AND VIEWS") {
+  const dynamic_matrix_<std::int8_t> a(2, 3, {1, -2, 3, -4, 5, -6});
+  const dynamic_matrix_<std::uint8_t> b(3, 2, {10, 20, 30, 40, 50, 60});
+  const std::vector<float> a_scale{0.5f, 2.f};
+  const std::vector<float> b_scale{1.f, 0.25f};
+  const auto c{kraken::blas::qgemm(a, 0, a_scale, b, 0, b_scale)};
+  REQUIRE(c == dynamic_matrix_<float>(2, 2, {50.f, 15.f, -380.f, -120.f}));
+  // zero points shift every element before the product
+  const auto z{kraken::blas::qgemm(a, 1, a_scale, b, 10, b_scale)};
+  REQUIRE(z.at(0, 0) == Approx(0.5f * (0.f * 0.f + -3.f * 20.f + 2.f * 40.f)));
+  // a transposed view of `b` is copied into rows first
+  const dynamic_matrix_<std::uint8_t> bt(2, 3, {10, 30, 50, 20, 40, 60});
+  REQUIRE(kraken::blas::qgemm(a, 0, a_scale, transposed_view(bt), 0,
+                              b_scale) == c);
+}
@@ -0,0 +1,263 @@
+#include "../source/library/core/dynamic_matrix.hpp"
+#include "../Catch2/catch.hpp"
+#include <array>
+#include <limits>
+#include <new>
+
+TEST_CASE("DYNAMIC MATRIX SIZE AND ALIGNMENT") {
+  const dynamic_matrix_<double> mat(300, 500);
+  REQUIRE(mat.row() == 300);
+  REQUIRE(mat.col() == 500);
+  REQUIRE(mat.size() == 150'000);
+  REQUIRE(mat.empty() == false);
+  REQUIRE(reinterpret_cast<std::uintptr_t>(mat.data()) %
+              dynamic_matrix_<double>::alignment ==
+          0);
+  REQUIRE(dynamic_matrix_<int>{}.empty());
+
+  const auto huge{std::numeric_limits<std::size_t>::max() / 2};
+  REQUIRE_THROWS_AS(dynamic_matrix_<double>(huge, 3),
+                    std::bad_array_new_length);
+
+  dynamic_matrix_<double> copy(2, 2, 1.0);
+  copy = mat;
+  REQUIRE(copy.row() == 300);
+  REQUIRE(copy.col() == 500);
+  REQUIRE(copy.size() == 150'000);
+}
+
+TEST_CASE("DYNAMIC MATRIX MOVE IS O(1)") {
+  dynamic_matrix_<int> a(2, 2, {1, 2, 3, 4});
+  const auto *const buffer{a.data()};
+  dynamic_matrix_<int> b{std::move(a)};
+  REQUIRE(b.data() == buffer);
+  REQUIRE(a.empty());
+  a = std::move(b);
+  REQUIRE(a.data() == buffer);
+  REQUIRE(a.at(1, 1) == 4);
+}
+
+TEST_CASE("DYNAMIC MATRIX FROM FIXED MATRIX") {
+  constexpr matrix_<int, 2, 3> fixed(1, 2, 3, 4, 5, 6);
+  const dynamic_matrix_<int> actual{fixed};
+  REQUIRE(actual == dynamic_matrix_<int>(2, 3, {1, 2, 3, 4, 5, 6}));
+}
+
+TEST_CASE("DYNAMIC MATRIX TRANSPOSE") {
+  dynamic_matrix_<float> sq(3, 3, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f});
+  sq.transpose_squared();
+  REQUIRE(sq == dynamic_matrix_<float>(
+                    3, 3, {1.f, 4.f, 7.f, 2.f, 5.f, 8.f, 3.f, 6.f, 9.f}));
+
+  const dynamic_matrix_<int> rect(3, 4, {0, 3, 6, 9, 1, 4, 7, 10, 2, 5, 8, 11});
+  REQUIRE(rect.transpose_triangular() ==
+          dynamic_matrix_<int>(4, 3, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}));
+}
+
+TEST_CASE("DYNAMIC MATRIX SWAP ROWS-COLS") {
+  dynamic_matrix_<int> mat(2, 3, {1, 2, 3, 4, 5, 6});
+  mat.swap_rows(0, 1);
+  REQUIRE(mat == dynamic_matrix_<int>(2, 3, {4, 5, 6, 1, 2, 3}));
+  mat.swap_cols(0, 2);
+  REQUIRE(mat == dynamic_matrix_<int>(2, 3, {6, 5, 4, 3, 2, 1}));
+}
+
+TEST_CASE("DYNAMIC MATRIX SORT") {
+  dynamic_matrix_<int> small(2, 3, {5, 1, 4, 2, 6, 3});
+  small.sort();
+  REQUIRE(small == dynamic_matrix_<int>(2, 3, {1, 2, 3, 4, 5, 6}));
+  small.sort(false);
+  REQUIRE(small == dynamic_matrix_<int>(2, 3, {6, 5, 4, 3, 2, 1}));
+
+  dynamic_matrix_<int> large(20, 20);
+  for (std::size_t i{}; i < large.size(); ++i) {
+    large[i] = static_cast<int>(large.size() - i);
+  }
+  large.sort();
+  REQUIRE(std::is_sorted(large.begin(), large.end()));
+}
+
+TEST_CASE("DYNAMIC MATRIX MULTIPLICATION") {
+  const dynamic_matrix_<int> y(2, 3, {0, 3, 5, 5, 5, 2});
+  const dynamic_matrix_<int> x(3, 2, {3, 4, 3, -2, 4, -2});
+  REQUIRE((y * x) == dynamic_matrix_<int>(2, 2, {29, -16, 38, 6}));
+  REQUIRE((y * 2) == dynamic_matrix_<int>(2, 3, {0, 6, 10, 10, 10, 4}));
+}
+
+TEST_CASE("DYNAMIC MATRIX ADDITION-SUBTRACTION") {
+  const dynamic_matrix_<int> a(2, 2, {3, 4, 5, 5});
+  REQUIRE((a + a) == dynamic_matrix_<int>(2, 2, {6, 8, 10, 10}));
+  REQUIRE((a - a) == dynamic_matrix_<int>(2, 2));
+  REQUIRE((a + 2) == dynamic_matrix_<int>(2, 2, {5, 6, 7, 7}));
+  REQUIRE((a - 2) == dynamic_matrix_<int>(2, 2, {1, 2, 3, 3}));
+}
+
+TEST_CASE("DYNAMIC MATRIX LARGE MULTIPLICATION") {
+  constexpr std::size_t n{130};
+  dynamic_matrix_<float> a(n, n);
+  dynamic_matrix_<float> identity(n, n);
+  for (std::size_t i{}; i < n; ++i) {
+    identity.at(i, i) = 1.f;
+    for (std::size_t j{}; j < n; ++j) {
+      a.at(i, j) = static_cast<float>((i * n + j) % 17);
+    }
+  }
+  REQUIRE((a * identity) == a);
+  REQUIRE((identity * a) == a);
+}
+
+TEST_CASE("DYNAMIC MATRIX PARALLEL MULTIPLICATION") {
+  // square and tall-skinny shapes, both cut into several tiles
+  for (auto &&[m, k, n] : {std::array<std::size_t, 3>{300, 70, 290},
+                           std::array<std::size_t, 3>{1000, 40, 8}}) {
+    dynamic_matrix_<double> a(m, k);
+    dynamic_matrix_<double> b(k, n);
+    for (std::size_t i{}; i < a.size(); ++i) {
+      a[i] = static_cast<double>(i % 9) - 4.;
+    }
+    for (std::size_t i{}; i < b.size(); ++i) {
+      b[i] = static_cast<double>(i % 7) - 3.;
+    }
+    const auto expected{a * b};
+    REQUIRE(a.multiply(b, 4) == expected);
+    REQUIRE(a.multiply(b) == expected);
+  }
+}
+
+TEST_CASE("DYNAMIC MATRIX-VECTOR AND HADAMARD PRODUCTS") {
+  // a column or a row operand goes through `gemv`, threaded when large
+  constexpr std::size_t m{700}, n{600};
+  dynamic_matrix_<double> a(m, n);
+  dynamic_matrix_<double> x(n, 1);
+  dynamic_matrix_<double> row(1, m);
+  for (std::size_t i{}; i < a.size(); ++i) {
+    a[i] = static_cast<double>(i % 9) - 4.;
+  }
+  for (std::size_t i{}; i < n; ++i) {
+    x[i] = static_cast<double>(i % 5) - 2.;
+  }
+  for (std::size_t i{}; i < m; ++i) {
+    row[i] = static_cast<double>(i % 3) - 1.;
+  }
+  const auto ax{a.multiply(x)};
+  const auto ra{row.multiply(a)};
+  REQUIRE(ax == a * x);
+  REQUIRE(ra == row * a);
+  bool same{ax.row() == m && ax.col() == 1UL && ra.row() == 1UL &&
+            ra.col() == n};
+  for (std::size_t i{}; i < m; ++i) {
+    double sum{};
+    for (std::size_t j{}; j < n; ++j) {
+      sum += a.at(i, j) * x[j];
+    }
+    same = same && ax[i] == sum;
+  }
+  for (std::size_t j{}; j < n; ++j) {
+    double sum{};
+    for (std::size_t i{}; i < m; ++i) {
+      sum += row[i] * a.at(i, j);
+    }
+    same = same && ra[j] == sum;
+  }
+  REQUIRE(same);
+
+  const dynamic_matrix_<int> h(2, 3, {1, 2, 3, 4, 5, 6});
+  REQUIRE(h.hadamard(h) == dynamic_matrix_<int>(2, 3, {1, 4, 9, 16, 25, 36}));
+}
+
+TEST_CASE("DYNAMIC MATRIX STRASSEN-WINOGRAD") {
+  // small integers keep every product exact, a tiny cutoff gives several
+  // levels of recursion and odd sizes go through the peeling
+  for (auto &&[m, k, n] : {std::array<std::size_t, 3>{64, 64, 64},
+                           std::array<std::size_t, 3>{67, 45, 53},
+                           std::array<std::size_t, 3>{129, 100, 77}}) {
+    dynamic_matrix_<double> a(m, k);
+    dynamic_matrix_<double> b(k, n);
+    for (std::size_t i{}; i < a.size(); ++i) {
+      a[i] = static_cast<double>(i % 9) - 4.;
+    }
+    for (std::size_t i{}; i < b.size(); ++i) {
+      b[i] = static_cast<double>(i % 7) - 3.;
+    }
+    const auto expected{a * b};
+    REQUIRE(a.strassen(b, 8) == expected);
+    REQUIRE(a.strassen(b, 8, 1) == expected);
+    REQUIRE(a.strassen(b) == expected); // below the default cutoff
+
+    // alpha and beta go through a temporary
+    dynamic_matrix_<double> c(m, n, 1.);
+    kraken::blas::strassen(m, n, k, 2., a.data(), k, b.data(), n, -1.,
+                           c.data(), n, 8);
+    REQUIRE(c == (expected * 2.) - dynamic_matrix_<double>(m, n, 1.));
+  }
+}
+
+TEST_CASE("DYNAMIC MATRIX FUSED EXPRESSIONS") {
+  const dynamic_matrix_<double> a(2, 2, {1., 2., 3., 4.});
+  const dynamic_matrix_<double> b(2, 2, {5., 6., 7., 8.});
+  dynamic_matrix_<double> actual = a + b - a * 2. + 1.;
+  REQUIRE(actual == dynamic_matrix_<double>(2, 2, {5., 5., 5., 5.}));
+
+  const auto *const buffer{actual.data()};
+  actual = 0.5 * (b - a);
+  REQUIRE(actual.data() == buffer);
+  REQUIRE(actual == dynamic_matrix_<double>(2, 2, 2.));
+
+  // a temporary operand is moved into the expression and lives as long
+  const auto lazy{dynamic_matrix_<double>(2, 2, {1., 1., 2., 2.}) + a};
+  const auto scaled{-(2. * (b - dynamic_matrix_<double>(2, 2, 1.)))};
+  const dynamic_matrix_<double> later(lazy - scaled);
+  REQUIRE(later == dynamic_matrix_<double>(2, 2, {10., 13., 17., 20.}));
+}
+
+template <class Ty> auto check_blocked_transpose(std::size_t m, std::size_t n) {
+  dynamic_matrix_<Ty> mat(m, n);
+  for (std::size_t i{}; i < mat.size(); ++i) {
+    mat[i] = static_cast<Ty>(i % 1000);
+  }
+  const auto actual{mat.transpose_triangular()};
+  REQUIRE(actual.row() == n);
+  REQUIRE(actual.col() == m);
+  bool same{true};
+  for (std::size_t i{}; i < m; ++i) {
+    for (std::size_t j{}; j < n; ++j) {
+      same = same && actual.at(j, i) == mat.at(i, j);
+    }
+  }
+  REQUIRE(same);
+
+  dynamic_matrix_<Ty> square(m, m);
+  for (std::size_t i{}; i < square.size(); ++i) {
+    square[i] = static_cast<Ty>(i % 1000);
+  }
+  auto twice{square};
+  twice.transpose_squared();
+  REQUIRE(twice.at(0, m - 1) == square.at(m - 1, 0));
+  REQUIRE(twice.at(m / 2, 3) == square.at(3, m / 2));
+  twice.transpose_squared();
+  REQUIRE(twice == square);
+}
+
+TEST_CASE("DYNAMIC MATRIX BLOCKED TRANSPOSE") {
+  check_blocked_transpose<float>(203, 77);
+  check_blocked_transpose<double>(131, 260);
+  check_blocked_transpose<int>(75, 9);
+  check_blocked_transpose<unsigned char>(190, 33);
+}
+
+TEST_CASE("DYNAMIC MATRIX IN-PLACE RECTANGULAR TRANSPOSE") {
+  for (auto &&[m, n] : {std::array<std::size_t, 2>{3, 4},
+                        std::array<std::size_t, 2>{37, 120},
+                        std::array<std::size_t, 2>{1, 9},
+                        std::array<std::size_t, 2>{70, 70}}) {
+    dynamic_matrix_<int> mat(m, n);
+    for (std::size_t i{}; i < mat.size(); ++i) {
+      mat[i] = static_cast<int>(i);
+    }
+    const auto expected{mat.transpose_triangular()};
+    const auto *const buffer{mat.data()};
+    mat.transpose();
+    REQUIRE(mat.data() == buffer);
+    REQUIRE(mat == expected);
+  }
+}
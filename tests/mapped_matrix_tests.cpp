@@ -0,0 +1,104 @@
+#include "../source/library/core/mapped_matrix.hpp"
+#include "../Catch2/catch.hpp"
+#include "test_helpers.hpp"
+#include <filesystem>
+#include <fstream>
+
+using Catch::Detail::Approx;
+
+TEST_CASE("MAPPED MATRIX CREATE, FLUSH AND REOPEN") {
+  const temp_file file{"kraken_mapped_matrix.bin"};
+  {
+    auto out{mapped_matrix_<double>::create(file.path.c_str(), 3, 4)};
+    REQUIRE(out.is_open());
+    REQUIRE(out.writable());
+    REQUIRE(out.at(2, 3) == 0.); // a new file is all zeros
+    for (std::size_t i{}; i < 3; ++i) {
+      for (std::size_t j{}; j < 4; ++j) {
+        out.at(i, j) = static_cast<double>((i * 4) + j);
+      }
+    }
+    REQUIRE(out.flush());
+  }
+  REQUIRE(std::filesystem::file_size(file.path) == 12 * sizeof(double));
+
+  const mapped_matrix_<double> in(file.path.c_str(), 3, 4);
+  REQUIRE(in.is_open());
+  REQUIRE(!in.writable());
+  REQUIRE(in.at(1, 2) == 6.);
+  REQUIRE(in.to_dense() == dynamic_matrix_<double>(
+                               3, 4, {0., 1., 2., 3., 4., 5., 6., 7., 8., 9.,
+                                      10., 11.}));
+  // the same bytes as a 2 x 2 matrix with rows 4 elements apart, one row in
+  const mapped_matrix_<double> block(file.path.c_str(), 2, 2,
+                                     kraken::mapping::read_only,
+                                     4 * sizeof(double), 4);
+  REQUIRE(block.to_dense() == dynamic_matrix_<double>(2, 2, {4., 5., 8., 9.}));
+  // a matrix the file cannot hold, a missing file, a misaligned offset
+  REQUIRE(!mapped_matrix_<double>(file.path.c_str(), 4, 4).is_open());
+  REQUIRE(!mapped_matrix_<double>("/nonexistent/kraken.bin", 1, 1).is_open());
+  REQUIRE(!mapped_matrix_<double>(file.path.c_str(), 1, 1,
+                                  kraken::mapping::read_only, 3)
+               .is_open());
+  // a shape whose size in bytes wraps around to 32
+  const mapped_matrix_<double> wraps(file.path.c_str(), (1UL << 61U) + 1UL, 4);
+  REQUIRE(!wraps.is_open());
+  REQUIRE(wraps.row() == 0);
+}
+
+TEST_CASE("MAPPED MATRIX SHARING AND COPY-ON-WRITE") {
+  const temp_file file{"kraken_mapped_shared.bin"};
+  const dynamic_matrix_<float> source(2, 3, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  auto writer{mapped_matrix_<float>::create(file.path.c_str(), source)};
+  REQUIRE(writer.to_dense() == source);
+
+  // every mapping of the file sees the same pages
+  const mapped_matrix_<float> reader(file.path.c_str(), 2, 3);
+  writer.at(0, 0) = 10.f;
+  REQUIRE(reader.at(0, 0) == 10.f);
+
+  // private writes never reach the file nor the other mappings
+  mapped_matrix_<float> scratch(file.path.c_str(), 2, 3,
+                                kraken::mapping::copy_on_write);
+  scratch.at(1, 2) = -1.f;
+  REQUIRE(scratch.at(1, 2) == -1.f);
+  REQUIRE(reader.at(1, 2) == 6.f);
+
+  // a moved-from matrix is closed and empty, the mapping went with the move
+  mapped_matrix_<float> moved{};
+  moved = std::move(scratch);
+  REQUIRE(!scratch.is_open());
+  REQUIRE(scratch.empty());
+  {
+    const auto last{std::move(moved)};
+    REQUIRE(last.at(1, 2) == -1.f);
+  }
+  REQUIRE(!moved.is_open());
+  REQUIRE(moved.row() == 0);
+
+  // hints never change the contents
+  reader.advise(kraken::access::sequential);
+  reader.prefetch_rows(0, 2);
+  reader.evict_rows(0, 1);
+  REQUIRE(reader.at(0, 0) == 10.f);
+}
+
+TEST_CASE("MAPPED MATRIX THROUGH VIEWS AND KERNELS") {
+  const temp_file file{"kraken_mapped_views.bin"};
+  dynamic_matrix_<double> source(40, 30);
+  for (std::size_t i{}; i < source.size(); ++i) {
+    source[i] = static_cast<double>(i % 11) - 5.;
+  }
+  auto mapped{mapped_matrix_<double>::create(file.path.c_str(), source)};
+  REQUIRE(kraken::blas::asum(mapped.view()) == kraken::blas::asum(source));
+  REQUIRE(kraken::blas::dot(row_view(mapped, 3), row_view(source, 3)) ==
+          Approx(kraken::blas::dot(row_view(source, 3), row_view(source, 3))));
+  // expressions over a mapped matrix materialize in memory
+  const dynamic_matrix_<double> twice = mapped.view() + source;
+  REQUIRE(twice.at(39, 29) == 2. * source.at(39, 29));
+  const auto product{transposed_view(mapped) * source};
+  REQUIRE(product == source.transpose_triangular() * source);
+  // and writes go through a mutable view
+  kraken::blas::scal(2., mapped.mutable_view());
+  REQUIRE(mapped.to_dense() == twice);
+}
@@ -0,0 +1,93 @@
+#include "../source/library/core/matrix_batch.hpp"
+#include "../Catch2/catch.hpp"
+#include "../source/library/core/numeric_methods.hpp"
+#include <vector>
+
+using Catch::Detail::Approx;
+
+namespace {
+/// @brief `count` well-conditioned 4x4 matrices, all different
+auto make_matrices(const std::size_t count)
+    -> std::vector<matrix_<float, 4, 4>> {
+  std::vector<matrix_<float, 4, 4>> temp(count);
+  for (std::size_t n{}; n < count; ++n) {
+    for (std::size_t i{}; i < 4; ++i) {
+      for (std::size_t j{}; j < 4; ++j) {
+        temp[n].at(i, j) = static_cast<float>((n + (3 * i) + (7 * j)) % 5) +
+                           (i == j ? 6.f : 0.f);
+      }
+    }
+  }
+  return temp;
+}
+} // namespace
+
+TEST_CASE("MATRIX BATCH STORAGE") {
+  // 19 is not a multiple of any lane count, the tail is padded
+  const auto mats{make_matrices(19)};
+  matrix_batch_<float, 4, 4> batch(mats);
+  REQUIRE(batch.count() == 19);
+  REQUIRE(batch.stride() % batch.lanes == 0);
+  REQUIRE(batch.stride() >= 19);
+  REQUIRE(batch.plane(1, 2) + 5 == &batch.at(5, 1, 2));
+  for (std::size_t n{}; n < 19; ++n) {
+    REQUIRE(batch.get(n) == mats[n]);
+  }
+
+  auto copy{batch};
+  copy.at(3, 0, 0) = -1.f;
+  REQUIRE(batch.at(3, 0, 0) == mats[3].at(0, 0));
+  copy.set(3, mats[3]);
+  REQUIRE(copy.get(3) == mats[3]);
+
+  const auto tr{batch.transpose()};
+  REQUIRE(tr.get(7) == mats[7].transpose_triangular());
+
+  // a moved-from batch is empty and still usable
+  auto moved{std::move(copy)};
+  REQUIRE(moved.get(3) == mats[3]);
+  REQUIRE(copy.empty());
+  REQUIRE(copy.stride() == 0);
+  REQUIRE(copy.transpose().empty());
+  copy = std::move(moved);
+  REQUIRE(copy.count() == 19);
+  REQUIRE(moved.empty());
+}
+
+TEST_CASE("MATRIX BATCH MULTIPLY DETERMINANT INVERSE") {
+  const auto lhs{make_matrices(21)};
+  auto rhs{make_matrices(24)};
+  rhs.erase(rhs.begin(), rhs.begin() + 3);
+  const matrix_batch_<float, 4, 4> a(lhs);
+  const matrix_batch_<float, 4, 4> b(rhs);
+
+  const auto c{a * b};
+  const auto det{a.determinant()};
+  const auto inv{a.inverse()};
+  REQUIRE(det.col() == 21);
+  for (std::size_t n{}; n < 21; ++n) {
+    REQUIRE(c.get(n) == lhs[n] * rhs[n]);
+    REQUIRE(det.at(0, n) == Approx(kraken::num_methods::determined(lhs[n])));
+    const auto expected{kraken::num_methods::inverse(lhs[n])};
+    for (std::size_t i{}; i < 16; ++i) {
+      REQUIRE(inv.get(n)[i] == Approx(expected[i]).margin(1e-6));
+    }
+  }
+
+  // in place, into batches that are already sized
+  matrix_batch_<float, 4, 4> out(21);
+  b.multiply(a, out);
+  REQUIRE(out.get(20) == rhs[20] * lhs[20]);
+  a.inverse(out);
+  REQUIRE(out.at(4, 2, 1) == inv.at(4, 2, 1));
+
+  // rectangular: (2 x 3) * (3 x 1)
+  matrix_batch_<double, 2, 3> m(2);
+  matrix_batch_<double, 3, 1> v(2);
+  m.set(1, matrix_<double, 2, 3>{1, 2, 3, 4, 5, 6});
+  v.set(1, matrix_<double, 3, 1>{1, 0, -1});
+  const auto mv{m * v};
+  REQUIRE(mv.at(1, 0, 0) == -2.);
+  REQUIRE(mv.at(1, 1, 0) == -2.);
+  REQUIRE(mv.at(0, 1, 0) == 0.);
+}
@@ -0,0 +1,211 @@
+#include "../source/library/core/matrix_io.hpp"
+#include "../Catch2/catch.hpp"
+#include "../source/library/core/matrix.hpp"
+#include "test_helpers.hpp"
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using Catch::Detail::Approx;
+
+namespace {
+/// @brief the bytes of a stream, as a buffer a file would be read into
+auto bytes_of(const std::string &text) -> std::vector<std::byte> {
+  std::vector<std::byte> out(text.size());
+  std::memcpy(out.data(), text.data(), text.size());
+  return out;
+}
+} // namespace
+
+TEST_CASE("CRC-32C") {
+  const std::string text{"123456789"};
+  REQUIRE(kraken::io::crc32c(0U, text.data(), text.size()) == 0xE3069283U);
+  // piece by piece gives the same checksum
+  const auto first{kraken::io::crc32c(0U, text.data(), 4)};
+  REQUIRE(kraken::io::crc32c(first, text.data() + 4, 5) == 0xE3069283U);
+  REQUIRE(kraken::io::crc32c(0U, text.data(), 0) == 0U);
+}
+
+TEST_CASE("MATRIX IO ROUND TRIP") {
+  using kraken::io::status;
+  const dynamic_matrix_<double> source(3, 4, {1., 2., 3., 4., 5., 6., 7., 8.,
+                                              9., 10., 11., 12.});
+  std::stringstream stream;
+  REQUIRE(kraken::io::save(stream, source) == status::ok);
+  // header, padding to the alignment, then the elements
+  REQUIRE(stream.str().size() == 64 + (12 * sizeof(double)));
+
+  dynamic_matrix_<double> back;
+  REQUIRE(kraken::io::load(stream, back) == status::ok);
+  REQUIRE(back == source);
+
+  // a strided view is written densely, a fixed-size matrix loads in place
+  std::stringstream column;
+  REQUIRE(kraken::io::save(column, transposed_view(source)) == status::ok);
+  matrix_<double, 4, 3> fixed;
+  REQUIRE(kraken::io::load(column, fixed) == status::ok);
+  REQUIRE(fixed.at(0, 2) == 9.);
+  REQUIRE(fixed.at(3, 1) == 8.);
+  column.seekg(0);
+  matrix_<double, 3, 4> wrong;
+  REQUIRE(kraken::io::load(column, wrong) == status::wrong_shape);
+
+  // several matrices in one stream, and an empty one
+  std::stringstream many;
+  const dynamic_matrix_<std::int32_t> small(1, 2, {7, -7});
+  REQUIRE(kraken::io::save(many, small) == status::ok);
+  REQUIRE(kraken::io::save(many, dynamic_matrix_<std::int32_t>{}) ==
+          status::ok);
+  REQUIRE(kraken::io::save(many, small) == status::ok);
+  dynamic_matrix_<std::int32_t> a;
+  dynamic_matrix_<std::int32_t> b(2, 2);
+  dynamic_matrix_<std::int32_t> c;
+  REQUIRE(kraken::io::load(many, a) == status::ok);
+  REQUIRE(kraken::io::load(many, b) == status::ok);
+  REQUIRE(kraken::io::load(many, c) == status::ok);
+  REQUIRE(a == small);
+  REQUIRE(b.size() == 0);
+  REQUIRE(c == small);
+}
+
+TEST_CASE("MATRIX IO STREAMING WRITER") {
+  using kraken::io::status;
+  std::stringstream stream;
+  {
+    kraken::io::writer<float> out(stream, 3, 2, 4096);
+    const float first[]{1.f, 2.f, 3.f};
+    out.write(first, 3); // rows need not be written whole
+    out.write_rows(dynamic_matrix_<float>(1, 2, {4.f, 5.f}));
+    REQUIRE(out.written() == 5);
+    const float last{6.f};
+    out.write(&last, 1);
+  } // finished by the destructor
+  REQUIRE(stream.str().size() == 4096 + (6 * sizeof(float)));
+  dynamic_matrix_<float> back;
+  REQUIRE(kraken::io::load(stream, back) == status::ok);
+  REQUIRE(back == dynamic_matrix_<float>(3, 2, {1.f, 2.f, 3.f, 4.f, 5.f,
+                                                6.f}));
+
+  // an unfinished matrix never loads
+  std::stringstream partial;
+  {
+    kraken::io::writer<float> out(partial, 2, 2);
+    const float some[]{1.f, 2.f};
+    out.write(some, 2);
+    REQUIRE(out.finish() == status::truncated);
+  }
+  REQUIRE(kraken::io::load(partial, back) == status::bad_header);
+}
+
+TEST_CASE("MATRIX IO ERRORS") {
+  using kraken::io::status;
+  const dynamic_matrix_<std::int16_t> source(2, 3, {1, 2, 3, 4, 5, 6});
+  std::stringstream stream;
+  REQUIRE(kraken::io::save(stream, source) == status::ok);
+  const std::string good{stream.str()};
+
+  dynamic_matrix_<std::int16_t> out(1, 1, {42});
+  dynamic_matrix_<std::uint16_t> other;
+  std::stringstream typed{good};
+  REQUIRE(kraken::io::load(typed, other) == status::wrong_type);
+
+  std::string flipped{good};
+  flipped[70] = static_cast<char>(flipped[70] ^ 1); // an element
+  std::stringstream corrupt{flipped};
+  REQUIRE(kraken::io::load(corrupt, out) == status::bad_checksum);
+  REQUIRE(out == dynamic_matrix_<std::int16_t>(1, 1, {42})); // untouched
+
+  std::string shape{good};
+  shape[16] = 3; // rows, caught by the header checksum
+  std::stringstream reshaped{shape};
+  REQUIRE(kraken::io::load(reshaped, out) == status::bad_header);
+
+  std::stringstream cut{good.substr(0, good.size() - 1)};
+  REQUIRE(kraken::io::load(cut, out) == status::truncated);
+  std::stringstream garbage{std::string(100, 'x')};
+  REQUIRE(kraken::io::load(garbage, out) == status::bad_header);
+  std::stringstream nothing;
+  REQUIRE(kraken::io::load(nothing, out) == status::io_error);
+  REQUIRE(kraken::io::load("/nonexistent/kraken.kmx", out) ==
+          status::io_error);
+}
+
+TEST_CASE("MATRIX IO CRAFTED HEADERS") {
+  using kraken::io::status;
+  // a well-formed header whose shape is made up
+  const auto craft{[](const std::uint64_t rows, const std::uint64_t cols) {
+    kraken::io::header head{};
+    head.type = kraken::io::dtype::f32;
+    head.rows = rows;
+    head.cols = head.ld = cols;
+    head.alignment = head.offset = 64U;
+    head.header_checksum = head.own_checksum();
+    std::string text(sizeof(head) + 64U, '\0');
+    std::memcpy(text.data(), &head, sizeof(head));
+    return text;
+  }};
+  status result{status::ok};
+  dynamic_matrix_<float> out;
+
+  // (rows - 1) * ld * 4 wraps around to a payload of 16 bytes
+  const std::string wraps{craft((std::uint64_t{1} << 62U) + 1U, 4U)};
+  REQUIRE(kraken::io::view<float>(bytes_of(wraps), &result, false).size() ==
+          0);
+  REQUIRE(result == status::bad_header);
+  std::stringstream wrapped{wraps};
+  REQUIRE(kraken::io::load(wrapped, out) == status::bad_header);
+
+  // a shape that fits in 64 bits but not in the stream is never allocated
+  std::stringstream huge{craft(std::uint64_t{1} << 40U, 1024U)};
+  REQUIRE(kraken::io::load(huge, out) == status::truncated);
+  REQUIRE(out.size() == 0);
+}
+
+TEST_CASE("MATRIX IO ZERO-COPY LOADING") {
+  using kraken::io::status;
+  const temp_file file{"kraken_matrix_io.kmx"};
+  const dynamic_matrix_<double> source(3, 3, {1., 2., 3., 4., 5., 6., 7., 8.,
+                                              9.});
+  REQUIRE(kraken::io::save(file.path.c_str(), source, 4096) == status::ok);
+
+  status result{status::io_error};
+  const auto mapped{
+      kraken::io::map<double>(file.path.c_str(), &result,
+                              kraken::mapping::read_only, true)};
+  REQUIRE(result == status::ok);
+  REQUIRE(mapped.is_open());
+  // the elements are the mapped pages, page-aligned after the header
+  const auto *base{mapped.file().data()};
+  REQUIRE(reinterpret_cast<const std::byte *>(mapped.data()) == base + 4096);
+  REQUIRE(mapped.to_dense() == source);
+  REQUIRE(!kraken::io::map<float>(file.path.c_str(), &result).is_open());
+  REQUIRE(result == status::wrong_type);
+  REQUIRE(!kraken::io::map<double>("/nonexistent/kraken.kmx").is_open());
+
+  // a buffer already in memory is viewed where it is
+  std::stringstream stream;
+  REQUIRE(kraken::io::save(stream, source) == status::ok);
+  const auto buffer{bytes_of(stream.str())};
+  const auto in_place{kraken::io::view<double>(buffer, &result)};
+  REQUIRE(result == status::ok);
+  REQUIRE(reinterpret_cast<const std::byte *>(in_place.data()) ==
+          buffer.data() + 64);
+  REQUIRE(in_place.at(2, 1) == 8.);
+  REQUIRE(in_place == make_view(source));
+  const auto shifted{kraken::io::view<double>(
+      std::span<const std::byte>{buffer}.subspan(0, 100), &result)};
+  REQUIRE(result == status::truncated);
+  REQUIRE(shifted.size() == 0);
+}
+
+TEST_CASE("MATRIX PRINTS FLOATING POINT ELEMENTS") {
+  const matrix_<double, 1, 2> m(1.5, -2.);
+  std::ostringstream os;
+  os << m;
+  REQUIRE(os.str().find("1.5") != std::string::npos);
+  REQUIRE(os.str().find("-2") != std::string::npos);
+}
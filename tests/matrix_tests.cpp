@@ -1,6 +1,9 @@
 #include "../source/library/core/matrix.hpp"
 #define CATCH_CONFIG_MAIN
 #include "../Catch2/catch.hpp"
+#include <sstream>
+#include <type_traits>
+#include <vector>
 
 inline constexpr matrix_<float, 3, 3> matrix_test(1.f, 2.f, 3.f, 4.f, 5.f, 6.f,
                                                   7.f, 8.f, 9.f);
@@ -106,7 +109,7 @@ TEST_CASE("MATRIX ADDITION") {
 
   constexpr matrix_<int, 3, 3> b(3, 4, 5, 5, 4, 3, 3, 3, 7);
 
-  constexpr auto actual = (a + b);
+  constexpr matrix_<int, 3, 3> actual = (a + b);
   constexpr matrix_<int, 3, 3> expected(6, 8, 10, 10, 8, 6, 6, 6, 14);
   REQUIRE(expected == actual);
 }
@@ -115,7 +118,7 @@ TEST_CASE("MATRIX SUBTRACTION") {
   constexpr matrix_<int, 3, 3> a(3, 4, 5, 5, 4, 3, 3, 3, 7);
 
   constexpr matrix_<int, 3, 3> b(3, 4, 5, 5, 4, 3, 3, 3, 7);
-  constexpr auto actual = (a - b);
+  constexpr matrix_<int, 3, 3> actual = (a - b);
   constexpr matrix_<int, 3, 3> expected(0, 0, 0, 0, 0, 0, 0, 0, 0);
   REQUIRE(expected == actual);
 }
@@ -123,7 +126,7 @@ TEST_CASE("MATRIX SUBTRACTION") {
 TEST_CASE("MATRIX ADDITION WITH SCALAR") {
   constexpr matrix_<int, 3, 3> a(3, 4, 5, 5, 4, 3, 3, 3, 7);
 
-  constexpr auto actual = (a + 2);
+  constexpr matrix_<int, 3, 3> actual = (a + 2);
   constexpr matrix_<int, 3, 3> expected(5, 6, 7, 7, 6, 5, 5, 5, 9);
   REQUIRE(expected == actual);
 }
@@ -131,7 +134,439 @@ TEST_CASE("MATRIX ADDITION WITH SCALAR") {
 TEST_CASE("MATRIX SUBTRACTION WITH SCALAR") {
   constexpr matrix_<int, 3, 3> a(3, 4, 5, 5, 4, 3, 3, 3, 7);
 
-  constexpr auto actual = (a - 2);
+  constexpr matrix_<int, 3, 3> actual = (a - 2);
   constexpr matrix_<int, 3, 3> expected(1, 2, 3, 3, 2, 1, 1, 1, 5);
   REQUIRE(expected == actual);
 }
+
+TEST_CASE("UNROLLED SMALL MATRIX MULTIPLICATION") {
+  constexpr matrix_<int, 4, 4> a(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+                                 15, 16);
+  constexpr matrix_<int, 4, 4> identity(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0,
+                                        0, 1);
+  static_assert(a * identity == a);
+  constexpr matrix_<int, 4, 2> b(1, 0, 0, 1, 1, 0, 0, 1);
+  static_assert(a * b == matrix_<int, 4, 2>(4, 6, 12, 14, 20, 22, 28, 30));
+  constexpr matrix_<float, 2, 3> c(1.f, 2.f, 3.f, 4.f, 5.f, 6.f);
+  constexpr matrix_<float, 3, 2> d(7.f, 8.f, 9.f, 10.f, 11.f, 12.f);
+  const auto cd{c * d};
+  REQUIRE(cd == matrix_<float, 2, 2>(58.f, 64.f, 139.f, 154.f));
+}
+
+TEST_CASE("RUN-TIME MATRIX MULTIPLICATION") {
+  const matrix_<int, 2, 3> y(0, 3, 5, 5, 5, 2);
+  const matrix_<int, 3, 2> x(3, 4, 3, -2, 4, -2);
+  const auto actual = (y * x);
+
+  constexpr matrix_<int, 2, 2> expected(29, -16, 38, 6);
+  REQUIRE(expected == actual);
+}
+
+TEST_CASE("MATRIX-VECTOR AND HADAMARD PRODUCTS") {
+  // past the unrolled sizes, a column or a row operand goes through `gemv`
+  constexpr std::size_t m{9}, n{7};
+  matrix_<int, m, n> a{};
+  matrix_<int, m, n, kraken::layout::padded<>> pa{};
+  matrix_<int, n, 1> x{};
+  matrix_<int, n, 1, kraken::layout::padded<>> px{};
+  matrix_<int, 1, m> row{};
+  for (std::size_t i{}; i < m; ++i) {
+    row.at(0, i) = static_cast<int>(i) - 4;
+    for (std::size_t j{}; j < n; ++j) {
+      a.at(i, j) = static_cast<int>((i * 5 + j * 3) % 7) - 3;
+      pa.at(i, j) = a.at(i, j);
+    }
+  }
+  for (std::size_t j{}; j < n; ++j) {
+    x.at(j, 0) = static_cast<int>(j) + 1;
+    px.at(j, 0) = x.at(j, 0);
+  }
+  const auto ax{a * x};
+  const auto pax{pa * px};
+  const auto ra{row * a};
+  bool same{true};
+  for (std::size_t i{}; i < m; ++i) {
+    int sum{};
+    for (std::size_t j{}; j < n; ++j) {
+      sum += a.at(i, j) * x.at(j, 0);
+    }
+    same = same && ax.at(i, 0) == sum && pax.at(i, 0) == sum;
+  }
+  for (std::size_t j{}; j < n; ++j) {
+    int sum{};
+    for (std::size_t i{}; i < m; ++i) {
+      sum += row.at(0, i) * a.at(i, j);
+    }
+    same = same && ra.at(0, j) == sum;
+  }
+  REQUIRE(same);
+
+  constexpr matrix_<int, 2, 3> h(1, 2, 3, 4, 5, 6);
+  static_assert(h.hadamard(h) == matrix_<int, 2, 3>(1, 4, 9, 16, 25, 36));
+  REQUIRE(pa.hadamard(pa).at(8, 6) == a.at(8, 6) * a.at(8, 6));
+  // a row times a row keeps its old elementwise meaning
+  matrix_<int, 1, 3> r(1, 2, 3);
+  REQUIRE(r * r == matrix_<int, 1, 3>(1, 4, 9));
+  REQUIRE(r == matrix_<int, 1, 3>(1, 2, 3));
+}
+
+TEST_CASE("BLOCKED GEMM AGAINST NAIVE PRODUCT") {
+  // sizes cross every block boundary (MR, NR, MC, KC) and leave ragged edges
+  constexpr std::size_t m{101}, n{67}, k{300};
+  std::vector<double> a(m * k), b(k * n), c(m * n, 1.), expected(m * n);
+  for (std::size_t i{}; i < a.size(); ++i) {
+    a[i] = static_cast<double>((i * 7) % 13) - 6.;
+  }
+  for (std::size_t i{}; i < b.size(); ++i) {
+    b[i] = static_cast<double>((i * 5) % 11) - 5.;
+  }
+  for (std::size_t i{}; i < m; ++i) {
+    for (std::size_t j{}; j < n; ++j) {
+      double sum{};
+      for (std::size_t p{}; p < k; ++p) {
+        sum += a[(i * k) + p] * b[(p * n) + j];
+      }
+      expected[(i * n) + j] = (2. * sum) + 3.;
+    }
+  }
+  kraken::blas::gemm(m, n, k, 2., a.data(), k, b.data(), n, 3., c.data(), n);
+  REQUIRE(c == expected);
+
+  // `B` read as a column-major (transposed) operand
+  std::vector<double> bt(n * k), ct(m * n);
+  for (std::size_t p{}; p < k; ++p) {
+    for (std::size_t j{}; j < n; ++j) {
+      bt[(j * k) + p] = b[(p * n) + j];
+    }
+  }
+  kraken::blas::gemm(m, n, k, 2., a.data(), k, 1UL, bt.data(), 1UL, k, 0.,
+                     ct.data(), n, 1UL);
+  for (auto &&i : expected) {
+    i -= 3.;
+  }
+  REQUIRE(ct == expected);
+}
+
+namespace {
+template <class L, class R>
+concept addable = requires(const L &lhs, const R &rhs) { lhs + rhs; };
+} // namespace
+
+TEST_CASE("FUSED MATRIX EXPRESSIONS") {
+  constexpr matrix_<int, 2, 2> a(1, 2, 3, 4);
+  constexpr matrix_<int, 2, 2> b(5, 6, 7, 8);
+  constexpr matrix_<int, 2, 2> c(1, 1, 1, 1);
+
+  constexpr matrix_<int, 2, 2> actual = a + b - c + 2;
+  constexpr matrix_<int, 2, 2> expected(7, 9, 11, 13);
+  REQUIRE(expected == actual);
+
+  constexpr matrix_<int, 2, 2> scaled = 2 * (a - c) + -b;
+  REQUIRE(scaled == matrix_<int, 2, 2>(-5, -4, -3, -2));
+  REQUIRE(kraken::expr::eval(10 - a) == matrix_<int, 2, 2>(9, 8, 7, 6));
+
+  // products materialize the expression first
+  const matrix_<int, 2, 2> product = (a + c) * b;
+  REQUIRE(product == matrix_<int, 2, 2>(31, 36, 55, 64));
+
+  matrix_<int, 2, 2> acc(1, 1, 1, 1);
+  acc += a + b;
+  acc -= 3 * c;
+  REQUIRE(acc == matrix_<int, 2, 2>(4, 6, 8, 10));
+
+  // operands of another shape or element type do not combine
+  static_assert(!addable<matrix_<int, 2, 3>, matrix_<int, 3, 2>>);
+  static_assert(!addable<matrix_<int, 2, 3>, matrix_<double, 2, 3>>);
+  static_assert(!addable<decltype(a + b), matrix_<int, 2, 3>>);
+  static_assert(addable<matrix_<int, 2, 3, kraken::layout::padded<>>,
+                        matrix_<int, 2, 3>>);
+}
+
+TEST_CASE("PADDED MATRIX LAYOUT") {
+  using padded = kraken::layout::padded<>;
+  // rows start on a cache-line, a 4 KiB row gets one more line
+  static_assert(matrix_<float, 3, 5, padded>::LD == 16);
+  static_assert(matrix_<double, 3, 8, padded>::LD == 8);
+  static_assert(matrix_<float, 2, 1024, padded>::LD == 1040);
+  static_assert(matrix_<int, 2, 3, kraken::layout::padded<7>>::LD == 7);
+  // an explicit leading dimension does not carry over to the transpose
+  matrix_<float, 100, 3, kraken::layout::padded<4>> tall{};
+  tall.at(99, 2) = 5.f;
+  const auto wide{tall.transpose_triangular()};
+  static_assert(std::is_same_v<decltype(wide),
+                               const matrix_<float, 3, 100, padded>>);
+  REQUIRE(wide.at(2, 99) == 5.f);
+  static_assert(alignof(matrix_<float, 3, 5, padded>) == 64);
+
+  constexpr matrix_<int, 2, 3, padded> a(1, 2, 3, 4, 5, 6);
+  static_assert(a.at<1, 0>() == 4);
+  static_assert(a[5] == 6);
+  REQUIRE(reinterpret_cast<std::uintptr_t>(a.data()) % 64 == 0);
+  REQUIRE(a.data()[a.ld()] == 4);
+  REQUIRE(std::vector<int>(a.begin(), a.end()) ==
+          std::vector<int>{1, 2, 3, 4, 5, 6});
+
+  matrix_<int, 2, 3, padded> sorted(6, 5, 4, 3, 2, 1);
+  sorted.sort();
+  REQUIRE(sorted == matrix_<int, 2, 3, padded>(1, 2, 3, 4, 5, 6));
+  sorted.fill(7);
+  REQUIRE(sorted.data()[3] == 0); // the padding is never touched
+  REQUIRE(sorted.at(1, 2) == 7);
+
+  const matrix_<int, 2, 3, padded> sum = a + a - 1;
+  REQUIRE(sum == matrix_<int, 2, 3, padded>(1, 3, 5, 7, 9, 11));
+
+  // every kernel walks the rows through `ld()`
+  constexpr std::size_t n{37};
+  matrix_<double, n, n, padded> p{};
+  matrix_<double, n, n> q{};
+  for (std::size_t i{}; i < n; ++i) {
+    for (std::size_t j{}; j < n; ++j) {
+      p.at(i, j) = static_cast<double>((i * 3 + j * 7) % 11) - 5.;
+      q.at(i, j) = p.at(i, j);
+    }
+  }
+  const auto pp{p * p};
+  const auto qq{q * q};
+  const auto pt{p.transpose_triangular()};
+  bool same{true};
+  for (std::size_t i{}; i < n; ++i) {
+    for (std::size_t j{}; j < n; ++j) {
+      same = same && pp.at(i, j) == qq.at(i, j) && pt.at(j, i) == p.at(i, j);
+    }
+  }
+  REQUIRE(same);
+  p.transpose_squared();
+  REQUIRE(p.at(3, 1) == q.at(1, 3));
+  const auto scaled{p * 2.};
+  REQUIRE(scaled.at(36, 36) == 2. * q.at(36, 36));
+  REQUIRE(scaled.data()[n] == 0.);
+}
+
+TEST_CASE("COLUMN-MAJOR MATRIX LAYOUT") {
+  using col = kraken::layout::col_major<>;
+  using padded_col = kraken::layout::col_major<kraken::layout::padded<>>;
+  // the leading dimension runs down a column
+  static_assert(matrix_<float, 3, 5, col>::LD == 3);
+  static_assert(matrix_<float, 3, 5, col>::RS == 1);
+  static_assert(matrix_<float, 3, 5, col>::CS == 3);
+  static_assert(matrix_<float, 3, 5, padded_col>::LD == 16);
+  static_assert(alignof(matrix_<float, 3, 5, padded_col>) == 64);
+  static_assert(std::is_same_v<matrix_<float, 3, 5, col>::transpose_type,
+                               matrix_<float, 5, 3>>);
+
+  constexpr matrix_<int, 2, 3, col> a(1, 2, 3, 4, 5, 6);
+  static_assert(a.at<1, 0>() == 4);
+  static_assert(a[2] == 3);
+  // columns are back to back, iteration stays row by row
+  REQUIRE(std::vector<int>(a.data(), a.data() + 6) ==
+          std::vector<int>{1, 4, 2, 5, 3, 6});
+  REQUIRE(std::vector<int>(a.begin(), a.end()) ==
+          std::vector<int>{1, 2, 3, 4, 5, 6});
+  std::ostringstream printed;
+  printed << a;
+  std::ostringstream expected;
+  expected << matrix_<int, 2, 3>(1, 2, 3, 4, 5, 6);
+  REQUIRE(printed.str() == expected.str());
+
+  // the transpose in the other layout is the same buffer
+  const matrix_<int, 3, 2> at{a.transposed()};
+  REQUIRE(at == matrix_<int, 3, 2>(1, 4, 2, 5, 3, 6));
+  REQUIRE(at.transposed() == a);
+  REQUIRE(a.transpose_triangular() ==
+          matrix_<int, 3, 2, col>(1, 4, 2, 5, 3, 6));
+
+  const matrix_<int, 2, 3, col> sum = a + a - 1;
+  REQUIRE(sum == matrix_<int, 2, 3, col>(1, 3, 5, 7, 9, 11));
+  REQUIRE(a.hadamard(a) == matrix_<int, 2, 3, col>(1, 4, 9, 16, 25, 36));
+
+  const auto check = [](const auto &x, const auto &y) {
+    bool same{x.row() == y.row() && x.col() == y.col()};
+    for (std::size_t i{}; same && i < x.row(); ++i) {
+      for (std::size_t j{}; j < x.col(); ++j) {
+        same = same && x.at(i, j) == y.at(i, j);
+      }
+    }
+    return same;
+  };
+  const auto sample = [](auto &x, const std::size_t seed) {
+    for (std::size_t i{}; i < x.row(); ++i) {
+      for (std::size_t j{}; j < x.col(); ++j) {
+        x.at(i, j) = static_cast<double>((i * seed + j * 7) % 11) - 5.;
+      }
+    }
+  };
+
+  // every product is computed on the row-major kernels as `C^T = B^T A^T`
+  matrix_<double, 3, 3, col> s{};
+  matrix_<double, 3, 3> sr{};
+  sample(s, 3);
+  sample(sr, 3);
+  REQUIRE(check(s * s, sr * sr));
+  constexpr std::size_t n{37};
+  matrix_<double, n, n, padded_col> p{};
+  matrix_<double, n, 5, padded_col> b{};
+  matrix_<double, n, 1, padded_col> x{};
+  matrix_<double, 1, n, padded_col> y{};
+  matrix_<double, n, n> pr{};
+  matrix_<double, n, 5> br{};
+  matrix_<double, n, 1> xr{};
+  matrix_<double, 1, n> yr{};
+  sample(p, 3);
+  sample(b, 5);
+  sample(x, 2);
+  sample(y, 9);
+  sample(pr, 3);
+  sample(br, 5);
+  sample(xr, 2);
+  sample(yr, 9);
+  REQUIRE(check(p * p, pr * pr));
+  REQUIRE(check(p * b, pr * br));
+  REQUIRE(check(p.multiply(b, 2), pr.multiply(br, 2)));
+  REQUIRE(check(p * x, pr * xr));
+  REQUIRE(check(y * p, yr * pr));
+  REQUIRE(check(p * 2., pr * 2.));
+  REQUIRE(check(p.transpose_triangular(), pr.transpose_triangular()));
+  p.transpose_squared();
+  pr.transpose_squared();
+  REQUIRE(check(p, pr));
+}
+
+TEST_CASE("ROW AND COLUMN PERMUTATIONS") {
+  // every row (column) is swapped whole, also when the matrix is not square
+  matrix_<int, 2, 4> wide(1, 2, 3, 4, 5, 6, 7, 8);
+  wide.swap_rows(0, 1);
+  REQUIRE(wide == matrix_<int, 2, 4>(5, 6, 7, 8, 1, 2, 3, 4));
+  matrix_<int, 4, 2> tall(1, 2, 3, 4, 5, 6, 7, 8);
+  tall.swap_cols(0, 1);
+  REQUIRE(tall == matrix_<int, 4, 2>(2, 1, 4, 3, 6, 5, 8, 7));
+
+  constexpr matrix_<int, 3, 4> a(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12);
+  constexpr std::array<std::size_t, 3> rp{2, 0, 1};
+  constexpr std::array<std::size_t, 4> cp{3, 2, 0, 1};
+  static_assert(a.permuted_rows(rp).at<0, 0>() == 9);
+  static_assert(a.permuted_cols(cp).at<1, 0>() == 8);
+  REQUIRE(a.permuted_rows(rp) ==
+          matrix_<int, 3, 4>(9, 10, 11, 12, 1, 2, 3, 4, 5, 6, 7, 8));
+  REQUIRE(a.permuted_cols(cp) ==
+          matrix_<int, 3, 4>(4, 3, 1, 2, 8, 7, 5, 6, 12, 11, 9, 10));
+  auto b{a};
+  b.permute_rows(rp);
+  REQUIRE(b == a.permuted_rows(rp));
+  b = a;
+  b.permute_cols(cp);
+  REQUIRE(b == a.permuted_cols(cp));
+
+  // the padded and column-major buffers give the same matrices
+  using padded_col = kraken::layout::col_major<kraken::layout::padded<>>;
+  constexpr std::size_t n{37};
+  std::array<std::size_t, n> perm{};
+  for (std::size_t i{}; i < n; ++i) {
+    perm[i] = (i * 10UL) % n;
+  }
+  matrix_<double, n, n> r{};
+  matrix_<double, n, n, kraken::layout::padded<>> p{};
+  matrix_<double, n, n, padded_col> c{};
+  for (std::size_t i{}; i < n; ++i) {
+    for (std::size_t j{}; j < n; ++j) {
+      r.at(i, j) = static_cast<double>((i * n) + j);
+      p.at(i, j) = r.at(i, j);
+      c.at(i, j) = r.at(i, j);
+    }
+  }
+  const auto pr{p.permuted_rows(perm)};
+  const auto cc{c.permuted_cols(perm)};
+  r.permute_rows(perm);
+  p.permute_cols(perm);
+  c.permute_rows(perm);
+  bool same{true};
+  for (std::size_t i{}; i < n; ++i) {
+    for (std::size_t j{}; j < n; ++j) {
+      same = same && pr.at(i, j) == r.at(i, j) && c.at(i, j) == r.at(i, j) &&
+             p.at(i, j) == static_cast<double>((i * n) + perm[j]) &&
+             cc.at(i, j) == p.at(i, j);
+    }
+  }
+  REQUIRE(same);
+  REQUIRE(pr.data()[n] == 0.); // the padding stays zero
+}
+
+TEST_CASE("RADIX SORT AND SORT ROWS") {
+  // above 1024 elements integers and floats take the radix sort
+  constexpr std::size_t n{40};
+  matrix_<float, n, n> r{};
+  matrix_<float, n, n, kraken::layout::padded<>> p{};
+  for (std::size_t i{}; i < r.size(); ++i) {
+    r[i] = static_cast<float>((i * 7919UL) % 1009UL) - 504.f;
+    p[i] = r[i];
+  }
+  std::vector<float> expected(r.begin(), r.end());
+  std::sort(expected.begin(), expected.end(), std::greater<float>{});
+  r.sort(false);
+  p.sort(false, 2UL);
+  REQUIRE(std::vector<float>(r.begin(), r.end()) == expected);
+  REQUIRE(std::vector<float>(p.begin(), p.end()) == expected);
+  REQUIRE(p.data()[n] == 0.f); // the padding stays zero
+
+  matrix_<int, 5, 3> m(3, 1, 10, //
+                       1, 2, 11, //
+                       3, 0, 12, //
+                       1, 2, 13, //
+                       2, 5, 14);
+  using col = kraken::layout::col_major<>;
+  matrix_<int, 5, 3, col> c(3, 1, 10, 1, 2, 11, 3, 0, 12, 1, 2, 13, 2, 5, 14);
+  m.sort_rows({0, 1});
+  c.sort_rows({0, 1});
+  const matrix_<int, 5, 3> sorted(1, 2, 11, //
+                                  1, 2, 13, //
+                                  2, 5, 14, //
+                                  3, 0, 12, //
+                                  3, 1, 10);
+  REQUIRE(m == sorted);
+  REQUIRE(c.transposed() == sorted.transpose_triangular());
+  m.sort_rows({2}, false);
+  REQUIRE(m.at(0, 2) == 14);
+  REQUIRE(m.at(4, 2) == 10);
+}
+
+TEST_CASE("ROW AND COLUMN REDUCTIONS") {
+  using kraken::blas::reduction;
+  constexpr matrix_<double, 2, 3> a(1., 5., 3., 4., 2., 6.);
+  REQUIRE(a.reduce_rows(reduction::sum) == matrix_<double, 2, 1>(9., 12.));
+  REQUIRE(a.reduce_cols(reduction::sum) == matrix_<double, 1, 3>(5., 7., 9.));
+  REQUIRE(a.reduce_rows(reduction::min) == matrix_<double, 2, 1>(1., 2.));
+  REQUIRE(a.reduce_cols(reduction::max) == matrix_<double, 1, 3>(4., 5., 6.));
+  REQUIRE(a.reduce_rows(reduction::mean) == matrix_<double, 2, 1>(3., 4.));
+  REQUIRE(a.reduce_cols(reduction::mean) ==
+          matrix_<double, 1, 3>(2.5, 3.5, 4.5));
+
+  // the same results from the padded and column-major layouts
+  using padded_col = kraken::layout::col_major<kraken::layout::padded<>>;
+  constexpr std::size_t n{37};
+  matrix_<float, n, n + 3> r{};
+  matrix_<float, n, n + 3, kraken::layout::padded<>> p{};
+  matrix_<float, n, n + 3, padded_col> c{};
+  for (std::size_t i{}; i < r.size(); ++i) {
+    r[i] = static_cast<float>((i * 31UL) % 97UL) - 48.f;
+    p[i] = r[i];
+    c[i] = r[i];
+  }
+  bool same{true};
+  for (const auto op : {reduction::sum, reduction::min, reduction::max}) {
+    const auto rows{r.reduce_rows(op)};
+    const auto cols{r.reduce_cols(op, 2UL)};
+    const auto p_rows{p.reduce_rows(op, 2UL)};
+    const auto p_cols{p.reduce_cols(op)};
+    const auto c_rows{c.reduce_rows(op)};
+    const auto c_cols{c.reduce_cols(op, 0UL)};
+    for (std::size_t i{}; i < n; ++i) {
+      same = same && p_rows.at(i, 0) == rows.at(i, 0) &&
+             c_rows.at(i, 0) == rows.at(i, 0);
+    }
+    for (std::size_t j{}; j < n + 3; ++j) {
+      same = same && p_cols.at(0, j) == cols.at(0, j) &&
+             c_cols.at(0, j) == cols.at(0, j);
+    }
+  }
+  REQUIRE(same);
+}
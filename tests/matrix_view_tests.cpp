@@ -0,0 +1,143 @@
+#include "../source/library/core/matrix_view.hpp"
+#include "../Catch2/catch.hpp"
+#include "../source/library/core/numeric.hpp"
+#include "../source/library/core/numeric_methods.hpp"
+
+using Catch::Detail::Approx;
+
+TEST_CASE("MATRIX VIEW ROW-COL-BLOCK") {
+  dynamic_matrix_<int> mat(3, 4, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11});
+  const auto row{row_view(mat, 1)};
+  REQUIRE(row.row() == 1);
+  REQUIRE(row.col() == 4);
+  REQUIRE(row.data() == mat.data() + 4);
+  REQUIRE(row.at(0, 3) == 7);
+
+  const auto col{col_view(mat, 2)};
+  REQUIRE(col.row() == 3);
+  REQUIRE(col.at(2, 0) == 10);
+  REQUIRE(col.row_stride() == 4);
+
+  const auto block{block_view(mat, 1, 1, 2, 2)};
+  REQUIRE(block == matrix_view_<const int>(
+                       dynamic_matrix_<int>(2, 2, {5, 6, 9, 10}).data(), 2, 2,
+                       2));
+  block.at(1, 1) = 42; // writes through
+  REQUIRE(mat.at(2, 2) == 42);
+
+  const auto tr{transposed_view(mat)};
+  REQUIRE(tr.row() == 4);
+  REQUIRE(tr.col() == 3);
+  REQUIRE(tr.at(3, 1) == 7);
+  REQUIRE(tr.block(1, 0, 2, 3).col_view(2).at(1, 0) == 42);
+}
+
+TEST_CASE("MATRIX VIEW OF A PADDED MATRIX") {
+  matrix_<float, 3, 3, kraken::layout::padded<>> mat(1.f, 2.f, 3.f, 4.f, 5.f,
+                                                     6.f, 7.f, 8.f, 9.f);
+  const auto view{make_view(mat)};
+  REQUIRE(view.row_stride() == 16);
+  REQUIRE(col_view(mat, 1).at(2, 0) == 8.f);
+  REQUIRE(kraken::cal::acc(0.f, transposed_view(mat).row_view(2)) == 18.f);
+  const dynamic_matrix_<float> product{view * transposed_view(mat)};
+  REQUIRE(product.at(1, 2) == 122.f);
+}
+
+TEST_CASE("MATRIX VIEW OF A COLUMN-MAJOR MATRIX") {
+  matrix_<float, 2, 3, kraken::layout::col_major<>> mat(1.f, 2.f, 3.f, 4.f,
+                                                        5.f, 6.f);
+  const auto view{make_view(mat)};
+  REQUIRE(view.row_stride() == 1);
+  REQUIRE(view.col_stride() == 2);
+  REQUIRE(view.at(1, 2) == 6.f);
+  REQUIRE(row_view(mat, 1).at(0, 1) == 5.f);
+  REQUIRE(kraken::cal::acc(0.f, col_view(mat, 2)) == 9.f);
+}
+
+TEST_CASE("MATRIX VIEW ARITHMETIC") {
+  matrix_<int, 3, 3> mat(1, 2, 3, 4, 5, 6, 7, 8, 9);
+  const dynamic_matrix_<int> sum{row_view(mat, 0) + row_view(mat, 2) * 2};
+  REQUIRE(sum == dynamic_matrix_<int>(1, 3, {15, 18, 21}));
+
+  const matrix_<int, 3, 3> sym{make_view(mat) + transposed_view(mat)};
+  REQUIRE(sym == matrix_<int, 3, 3>(2, 6, 10, 6, 10, 14, 10, 14, 18));
+
+  row_view(mat, 1) = row_view(mat, 0); // copies elements, not the view
+  REQUIRE(mat == matrix_<int, 3, 3>(1, 2, 3, 1, 2, 3, 7, 8, 9));
+  col_view(mat, 0) += col_view(mat, 2);
+  REQUIRE(mat == matrix_<int, 3, 3>(4, 2, 3, 4, 2, 3, 16, 8, 9));
+  block_view(mat, 0, 0, 2, 2) *= -1;
+  REQUIRE(mat == matrix_<int, 3, 3>(-4, -2, 3, -4, -2, 3, 16, 8, 9));
+}
+
+TEST_CASE("ASSIGNING A VIEW OF A DYNAMIC MATRIX TO ITSELF") {
+  // a new shape is evaluated before the old buffer is freed
+  dynamic_matrix_<int> m(3, 3, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+  m = block_view(m, 1, 1, 2, 2);
+  REQUIRE(m == dynamic_matrix_<int>(2, 2, {5, 6, 8, 9}));
+  dynamic_matrix_<int> wide(2, 3, {1, 2, 3, 4, 5, 6});
+  wide = transposed_view(wide);
+  REQUIRE(wide == dynamic_matrix_<int>(3, 2, {1, 4, 2, 5, 3, 6}));
+}
+
+TEST_CASE("ASSIGNING AN EXPRESSION THAT READS ITS DESTINATION") {
+  // the transpose of a square matrix into itself
+  dynamic_matrix_<int> a(3, 3, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+  a = transposed_view(a);
+  REQUIRE(a == dynamic_matrix_<int>(3, 3, {1, 4, 7, 2, 5, 8, 3, 6, 9}));
+  matrix_<int, 2, 2> fixed(1, 2, 3, 4);
+  fixed = transposed_view(fixed) + 10;
+  REQUIRE(fixed == matrix_<int, 2, 2>(11, 13, 12, 14));
+
+  // a block shifted against the block it is added to
+  dynamic_matrix_<int> b(3, 3, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+  block_view(b, 1, 1, 2, 2) += block_view(b, 0, 0, 2, 2);
+  REQUIRE(b == dynamic_matrix_<int>(3, 3, {1, 2, 3, 4, 6, 8, 7, 12, 14}));
+  auto row{row_view(b, 0)};
+  row = 2 * block_view(b, 0, 0, 1, 3) + block_view(b, 0, 0, 1, 3);
+  REQUIRE(b == dynamic_matrix_<int>(3, 3, {3, 6, 9, 4, 6, 8, 7, 12, 14}));
+
+  // each element read where it is written is not aliasing
+  REQUIRE(!kraken::expr::aliases(a, a + a));
+  REQUIRE(kraken::expr::aliases(a, transposed_view(a)));
+  REQUIRE(!kraken::expr::aliases(row_view(a, 0), row_view(a, 1)));
+}
+
+TEST_CASE("MATRIX VIEW PRODUCTS") {
+  const dynamic_matrix_<double> a(3, 3, {1., 2., 3., 4., 5., 6., 7., 8., 9.});
+  // a^T * a without materializing a^T
+  const auto ata{transposed_view(a) * a};
+  REQUIRE(ata == dynamic_matrix_<double>(
+                     3, 3, {66., 78., 90., 78., 93., 108., 90., 108., 126.}));
+  // a row times a column
+  const auto dot{row_view(a, 0) * col_view(a, 2)};
+  REQUIRE(dot.size() == 1);
+  REQUIRE(dot.at(0, 0) == 42.);
+  const auto block{block_view(a, 1, 1, 2, 2) * block_view(a, 0, 0, 2, 2)};
+  REQUIRE(block == dynamic_matrix_<double>(2, 2, {29., 40., 44., 61.}));
+}
+
+TEST_CASE("MATRIX VIEW REDUCTIONS AND SOLVERS") {
+  dynamic_matrix_<double> mat(3, 4, {1., 2., 3., 4., 5., 6., 7., 8., 9., 10.,
+                                     11., 12.});
+  REQUIRE(kraken::cal::acc(0., col_view(mat, 1)) == 18.);
+  REQUIRE(kraken::cal::acc(0., block_view(mat, 1, 2, 2, 2)) == 38.);
+
+  // a square block of a bigger matrix, the matrix itself is not copied
+  dynamic_matrix_<double> big(4, 4, {2., -3., 1., 0., 2., 2., -1., 0., 4., -1.,
+                                     -2., 0., 0., 0., 0., 1.});
+  constexpr matrix_<double, 3, 3> small(2., -3., 1., 2., 2., -1., 4., -1., -2.);
+  REQUIRE(kraken::num_methods::determined(block_view(big, 0, 0, 3, 3)) ==
+          Approx(kraken::num_methods::determined(small)));
+  REQUIRE(big.at(1, 0) == 2.); // left untouched
+
+  // augmented system [A | b] living inside a larger buffer
+  dynamic_matrix_<double> system(3, 5, {2., 1., -1., 8., 0., -3., -1., 2.,
+                                        -11., 0., -2., 1., 2., -3., 0.});
+  const auto augmented{block_view(system, 0, 0, 3, 4)};
+  kraken::num_methods::gauss_elimination(augmented);
+  const auto x{kraken::num_methods::back_substitution(augmented)};
+  REQUIRE(x.at(0, 0) == Approx(2.));
+  REQUIRE(x.at(0, 1) == Approx(3.));
+  REQUIRE(x.at(0, 2) == Approx(-1.));
+}
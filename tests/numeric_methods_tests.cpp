@@ -2,6 +2,8 @@
 #include "../source/library/core/matrix.hpp"
 #include "../source/library/core/numeric_methods.hpp"
 
+using Catch::Detail::Approx;
+
 TEST_CASE("CHECK GAUSS-ELIMINATION AND DETERMINED") {
   constexpr matrix_<float, 3, 3> matrix(1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f,
                                         9.f);
@@ -14,6 +16,54 @@ TEST_CASE("CHECK GAUSS-ELIMINATION AND DETERMINED") {
   REQUIRE(deter == 0.f);
 }
 
+TEST_CASE("DETERMINED AND INVERSE OF A COLUMN-MAJOR MATRIX") {
+  using col = kraken::layout::col_major<>;
+  const matrix_<double, 3, 3, col> small(2., 1., 0., 1., 3., 1., 0., 1., 4.);
+  const matrix_<double, 3, 3> small_r(2., 1., 0., 1., 3., 1., 0., 1., 4.);
+  REQUIRE(kraken::num_methods::determined(small) ==
+          Approx(kraken::num_methods::determined(small_r)));
+  const auto inv{kraken::num_methods::inverse(small)};
+  const auto inv_r{kraken::num_methods::inverse(small_r)};
+  matrix_<double, 6, 6, col> big{};
+  matrix_<double, 6, 6> big_r{};
+  for (std::size_t i{}; i < 6; ++i) {
+    for (std::size_t j{}; j < 6; ++j) {
+      big.at(i, j) = (i == j ? 8. : 0.) + static_cast<double>((i + 2 * j) % 3);
+      big_r.at(i, j) = big.at(i, j);
+    }
+  }
+  REQUIRE(kraken::num_methods::determined(big) ==
+          Approx(kraken::num_methods::determined(big_r)));
+  const auto big_inv{kraken::num_methods::inverse(big)};
+  const auto big_inv_r{kraken::num_methods::inverse(big_r)};
+  bool same{true};
+  for (std::size_t i{}; i < 3; ++i) {
+    for (std::size_t j{}; j < 3; ++j) {
+      same = same && inv.at(i, j) == Approx(inv_r.at(i, j));
+    }
+  }
+  for (std::size_t i{}; i < 6; ++i) {
+    for (std::size_t j{}; j < 6; ++j) {
+      same = same && big_inv.at(i, j) == Approx(big_inv_r.at(i, j));
+    }
+  }
+  REQUIRE(same);
+
+  // the solvers take what the elimination gives back, in any layout
+  const matrix_<double, 3, 4, col> system(2., 1., -1., 8., -3., -1., 2., -11.,
+                                          -2., 1., 2., -3.);
+  const auto x{kraken::num_methods::back_substitution(
+      kraken::num_methods::gauss_elimination(system))};
+  REQUIRE(x.at(0, 0) == Approx(2.));
+  REQUIRE(x.at(0, 1) == Approx(3.));
+  REQUIRE(x.at(0, 2) == Approx(-1.));
+  const matrix_<float, 3, 3, kraken::layout::padded<>> mat(
+      3.f, -1.f, 2.f, 1.f, 2.f, 3.f, 2.f, -2.f, -1.f);
+  const matrix_<float, 1, 3, col> right_side(12.f, 11.f, 2.f);
+  REQUIRE(kraken::num_methods::cramer(mat, right_side) ==
+          matrix_<float, 1, 3>(3.f, 1.f, 2.f));
+}
+
 TEST_CASE("CHECK LEAST-SQUARES") {
   constexpr matrix_<float, 1, 8> xi(0.f, 1.f, 1.f, 2.f, 3.f, 4.f, 2.f, 5.f);
   constexpr matrix_<float, 1, 8> yi(3.f, 4.f, 6.f, 9.f, 11.f, 15.f, 10.f, 16.f);
@@ -26,8 +76,8 @@ TEST_CASE("CRAMER'S RULE") {
   matrix_<float, 3, 3> mat(3.f, -1.f, 2.f, 1.f, 2.f, 3.f, 2.f, -2.f, -1.f);
   constexpr matrix_<float, 1, 3> right_side(12.f, 11.f, 2.f);
   const auto actual = kraken::num_methods::cramer(mat, right_side);
-  constexpr matrix_<float, 1, 3> expected(2.99999928474f, 1.00000023842f,
-                                          1.99999976158f);
+  // the 3x3 determinants are closed-form, so the result is exact
+  constexpr matrix_<float, 1, 3> expected(3.f, 1.f, 2.f);
   REQUIRE(expected == actual);
 }
 
@@ -62,3 +112,44 @@ TEST_CASE("Lagrange Interpolation") {
   constexpr auto expected{-18.f};
   REQUIRE(expected == actual);
 }
+
+TEST_CASE("CLOSED-FORM DETERMINED AND INVERSE") {
+  static_assert(kraken::num_methods::determined(matrix_<int, 1, 1>{-7}) == -7);
+  static_assert(kraken::num_methods::determined(matrix_<int, 2, 2>(3, 8, 4, 6)) ==
+                -14);
+  static_assert(kraken::num_methods::determined(
+                    matrix_<int, 3, 3>(6, 1, 1, 4, -2, 5, 2, 8, 7)) == -306);
+  // a zero pivot in the top-left corner, elimination without pivoting skips it
+  static_assert(kraken::num_methods::determined(matrix_<int, 4, 4>(
+                    0, 1, 2, 3, 1, 0, 4, 1, 2, 3, 0, 1, 1, 1, 1, 0)) == -6);
+
+  constexpr matrix_<double, 2, 2> two(1., 2., 3., 4.);
+  constexpr auto two_inv{kraken::num_methods::inverse(two)};
+  static_assert(two_inv == matrix_<double, 2, 2>(-2., 1., 1.5, -0.5));
+
+  const auto identity_of = [](const auto &mat) {
+    const auto product{mat * kraken::num_methods::inverse(mat)};
+    bool ok{true};
+    for (std::size_t i{}; i < mat.row(); ++i) {
+      for (std::size_t j{}; j < mat.col(); ++j) {
+        const double expected{i == j ? 1. : 0.};
+        ok = ok && product.at(i, j) > expected - 1e-12 &&
+             product.at(i, j) < expected + 1e-12;
+      }
+    }
+    return ok;
+  };
+  REQUIRE(identity_of(matrix_<double, 3, 3>(2., -1., 0., -1., 2., -1., 0., -1.,
+                                            2.)));
+  REQUIRE(identity_of(matrix_<double, 4, 4>(0., 1., 2., 3., 1., 0., 4., 1., 2.,
+                                            3., 0., 1., 1., 1., 1., 0.)));
+  // above 4x4 gauss-jordan with partial pivoting takes over
+  matrix_<double, 6, 6> big{};
+  for (std::size_t i{}; i < 6; ++i) {
+    for (std::size_t j{}; j < 6; ++j) {
+      big.at(i, j) = i == j ? 4. : 1. / static_cast<double>(i + j + 1);
+    }
+  }
+  big.at(0, 0) = 0.;
+  REQUIRE(identity_of(big));
+}
@@ -0,0 +1,64 @@
+#include "../source/library/core/out_of_core.hpp"
+#include "../Catch2/catch.hpp"
+#include "test_helpers.hpp"
+
+using Catch::Detail::Approx;
+
+TEST_CASE("OUT OF CORE TILING FITS THE BUDGET") {
+  for (const std::size_t budget : {64UL, 1000UL, 1UL << 16U, 1UL << 26U}) {
+    const auto tiles{kraken::blas::ooc_tiling<double>(5000, 3000, 7000,
+                                                      budget)};
+    REQUIRE(tiles.mt >= 1);
+    REQUIRE(tiles.nt >= 1);
+    REQUIRE(tiles.kt >= 1);
+    REQUIRE(tiles.elements() * sizeof(double) <= std::max(budget, 40UL));
+  }
+  // a thin product spends the room on the long side
+  const auto thin{kraken::blas::ooc_tiling<float>(4, 100000, 64, 1UL << 20U)};
+  REQUIRE(thin.mt == 4);
+  REQUIRE(thin.kt == 64);
+  REQUIRE(thin.nt > 1000);
+  REQUIRE(thin.elements() * sizeof(float) <= (1UL << 20U));
+  // everything fits: one tile of each
+  const auto whole{kraken::blas::ooc_tiling<float>(30, 40, 50, 1UL << 20U)};
+  REQUIRE(whole.mt == 30);
+  REQUIRE(whole.nt == 40);
+  REQUIRE(whole.kt == 50);
+}
+
+TEST_CASE("OUT OF CORE GEMM") {
+  const temp_file file_a{"kraken_ooc_a.bin"};
+  const temp_file file_b{"kraken_ooc_b.bin"};
+  const temp_file file_c{"kraken_ooc_c.bin"};
+  const auto a{sample(37, 29, 5)};
+  const auto b{sample(29, 41, 7)};
+  const auto expected{a * b};
+  (void)mapped_matrix_<double>::create(file_a.path.c_str(), a);
+  (void)mapped_matrix_<double>::create(file_b.path.c_str(), b);
+  const mapped_matrix_<double> in_a(file_a.path.c_str(), 37, 29);
+  const mapped_matrix_<double> in_b(file_b.path.c_str(), 29, 41);
+
+  // budgets from a few elements (ragged tiles in every direction) to all of
+  // it in one tile
+  for (const std::size_t budget : {40UL, 700UL, 5000UL, 1UL << 20U}) {
+    auto c{kraken::blas::out_of_core_gemm(file_c.path.c_str(), in_a, in_b,
+                                          budget)};
+    REQUIRE(c.is_open());
+    REQUIRE(c.to_dense() == expected);
+  }
+  // the product is on disk
+  const mapped_matrix_<double> stored(file_c.path.c_str(), 37, 41);
+  REQUIRE(stored.to_dense() == expected);
+
+  // `C = alpha * A * B + beta * C` on an existing file, with threads
+  mapped_matrix_<double> c(file_c.path.c_str(), 37, 41,
+                           kraken::mapping::read_write);
+  REQUIRE(kraken::blas::out_of_core_gemm(2., in_a, in_b, -1., c, 3000, 0));
+  REQUIRE(c.to_dense() == expected);
+  // an empty inner dimension only scales `C`
+  const mapped_matrix_<double> no_a(file_a.path.c_str(), 37, 0);
+  const mapped_matrix_<double> no_b(file_b.path.c_str(), 0, 41);
+  REQUIRE(kraken::blas::out_of_core_gemm(1., no_a, no_b, 0.5, c, 3000));
+  REQUIRE(c.at(36, 40) == Approx(expected.at(36, 40) * 0.5));
+  REQUIRE(c.at(0, 0) == Approx(expected.at(0, 0) * 0.5));
+}
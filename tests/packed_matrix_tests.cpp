@@ -0,0 +1,92 @@
+#include "../source/library/core/packed_matrix.hpp"
+#include "../Catch2/catch.hpp"
+#include "../source/library/core/numeric_methods.hpp"
+
+using Catch::Detail::Approx;
+
+TEST_CASE("PACKED MATRIX STORAGE AND CONVERSION") {
+  const dynamic_matrix_<int> dense(3, 3, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+
+  const upper_matrix_<int> up(dense);
+  REQUIRE(up.size() == 6);
+  REQUIRE(up == upper_matrix_<int>(3, {1, 2, 3, 5, 6, 9}));
+  REQUIRE(up.at(1, 2) == 6);
+  REQUIRE(up.at(2, 1) == 0);
+  REQUIRE(up.to_dense() ==
+          dynamic_matrix_<int>(3, 3, {1, 2, 3, 0, 5, 6, 0, 0, 9}));
+
+  const lower_matrix_<int> low(dense);
+  REQUIRE(low == lower_matrix_<int>(3, {1, 4, 5, 7, 8, 9}));
+  REQUIRE(low.at(0, 2) == 0);
+  REQUIRE(up.transpose() == lower_matrix_<int>(3, {1, 2, 5, 3, 6, 9}));
+  REQUIRE(low.transpose().transpose() == low);
+
+  symmetric_matrix_<int> sym(dense);
+  REQUIRE(sym.at(2, 0) == 3);
+  sym.at(2, 1) = -1; // one element, seen from both sides
+  REQUIRE(sym.at(1, 2) == -1);
+  REQUIRE((sym.to_matrix<3>() ==
+           matrix_<int, 3, 3>{1, 2, 3, 2, 5, -1, 3, -1, 9}));
+  REQUIRE(symmetric_matrix_<int>(sym.to_dense()) == sym);
+
+  // a moved-from matrix is empty and still usable
+  upper_matrix_<double> u(4);
+  auto v{std::move(u)};
+  REQUIRE(v.row() == 4);
+  REQUIRE(u.row() == 0);
+  REQUIRE(u.to_dense().empty());
+  u = std::move(v);
+  REQUIRE(u.size() == 10);
+  REQUIRE(v.to_dense().empty());
+}
+
+TEST_CASE("PACKED MATRIX MULTIPLY AND SOLVE") {
+  constexpr std::size_t n{37}; // not a multiple of any vector width
+  dynamic_matrix_<double> dense(n, n);
+  for (std::size_t i{}; i < n; ++i) {
+    for (std::size_t j{}; j < n; ++j) {
+      dense.at(i, j) = static_cast<double>((i * 3 + j * 5) % 7) + 1.;
+    }
+    dense.at(i, i) = 40.;
+  }
+  dynamic_matrix_<double> x(n, 2);
+  for (std::size_t i{}; i < x.size(); ++i) {
+    x[i] = static_cast<double>(i % 5) - 2.;
+  }
+
+  const upper_matrix_<double> up(dense);
+  const lower_matrix_<double> low(dense);
+  const symmetric_matrix_<double> sym(dense);
+  const auto check = [&](const auto &packed) {
+    const auto y{packed * x};
+    const auto expected{packed.to_dense() * x};
+    bool same{y.row() == n && y.col() == 2};
+    for (std::size_t i{}; i < y.size(); ++i) {
+      same = same && y[i] == Approx(expected[i]);
+    }
+    return same;
+  };
+  REQUIRE(check(up));
+  REQUIRE(check(low));
+  REQUIRE(check(sym));
+
+  // solving undoes the product, a column view works as the right-hand side
+  const auto b{up * x};
+  const auto solved{up.solve(b)};
+  const auto b_low{low * x};
+  const auto solved_low{low.solve(col_view(b_low, 1))};
+  bool same{true};
+  for (std::size_t i{}; i < n; ++i) {
+    same = same && solved.at(i, 0) == Approx(x.at(i, 0)) &&
+           solved.at(i, 1) == Approx(x.at(i, 1)) &&
+           solved_low.at(i, 0) == Approx(x.at(i, 1));
+  }
+  REQUIRE(same);
+
+  // the triangle left by gauss_elimination
+  const matrix_<double, 3, 3> mat{2., 1., -1., -3., -1., 2., -2., 1., 2.};
+  const upper_matrix_<double> u(kraken::num_methods::gauss_elimination(mat));
+  REQUIRE(u.at(2, 0) == 0.);
+  REQUIRE(u.solve(u * block_view(x, 0, 0, 3, 1)).at(2, 0) ==
+          Approx(x.at(2, 0)));
+}
@@ -0,0 +1,89 @@
+#include "../source/library/core/sparse_matrix.hpp"
+#include "../Catch2/catch.hpp"
+#include <vector>
+
+using Catch::Detail::Approx;
+
+TEST_CASE("SPARSE MATRIX FROM TRIPLETS") {
+  // out of order, with a duplicate at (1, 2)
+  const std::vector<kraken::sparse::triplet<int>> triplets{
+      {2, 0, 5}, {0, 1, 1}, {1, 2, 3}, {0, 3, 2}, {1, 2, 4}, {2, 3, 6}};
+  const sparse_matrix_<int> csr(3, 4, triplets);
+  REQUIRE(csr.row() == 3);
+  REQUIRE(csr.col() == 4);
+  REQUIRE(csr.nonzeros() == 5);
+  REQUIRE(std::vector(csr.offsets().begin(), csr.offsets().end()) ==
+          std::vector<std::size_t>{0, 2, 3, 5});
+  REQUIRE(std::vector(csr.indices().begin(), csr.indices().end()) ==
+          std::vector<std::size_t>{1, 3, 2, 0, 3});
+  REQUIRE(csr.at(1, 2) == 7);
+  REQUIRE(csr.at(1, 1) == 0);
+
+  const dynamic_matrix_<int> dense(3, 4, {0, 1, 0, 2, 0, 0, 7, 0, 5, 0, 0, 6});
+  REQUIRE(csr.to_dense() == dense);
+  REQUIRE(sparse_matrix_<int>(dense) == csr);
+
+  const sparse_matrix_<int, kraken::sparse::csc> csc(3, 4, triplets);
+  REQUIRE(std::vector(csc.offsets().begin(), csc.offsets().end()) ==
+          std::vector<std::size_t>{0, 1, 2, 3, 5});
+  REQUIRE(csc.to_dense() == dense);
+  REQUIRE(sparse_matrix_<int, kraken::sparse::csc>(csr) == csc);
+  REQUIRE(sparse_matrix_<int>(csc) == csr);
+
+  const auto tr{csr.transpose()};
+  REQUIRE(tr.row() == 4);
+  REQUIRE(tr.at(3, 2) == 6);
+
+  constexpr matrix_<int, 2, 3> fixed{0, 9, 0, 0, 0, 8};
+  const sparse_matrix_<int> from_fixed(fixed);
+  REQUIRE(from_fixed.nonzeros() == 2);
+  REQUIRE((from_fixed.to_matrix<2, 3>() == fixed));
+}
+
+TEST_CASE("SPARSE MATRIX VECTOR PRODUCT") {
+  // a tridiagonal system large enough to take the threaded path
+  constexpr std::size_t n{40'000};
+  std::vector<kraken::sparse::triplet<double>> triplets{};
+  for (std::size_t i{}; i < n; ++i) {
+    triplets.push_back({i, i, 4.});
+    if (i > 0) {
+      triplets.push_back({i, i - 1, -1.});
+    }
+    if (i + 1 < n) {
+      triplets.push_back({i, i + 1, -2.});
+    }
+  }
+  const sparse_matrix_<double> a(n, n, triplets);
+  const sparse_matrix_<double, kraken::sparse::csc> b(a);
+  dynamic_matrix_<double> x(n, 1);
+  for (std::size_t i{}; i < n; ++i) {
+    x[i] = static_cast<double>(i % 7);
+  }
+  const auto expected = [&](const std::size_t i) {
+    return (4. * x[i]) - (i > 0 ? x[i - 1] : 0.) -
+           (i + 1 < n ? 2. * x[i + 1] : 0.);
+  };
+
+  const auto y{a.multiply(x, 0)};
+  const auto y1{a * x};
+  const auto y2{b * x};
+  REQUIRE(y.row() == n);
+  bool same{true};
+  for (std::size_t i{}; i < n; ++i) {
+    same = same && y[i] == Approx(expected(i));
+  }
+  REQUIRE(same);
+  REQUIRE(y == y1);
+  REQUIRE(y == y2);
+
+  // alpha / beta and strided vectors
+  dynamic_matrix_<float> m(2, 6, {1, 0, 2, 0, 3, 0, 0, 4, 0, 0, 0, 5});
+  const sparse_matrix_<float> s(m);
+  dynamic_matrix_<float> xs(6, 2, 1.f); // a column of `xs` is strided
+  dynamic_matrix_<float> ys(2, 1, {1.f, 1.f});
+  xs.at(5, 0) = 2.f;
+  s.spmv(2.f, xs.data(), 2, 3.f, ys.data(), 1);
+  REQUIRE(ys[0] == 2.f * 6.f + 3.f);
+  REQUIRE(ys[1] == 2.f * 14.f + 3.f);
+  REQUIRE(s.multiply(col_view(xs, 0)).at(1, 0) == 14.f);
+}
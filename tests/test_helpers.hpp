@@ -0,0 +1,30 @@
+#ifndef TEST_HELPERS_HPP
+#define TEST_HELPERS_HPP
+
+#include "../source/library/core/dynamic_matrix.hpp"
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+/// @brief a file in the temporary directory, removed at the end of the test
+struct temp_file {
+  std::string path;
+  explicit temp_file(const char *name)
+      : path{(std::filesystem::temp_directory_path() / name).string()} {}
+  temp_file(const temp_file &) = delete;
+  auto operator=(const temp_file &) -> temp_file & = delete;
+  ~temp_file() { std::filesystem::remove(path); }
+};
+
+/// @brief a `row x col` matrix of small, exactly representable values
+template <class Ty = double>
+auto sample(const std::size_t row, const std::size_t col, const int seed)
+    -> dynamic_matrix_<Ty> {
+  dynamic_matrix_<Ty> out(row, col);
+  for (std::size_t i{}; i < row * col; ++i) {
+    out.data()[i] = static_cast<Ty>((static_cast<int>(i) * seed + 1) % 13 - 6);
+  }
+  return out;
+}
+
+#endif // TEST_HELPERS_HPP
@@ -0,0 +1,101 @@
+#include "../source/library/core/tiled_matrix.hpp"
+#include "../Catch2/catch.hpp"
+#include "../source/library/core/matrix.hpp"
+#include "test_helpers.hpp"
+
+using Catch::Detail::Approx;
+
+TEST_CASE("TILED MORTON ORDER") {
+  REQUIRE(kraken::tiled::morton_key(0, 0) == 0);
+  REQUIRE(kraken::tiled::morton_key(0, 1) == 1);
+  REQUIRE(kraken::tiled::morton_key(1, 0) == 2);
+  REQUIRE(kraken::tiled::morton_key(1, 1) == 3);
+  REQUIRE(kraken::tiled::morton_key(2, 3) == 0b1101);
+  // a 3 x 3 grid along the curve of the 4 x 4 one, no room lost
+  const auto offsets{kraken::tiled::tile_offsets<kraken::tiled::morton>(3, 3)};
+  const std::vector<std::size_t> expected{0, 1, 4, 2, 3, 5, 6, 7, 8};
+  REQUIRE(offsets == expected);
+  const auto rows{kraken::tiled::tile_offsets<kraken::tiled::rows>(2, 3)};
+  REQUIRE(rows == std::vector<std::size_t>{0, 1, 2, 3, 4, 5});
+}
+
+TEST_CASE("TILED MATRIX ACCESS") {
+  const auto dense{sample(70, 45, 7)};
+  const tiled_matrix_<double> tiled(dense);
+  REQUIRE(tiled.row() == 70);
+  REQUIRE(tiled.col() == 45);
+  REQUIRE(tiled.tile_row() == 3);
+  REQUIRE(tiled.tile_col() == 2);
+  REQUIRE(tiled.to_dense() == dense);
+  bool same{true};
+  for (std::size_t i{}; i < 70; ++i) {
+    for (std::size_t j{}; j < 45; ++j) {
+      same = same && tiled.at(i, j) == dense.at(i, j);
+    }
+  }
+  REQUIRE(same);
+  // an edge tile is cut to the matrix, its rows are a tile apart
+  const auto corner{tiled.tile(2, 1)};
+  REQUIRE(corner.row() == 6);
+  REQUIRE(corner.col() == 13);
+  REQUIRE(corner.row_stride() == 32);
+  REQUIRE(corner.at(5, 12) == dense.at(69, 44));
+  // tiles go to the kernels as plain views
+  REQUIRE(kraken::blas::asum(tiled.tile(1, 0)) ==
+          kraken::blas::asum(block_view(dense, 32, 0, 32, 32)));
+
+  tiled_matrix_<int, kraken::tiled::rows, 4> small(5, 6);
+  small.at(4, 5) = 3;
+  small.fill(2);
+  REQUIRE(small.at(4, 5) == 2);
+  REQUIRE(small.to_dense() == dynamic_matrix_<int>(5, 6, 2));
+
+  // a moved-from matrix is empty and still usable
+  auto moved{std::move(small)};
+  REQUIRE(moved.at(4, 5) == 2);
+  REQUIRE(small.empty());
+  REQUIRE(small.tile_row() == 0);
+  small.fill(1);
+  small = std::move(moved);
+  REQUIRE(small.at(4, 5) == 2);
+  REQUIRE(moved.empty());
+  moved.fill(1);
+}
+
+TEST_CASE("TILED MATRIX SWAPS AND TRANSPOSE") {
+  auto dense{sample(50, 37, 5)};
+  tiled_matrix_<double, kraken::tiled::morton, 8> tiled(dense);
+  tiled.swap_rows(3, 48);
+  tiled.swap_cols(0, 36);
+  dense.swap_rows(3, 48);
+  dense.swap_cols(0, 36);
+  REQUIRE(tiled.to_dense() == dense);
+
+  const auto flipped{tiled.transpose()};
+  REQUIRE(flipped.row() == 37);
+  REQUIRE(flipped.col() == 50);
+  REQUIRE(flipped.to_dense() == dense.transpose_triangular());
+  REQUIRE(flipped.transpose() == tiled);
+}
+
+TEST_CASE("TILED MATRIX PRODUCT") {
+  const auto a{sample(45, 70, 3)};
+  const auto b{sample(70, 33, 11)};
+  const auto expected{a * b};
+  const tiled_matrix_<double> ta(a);
+  const tiled_matrix_<double> tb(b);
+  REQUIRE((ta * tb).to_dense() == expected);
+  REQUIRE(ta.multiply(tb, 0).to_dense() == expected);
+  using small_tiles = tiled_matrix_<float, kraken::tiled::rows, 16>;
+  const small_tiles fa(sample<float>(20, 20, 3));
+  const small_tiles fb(sample<float>(20, 20, 5));
+  const auto product{(fa * fb).to_dense()};
+  const auto check{sample<float>(20, 20, 3) * sample<float>(20, 20, 5)};
+  bool same{true};
+  for (std::size_t i{}; i < 20; ++i) {
+    for (std::size_t j{}; j < 20; ++j) {
+      same = same && product.at(i, j) == Approx(check.at(i, j));
+    }
+  }
+  REQUIRE(same);
+}